@@ -0,0 +1,225 @@
+# load_test.py
+# -------------------------------------------------------------
+#   Load generator for the bridge: starts mock_tsw.py and
+#   tsw_bridge.py, simulates N panels sending over UDP and
+#   reports throughput, coalescing, latency and whether the
+#   mock ends up with the last value of every controller.
+#
+#   python3 load_test.py [--panels 24] [--controllers 12] [--rate 50]
+#                        [--seconds 10] [--delay-ms 2]
+#                        [--pool 2] [--tsw-rate 500] [--direct]
+#
+#   --direct lets every panel call the mock itself over its own
+#   keep-alive connection, as panels without the bridge do, for
+#   comparison.
+# -------------------------------------------------------------
+
+import argparse
+import json
+import os
+import random
+import select
+import socket
+import subprocess
+import sys
+import threading
+import time
+import urllib.request
+
+import tsw_wire as wire
+from tsw_bridge import LatencyStats, TswClient
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def free_port(kind=socket.SOCK_STREAM):
+    with socket.socket(socket.AF_INET, kind) as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def wait_for_port(port, timeout=5.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=0.2).close()
+            return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+class Panel(threading.Thread):
+    """One simulated panel: random controller changes at a fixed rate."""
+
+    def __init__(self, index, args, target):
+        super().__init__(daemon=True)
+        self.names = ["Panel%02d.Control%02d" % (index, i) for i in range(args.controllers)]
+        self.args = args
+        self.target = target  # (host, port) of the bridge, or a TswClient with --direct
+        self.values = {}
+        self.sent = 0
+        self.acked = 0
+        self.rtt = LatencyStats()
+
+    def run(self):
+        start = time.perf_counter()
+        deadline = start + self.args.seconds
+        interval = 1.0 / self.args.rate
+        next_send = start + random.uniform(0, interval)  # panels do not start in lockstep
+        if isinstance(self.target, TswClient):
+            self.run_direct(next_send, interval, deadline)
+        else:
+            self.run_bridge(start, next_send, interval, deadline)
+
+    def change(self):
+        name = random.choice(self.names)
+        self.values[name] = round(random.uniform(-1, 1), 3)
+        return name
+
+    def run_direct(self, next_send, interval, deadline):
+        while next_send < deadline:
+            time.sleep(max(0.0, next_send - time.perf_counter()))
+            name = self.change()
+            t = time.perf_counter()
+            self.sent += 1
+            if self.target.set_value(name, self.values[name]) == 200:
+                self.acked += 1
+            self.rtt.add(time.perf_counter() - t)
+            next_send = max(next_send + interval, time.perf_counter())
+
+    def run_bridge(self, start, next_send, interval, deadline):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.setblocking(False)
+        session = random.randrange(1, 0x10000)
+        seq = 0
+
+        def now_us():
+            return int((time.perf_counter() - start) * 1e6) & 0xFFFFFFFF
+
+        for i, name in enumerate(self.names):
+            seq += 1
+            sock.sendto(wire.encode_bind(session, seq, now_us(), i, name), self.target)
+        ids = {name: i for i, name in enumerate(self.names)}
+
+        def drain():
+            nonlocal seq
+            while True:
+                try:
+                    msg = wire.decode(sock.recv(256))
+                except BlockingIOError:
+                    return
+                if msg is None:
+                    continue
+                if msg.type == wire.ACK:
+                    self.acked += 1
+                    self.rtt.add(((now_us() - msg.time_us) & 0xFFFFFFFF) / 1e6)
+                elif msg.type == wire.UNKNOWN:
+                    seq = (seq + 1) & 0xFFFF
+                    id = msg.payload[0]
+                    sock.sendto(wire.encode_bind(session, seq, now_us(), id, self.names[id]), self.target)
+
+        def wait_until(t):
+            while True:
+                left = t - time.perf_counter()
+                if left <= 0:
+                    return
+                if select.select([sock], [], [], left)[0]:
+                    drain()
+
+        while next_send < deadline:
+            wait_until(next_send)
+            name = self.change()
+            seq = (seq + 1) & 0xFFFF
+            sock.sendto(wire.encode_set(session, seq, now_us(), [(ids[name], self.values[name])]), self.target)
+            self.sent += 1
+            next_send += interval
+        end = time.perf_counter() + 1.0
+        while time.perf_counter() < end and self.acked < self.sent:
+            wait_until(time.perf_counter() + 0.01)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Many simulated panels against the bridge and a mock TSW")
+    ap.add_argument("--panels", type=int, default=24)
+    ap.add_argument("--controllers", type=int, default=12, help="per panel")
+    ap.add_argument("--rate", type=float, default=50.0, help="changes per second and panel")
+    ap.add_argument("--seconds", type=float, default=10.0)
+    ap.add_argument("--delay-ms", type=float, default=2.0, help="processing time of the mock per request")
+    ap.add_argument("--pool", type=int, default=2, help="bridge connections to TSW")
+    ap.add_argument("--pipeline", type=int, default=8)
+    ap.add_argument("--tsw-rate", type=float, default=500.0, help="bridge rate limit, 0 = unlimited")
+    ap.add_argument("--direct", action="store_true", help="panels call the mock directly (no bridge)")
+    args = ap.parse_args()
+
+    tsw_port = free_port()
+    procs = [subprocess.Popen([sys.executable, os.path.join(HERE, "mock_tsw.py"), "--port", str(tsw_port),
+                               "--delay-ms", str(args.delay_ms)],
+                              stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)]
+    bridge = None
+    try:
+        if not wait_for_port(tsw_port):
+            sys.exit("mock_tsw.py did not start")
+
+        if args.direct:
+            targets = [TswClient("127.0.0.1", tsw_port, depth=1) for _ in range(args.panels)]
+            mode = "direct, one connection per panel"
+        else:
+            udp_port = free_port(socket.SOCK_DGRAM)
+            bridge = subprocess.Popen([sys.executable, "-u", os.path.join(HERE, "tsw_bridge.py"),
+                                       "--tsw-port", str(tsw_port), "--key", "", "--listen", "127.0.0.1",
+                                       "--udp-port", str(udp_port), "--ws-port", "0", "--stats-interval", "0",
+                                       "--pool", str(args.pool), "--pipeline", str(args.pipeline),
+                                       "--rate", str(args.tsw_rate)],
+                                      stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+            procs.append(bridge)
+            time.sleep(1.0)
+            targets = [("127.0.0.1", udp_port)] * args.panels
+            mode = "bridge, pool %d, rate %s" % (args.pool, "%.0f/s" % args.tsw_rate if args.tsw_rate else "unlimited")
+
+        print("[LoadTest] %d panels x %d controllers, %.0f changes/s each (%.0f/s offered), %.0f s, %s" % (
+            args.panels, args.controllers, args.rate, args.panels * args.rate, args.seconds, mode))
+
+        panels = [Panel(i, args, t) for i, t in enumerate(targets)]
+        for p in panels:
+            p.start()
+        for p in panels:
+            p.join()
+        done = time.perf_counter()
+
+        rtt = LatencyStats(window=1 << 16)
+        for p in panels:
+            for s in p.rtt.samples:
+                rtt.add(s)
+        sent = sum(p.sent for p in panels)
+        acked = sum(p.acked for p in panels)
+        print("[LoadTest] panels: %d sent (%.0f/s), %d acknowledged, %s" % (
+            sent, sent / args.seconds, acked, rtt.summary()))
+
+        # the bridge may still be draining its queue
+        expected = {name: value for p in panels for name, value in p.values.items()}
+        while True:
+            with urllib.request.urlopen("http://127.0.0.1:%d/stats" % tsw_port) as r:
+                stats = json.loads(r.read())
+            current = sum(abs(stats["values"].get(n, 99) - v) < 0.0015 for n, v in expected.items())
+            if current == len(expected) or time.perf_counter() - done > 5.0:
+                break
+            time.sleep(0.05)
+        print("[LoadTest] TSW: %d requests (%.0f/s, %.0f%% of the changes), %d connections" % (
+            stats["set"], stats["set"] / args.seconds, 100.0 * stats["set"] / max(1, sent), stats["connections"]))
+        print("[LoadTest] final values: %d of %d controllers current %.0f ms after the last change" % (
+            current, len(expected), (time.perf_counter() - done) * 1000))
+    finally:
+        if bridge is not None:
+            bridge.terminate()
+            for line in bridge.communicate(timeout=5)[0].splitlines():
+                if "forward" in line or "value age" in line or "TSW" in line:
+                    print("  " + line)
+        for p in procs:
+            if p.poll() is None:
+                p.terminate()
+                p.wait()
+
+
+if __name__ == "__main__":
+    main()
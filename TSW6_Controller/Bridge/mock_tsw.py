@@ -0,0 +1,167 @@
+# mock_tsw.py
+# -------------------------------------------------------------
+#   Minimal stand-in for the TSW External Interface API, for
+#   testing the bridge (and the controller) without the game.
+#
+#   python3 mock_tsw.py [--port 31270] [--delay-ms 2] [--key KEY] [--list-extra N]
+# -------------------------------------------------------------
+#
+# Supported endpoints (HTTP/1.1 keep-alive):
+#   GET  /set/ControllerValue/<controller>/<value>   -> {"Result":"Success"}
+#   GET  /get/CurrentDrivableActor/<controller>      -> {"Result":"Success","Values":{"Value":<last>}}
+#   GET  /list                                       -> known controllers (+ --list-extra dummies)
+#   POST /subscription/<path>?Subscription=N         -> adds <path> to subscription N
+#   GET  /subscription?Subscription=N                -> {"Entries":[{"Path":..,"NodeValid":true,"Values":{..}}]}
+#   DELETE /subscription?Subscription=N              -> drops subscription N
+#   GET  /stats                                      -> request counters
+
+import argparse
+import http.server
+import json
+import socketserver
+import threading
+import time
+import urllib.parse
+
+values = {}
+subscriptions = {}  # id -> registered paths, in order
+counters = {"set": 0, "get": 0, "subscription": 0, "connections": 0, "rejected": 0}
+lock = threading.Lock()
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    disable_nagle_algorithm = True
+
+    def setup(self):
+        super().setup()
+        with lock:
+            counters["connections"] += 1
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, code, body, content_type="application/json"):
+        data = body.encode() if isinstance(body, str) else body
+        self.send_response(code)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def admit(self):
+        key = self.server.comm_key
+        if key and self.headers.get("DTGCommKey") != key:
+            with lock:
+                counters["rejected"] += 1
+            self.reply(403, json.dumps({"Result": "Error", "Message": "Invalid CommKey"}))
+            return None
+        if self.server.delay:
+            time.sleep(self.server.delay)
+        path, _, query = self.path.partition("?")
+        sub = urllib.parse.parse_qs(query).get("Subscription", ["1"])[0]
+        return [urllib.parse.unquote(p) for p in path.split("/") if p], sub
+
+    def do_POST(self):
+        request = self.admit()
+        if request is None:
+            return
+        parts, sub = request
+        if len(parts) >= 2 and parts[0] == "subscription":
+            path = "/".join(parts[1:])
+            with lock:
+                paths = subscriptions.setdefault(sub, [])
+                if path not in paths:
+                    paths.append(path)
+            self.reply(200, json.dumps({"Result": "Success"}))
+        else:
+            self.reply(404, json.dumps({"Result": "Error", "Message": "Unknown path"}))
+
+    def do_DELETE(self):
+        request = self.admit()
+        if request is None:
+            return
+        parts, sub = request
+        if parts == ["subscription"]:
+            with lock:
+                subscriptions.pop(sub, None)
+            self.reply(200, json.dumps({"Result": "Success"}))
+        else:
+            self.reply(404, json.dumps({"Result": "Error", "Message": "Unknown path"}))
+
+    def do_GET(self):
+        request = self.admit()
+        if request is None:
+            return
+        parts, sub = request
+        if len(parts) == 4 and parts[:2] == ["set", "ControllerValue"]:
+            try:
+                value = float(parts[3])
+            except ValueError:
+                self.reply(400, json.dumps({"Result": "Error"}))
+                return
+            with lock:
+                values[parts[2]] = value
+                counters["set"] += 1
+            self.reply(200, json.dumps({"Result": "Success"}))
+        elif len(parts) == 3 and parts[:2] == ["get", "CurrentDrivableActor"]:
+            with lock:
+                counters["get"] += 1
+                value = values.get(parts[2], 0.0)
+            prop = parts[2].rsplit(".", 1)[1] if "." in parts[2] else "Value"
+            self.reply(200, json.dumps({"Result": "Success", "Values": {prop: round(value, 3)}}))
+        elif parts == ["subscription"]:
+            with lock:
+                if sub not in subscriptions:
+                    self.reply(404, json.dumps({"Result": "Error", "Message": "Unknown subscription"}))
+                    return
+                counters["subscription"] += 1
+                entries = []
+                for path in subscriptions[sub]:
+                    name = path.split("/", 1)[1] if "/" in path else path
+                    prop = name.rsplit(".", 1)[1] if "." in name else "Value"
+                    entries.append({"Path": path, "NodeValid": True,
+                                    "Values": {prop: round(values.get(name, 0.0), 3)}})
+            self.reply(200, json.dumps({"RequestedSubscriptionID": int(sub), "Entries": entries}))
+        elif parts == ["list"]:
+            with lock:
+                nodes = [{"Name": n} for n in sorted(values)]
+            # bulk like the node tree of a real loco, to exercise large answers
+            nodes += [{"NodePath": "CurrentDrivableActor/Node_%d" % i, "NodeName": "Node_%d" % i,
+                       "Endpoints": [{"Name": "Property_%d" % i, "Writable": False}]}
+                      for i in range(self.server.list_extra)]
+            self.reply(200, json.dumps({"Result": "Success", "Nodes": nodes}))
+        elif parts == ["stats"]:
+            with lock:
+                self.reply(200, json.dumps(dict(counters, values=values)))
+        else:
+            self.reply(404, json.dumps({"Result": "Error", "Message": "Unknown path"}))
+
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Mock TSW External Interface API")
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=31270)
+    ap.add_argument("--delay-ms", type=float, default=0.0, help="simulated processing time per request")
+    ap.add_argument("--key", default="", help="require this DTGCommKey")
+    ap.add_argument("--list-extra", type=int, default=0, help="dummy endpoints appended to /list")
+    args = ap.parse_args()
+
+    server = Server((args.host, args.port), Handler)
+    server.delay = args.delay_ms / 1000.0
+    server.comm_key = args.key
+    server.list_extra = args.list_extra
+    print(f"[MockTSW] listening on {args.host}:{args.port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,224 @@
+# panel_sim.py
+# -------------------------------------------------------------
+#   Simulates a controller panel talking to tsw_bridge.py over
+#   UDP, for testing without hardware. Can drop and reorder
+#   its own datagrams to exercise the loss/reorder handling.
+#
+#   python3 panel_sim.py [--controllers 8] [--rate 50] [--seconds 5]
+#                        [--loss 0.05] [--reorder 0.05]
+#
+#   With --serial /dev/pts/N the panel sends SLIP frames over a
+#   (pseudo) terminal instead, e.g. to "tsw_bridge.py --serial pty",
+#   and mixes in log lines like the firmware does. --websocket
+#   uses one WebSocket connection (--ws-port).
+#
+#   --subscribe asks the bridge to stream the game values of the
+#   simulated controllers back and checks that the last values
+#   pushed match the last values set.
+# -------------------------------------------------------------
+
+import argparse
+import base64
+import os
+import random
+import socket
+import threading
+import time
+
+import tsw_wire as wire
+from tsw_bridge import LatencyStats, open_serial, recv_exact
+
+
+class UdpLink:
+    def __init__(self, host, port):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(0.2)
+        self.target = (host, port)
+
+    def send(self, msg):
+        self.sock.sendto(msg, self.target)
+
+    def log(self, text):
+        pass  # log output goes elsewhere with WiFi
+
+    def receive(self):
+        try:
+            return [self.sock.recv(256)]
+        except socket.timeout:
+            return []
+
+
+class SerialLink:
+    def __init__(self, path, baud):
+        self.port = open_serial(path, baud)
+        self.decoder = wire.SlipDecoder()
+        self.lock = threading.Lock()
+
+    def send(self, msg):
+        with self.lock:
+            self.port.write(wire.slip_encode(msg))
+
+    def log(self, text):
+        with self.lock:
+            self.port.write(text.encode() + b"\r\n")
+
+    def receive(self):
+        return [m for valid, m in self.decoder.feed(self.port.read(256)) if valid]
+
+
+class WebSocketLink:
+    def __init__(self, host, port):
+        self.sock = socket.create_connection((host, port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        key = base64.b64encode(os.urandom(16)).decode()
+        self.sock.sendall(("GET /tsw HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % (host, port, key)).encode())
+        response = b""
+        while b"\r\n\r\n" not in response:
+            response += self.sock.recv(1024)
+        if not response.startswith(b"HTTP/1.1 101"):
+            raise ConnectionError(response.split(b"\r\n")[0].decode())
+        self.sock.settimeout(0.2)
+        self.lock = threading.Lock()
+
+    def send(self, msg):
+        # client frames are masked
+        mask = os.urandom(4)
+        head = bytes([0x82, 0x80 | len(msg)]) if len(msg) < 126 else \
+            bytes([0x82, 0x80 | 126]) + len(msg).to_bytes(2, "big")
+        with self.lock:
+            self.sock.sendall(head + mask + bytes(c ^ mask[i & 3] for i, c in enumerate(msg)))
+
+    def log(self, text):
+        pass
+
+    def receive(self):
+        try:
+            first = self.sock.recv(1)
+        except socket.timeout:
+            return []
+        if not first:
+            raise ConnectionError("closed")
+        self.sock.settimeout(None)  # rest of the frame is already on its way
+        b0, b1 = first[0], recv_exact(self.sock, 1)[0]
+        n = b1 & 0x7F
+        if n == 126:
+            n = int.from_bytes(recv_exact(self.sock, 2), "big")
+        payload = recv_exact(self.sock, n)
+        self.sock.settimeout(0.2)
+        return [payload] if b0 & 0x0F == 0x2 else []
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Simulated controller panel")
+    ap.add_argument("--bridge", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=31271)
+    ap.add_argument("--serial", default="", help="talk over this serial port / pty instead of UDP")
+    ap.add_argument("--websocket", action="store_true", help="talk over a WebSocket instead of UDP")
+    ap.add_argument("--ws-port", type=int, default=31272)
+    ap.add_argument("--subscribe", action="store_true", help="stream the game values back and compare")
+    ap.add_argument("--baud", type=int, default=921600)
+    ap.add_argument("--controllers", type=int, default=8)
+    ap.add_argument("--rate", type=float, default=50.0, help="SET messages per second")
+    ap.add_argument("--seconds", type=float, default=5.0)
+    ap.add_argument("--loss", type=float, default=0.0, help="fraction of messages not sent")
+    ap.add_argument("--reorder", type=float, default=0.0, help="fraction of messages held back one slot")
+    args = ap.parse_args()
+
+    if args.serial:
+        link = SerialLink(args.serial, args.baud)
+    elif args.websocket:
+        link = WebSocketLink(args.bridge, args.ws_port)
+    else:
+        link = UdpLink(args.bridge, args.port)
+    session = random.randrange(1, 0x10000)
+    seq = 0
+    start = time.perf_counter()
+
+    def now_us():
+        return int((time.perf_counter() - start) * 1e6)
+
+    def next_seq():
+        nonlocal seq
+        seq = (seq + 1) & 0xFFFF
+        return seq
+
+    names = ["SimControl%02d" % i for i in range(args.controllers)]
+    for i, name in enumerate(names):
+        link.send(wire.encode_bind(session, next_seq(), now_us(), i, name))
+    if args.subscribe:
+        link.send(wire.encode_subscribe(session, next_seq(), now_us(), 20, range(len(names))))
+
+    rtt = LatencyStats()
+    sent = dropped = acked = stale = failed = unknown = 0
+    held = None
+    values = {}
+    pushed = {}
+    updates = 0
+    interval = 1.0 / args.rate
+    deadline = time.perf_counter() + args.seconds
+
+    running = True
+
+    # replies are read on their own thread, so the round trip is not skewed by the send pacing
+    def receiver():
+        nonlocal acked, stale, failed, unknown, updates
+        while running:
+            for data in link.receive():
+                msg = wire.decode(data)
+                if msg is None or msg.session != session:
+                    continue
+                if msg.type == wire.ACK and len(msg.payload) >= 3:
+                    acked += 1
+                    stale += msg.payload[1]
+                    failed += msg.payload[2]
+                    rtt.add((now_us() - msg.time_us) / 1e6)
+                elif msg.type == wire.UNKNOWN:
+                    unknown += 1
+                    id = msg.payload[0]
+                    link.send(wire.encode_bind(session, next_seq(), now_us(), id, names[id]))
+                elif msg.type == wire.UPDATE:
+                    for id, value in wire.decode_update(msg.payload):
+                        pushed[id] = value
+                        updates += 1
+
+    thread = threading.Thread(target=receiver, daemon=True)
+    thread.start()
+
+    while time.perf_counter() < deadline:
+        id = random.randrange(len(names))
+        values[id] = round(random.uniform(-1, 1), 3)
+        data = wire.encode_set(session, next_seq(), now_us(), [(id, values[id])])
+        sent += 1
+        if random.random() < args.loss:
+            dropped += 1
+        elif held is None and random.random() < args.reorder:
+            held = data
+        else:
+            link.send(data)
+            if held is not None:
+                link.send(held)  # older message arrives after a newer one
+                held = None
+        if sent % 50 == 0:
+            link.log("[%d ms] PanelSim %s -> %.3f" % (now_us() // 1000, names[id], values[id]))
+        time.sleep(interval)
+
+    if held is not None:
+        link.send(held)
+    time.sleep(0.5)
+    if args.subscribe:
+        # values set by the simulation must come back; none set yet reads 0 on the echo bridge
+        matching = sum(1 for id in range(len(names)) if abs(pushed.get(id, 99) - values.get(id, 0.0)) < 0.0015)
+    running = False
+    thread.join()
+
+    print("[PanelSim] session %04x: %d sent, %d dropped, %d acked, %d stale, %d failed, %d unknown" % (
+        session, sent, dropped, acked, stale, failed, unknown))
+    print("[PanelSim] round trip: %s" % rtt.summary())
+    if args.subscribe:
+        print("[PanelSim] %d updates received, %d of %d controllers match the last value set" % (
+            updates, matching, len(names)))
+
+
+if __name__ == "__main__":
+    main()
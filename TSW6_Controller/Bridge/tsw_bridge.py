@@ -0,0 +1,801 @@
+# tsw_bridge.py
+# -------------------------------------------------------------
+#   Bridge between the controllers and the TSW External
+#   Interface API on the game PC.
+#
+#   Controllers send compact binary messages (tsw_wire.py)
+#   via UDP, WebSocket or as SLIP frames over a USB-serial
+#   cable; the bridge resolves the controller ids and calls
+#   the API locally. The API can then stay bound to localhost -
+#   no port proxy needed.
+#
+#   Any number of panels can connect at once. Their values are
+#   merged per controller (latest value wins) and sent to TSW
+#   over a small pool of pipelined keep-alive connections at a
+#   limited rate (--pool, --pipeline, --rate). Subscribed game
+#   values are polled on a connection of their own and pushed
+#   back to the controller when they change.
+#
+#   python3 tsw_bridge.py [--udp-port 31271] [--ws-port 31272]
+#                         [--serial COM3 --baud 921600]
+#                         [--tsw-port 31270] [--pool 2] [--rate 500]
+#                         [--key KEY | --key-file CommAPIKey.txt]
+#
+#   --serial pty creates a pseudo-terminal (Linux) for tests,
+#   --echo answers locally instead of calling TSW.
+#
+#   The bridge announces itself via mDNS as _tsw-bridge._udp
+#   (tsw_mdns.py), controllers find it without a configured IP;
+#   --no-mdns turns that off.
+# -------------------------------------------------------------
+
+import argparse
+import base64
+import hashlib
+import http.client
+import json
+import os
+import select
+import signal
+import socket
+import sys
+import threading
+import time
+import urllib.parse
+
+import tsw_mdns
+import tsw_wire as wire
+
+PEER_TIMEOUT = 15.0  # seconds without messages until subscriptions stop (controllers resubscribe every 5 s)
+
+DEFAULT_KEY_FILE = os.path.join(os.path.expanduser("~"), "Documents", "My Games",
+                                "TrainSimWorld6", "Saved", "Config", "CommAPIKey.txt")
+
+
+class LatencyStats:
+    """Average, 95th percentile and maximum over the last samples."""
+
+    def __init__(self, window=1024):
+        self.window = window
+        self.samples = []
+        self.pos = 0
+        self.count = 0
+        self.total = 0.0
+        self.max = 0.0
+        self.lock = threading.Lock()
+
+    def add(self, seconds):
+        with self.lock:
+            if len(self.samples) < self.window:
+                self.samples.append(seconds)
+            else:
+                self.samples[self.pos] = seconds
+                self.pos = (self.pos + 1) % self.window
+            self.count += 1
+            self.total += seconds
+            self.max = max(self.max, seconds)
+
+    def summary(self):
+        with self.lock:
+            if not self.count:
+                return "-"
+            ordered = sorted(self.samples)
+            p95 = ordered[min(len(ordered) - 1, int(len(ordered) * 0.95))]
+            return "avg %.2f ms  p95 %.2f ms  max %.2f ms" % (
+                self.total / self.count * 1000, p95 * 1000, self.max * 1000)
+
+
+def quote(controller):
+    return urllib.parse.quote(controller, safe="/()._-")
+
+
+def parse_value(body):
+    """first value of a read answer: {"Result":..,"Values":{"<property>":0.5}} or a bare number"""
+    try:
+        data = json.loads(body)
+    except ValueError:
+        return None
+    if isinstance(data, dict):
+        data = next(iter((data.get("Values") or {}).values()), None)
+    if isinstance(data, bool):
+        return 1.0 if data else 0.0
+    return float(data) if isinstance(data, (int, float)) else None
+
+
+class TswClient:
+    """Keep-alive connection to the TSW API with request pipelining (not thread safe)."""
+
+    def __init__(self, host, port, key="", depth=8, latency=None):
+        self.host = host
+        self.port = port
+        self.key = key
+        self.depth = depth     # requests written before the first response is read
+        self.sock = None
+        self.rfile = None
+        self.on_socket = 0     # responses read on the current socket
+        self.latency = latency or LatencyStats()
+        self.requests = 0
+        self.failures = 0
+        self.connects = 0
+
+    def _connect(self):
+        try:
+            self.sock = socket.create_connection((self.host, self.port), timeout=1.0)
+        except OSError:
+            self.sock = None
+            return False
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.rfile = self.sock.makefile("rb")
+        self.on_socket = 0
+        self.connects += 1
+        return True
+
+    def close(self):
+        if self.sock is not None:
+            self.rfile.close()
+            self.sock.close()
+        self.sock = None
+        self.rfile = None
+
+    def _head(self, path):
+        key = "DTGCommKey: %s\r\n" % self.key if self.key else ""
+        return ("GET %s HTTP/1.1\r\nHost: %s:%d\r\n%s\r\n" % (path, self.host, self.port, key)).encode()
+
+    def _read_response(self):
+        """-> (status, body, keep_alive); raises OSError/ValueError on a broken stream"""
+        line = self.rfile.readline()
+        if not line:
+            raise ConnectionError("closed")
+        status = int(line.split(None, 2)[1])
+        keep = line.startswith(b"HTTP/1.1")
+        length = None
+        chunked = False
+        while True:
+            h = self.rfile.readline()
+            if h in (b"\r\n", b"\n", b""):
+                break
+            name, _, value = h.partition(b":")
+            name = name.strip().lower()
+            value = value.strip().lower()
+            if name == b"content-length":
+                length = int(value)
+            elif name == b"transfer-encoding" and value == b"chunked":
+                chunked = True
+            elif name == b"connection":
+                keep = value == b"keep-alive" or (keep and value != b"close")
+        if chunked:
+            body = b""
+            while True:
+                size = int(self.rfile.readline().split(b";")[0], 16)
+                body += self.rfile.read(size + 2)[:size]
+                if size == 0:
+                    break
+        elif length is not None:
+            body = self.rfile.read(length)
+            if len(body) != length:
+                raise ConnectionError("short body")
+        else:
+            body = self.rfile.read()
+            keep = False
+        return status, body, keep
+
+    def request_many(self, paths):
+        """-> [(status, body)] in order; status -1 if the request could not be made"""
+        results = []
+        retried = False
+        while len(results) < len(paths):
+            todo = paths[len(results):len(results) + self.depth]
+            if self.sock is None and not self._connect():
+                break
+            reused = self.on_socket > 0
+            try:
+                self.sock.sendall(b"".join(self._head(path) for path in todo))
+                start = time.perf_counter()
+                for _ in todo:
+                    status, body, keep = self._read_response()
+                    self.latency.add(time.perf_counter() - start)
+                    self.requests += 1
+                    self.on_socket += 1
+                    results.append((status, body))
+                    if not keep:
+                        self.close()
+                        break
+            except (OSError, ValueError, IndexError):
+                self.close()
+                if reused and not retried:
+                    retried = True  # idle socket closed by the server, one fresh attempt
+                    continue
+                break
+        self.failures += len(paths) - len(results)
+        return results + [(-1, b"")] * (len(paths) - len(results))
+
+    def set_values(self, items):
+        """items: [(controller, value)] -> [status]"""
+        paths = ["/set/ControllerValue/%s/%.3f" % (quote(c), v) for c, v in items]
+        return [status for status, _ in self.request_many(paths)]
+
+    def set_value(self, controller, value):
+        return self.set_values([(controller, value)])[0]
+
+    def get_values(self, controllers):
+        """-> [value or None], requested pipelined"""
+        values = []
+        for status, body in self.request_many(["/get/CurrentDrivableActor/" + quote(c) for c in controllers]):
+            values.append(parse_value(body) if status == 200 else None)
+        return values
+
+    def get_value(self, controller):
+        return self.get_values([controller])[0]
+
+
+class EchoTsw:
+    """Stand-in for TswClient: keeps the values set and returns them on get."""
+
+    def __init__(self):
+        self.values = {}
+        self.latency = LatencyStats()
+        self.requests = 0
+        self.failures = 0
+        self.lock = threading.Lock()
+
+    def set_values(self, items):
+        with self.lock:
+            for controller, value in items:
+                self.values[controller] = value
+            self.requests += len(items)
+        return [200] * len(items)
+
+    def set_value(self, controller, value):
+        return self.set_values([(controller, value)])[0]
+
+    def get_values(self, controllers):
+        with self.lock:
+            self.requests += len(controllers)
+            return [self.values.get(c, 0.0) for c in controllers]
+
+    def get_value(self, controller):
+        return self.get_values([controller])[0]
+
+
+class Slot:
+    __slots__ = ("value", "changed", "status")
+
+    def __init__(self):
+        self.value = 0.0
+        self.changed = 0.0   # arrival of the value not yet forwarded
+        self.status = None   # HTTP status of the last forward
+
+
+class Forwarder:
+    """Latest value per controller, merged over all panels and sent to TSW by
+    a pool of keep-alive connections at a limited request rate.
+
+    set() only updates the table, it never waits for TSW. Values arriving
+    while an older one is still queued replace it (coalesced). A controller
+    is never in flight on two connections at once, so TSW sees its values
+    in order.
+    """
+
+    def __init__(self, clients, rate=0.0, batch=8):
+        self.clients = clients
+        self.rate = rate           # requests per second over all connections, 0 = unlimited
+        self.batch = batch         # controllers taken per connection and round (pipelined)
+        self.slots = {}            # controller name -> Slot
+        self.dirty = {}            # controllers with an unsent value, oldest first
+        self.in_flight = set()
+        self.cond = threading.Condition()
+        self.tokens = float(batch)
+        self.refill = time.monotonic()
+        self.bucket = threading.Lock()
+        self.received = 0
+        self.coalesced = 0         # values replaced before they were sent
+        self.forwarded = 0
+        self.failures = 0
+        self.max_dirty = 0
+        self.age = LatencyStats()  # arrival at the bridge until TSW answered
+        self.started = time.monotonic()
+        for client in clients:
+            threading.Thread(target=self._run, args=(client,), daemon=True).start()
+
+    def set(self, controller, value):
+        """-> status of the last forward of this controller (None before the first)"""
+        with self.cond:
+            slot = self.slots.get(controller)
+            if slot is None:
+                slot = self.slots[controller] = Slot()
+            self.received += 1
+            if controller in self.dirty:
+                self.coalesced += 1
+            else:
+                slot.changed = time.perf_counter()
+                self.dirty[controller] = None
+                self.max_dirty = max(self.max_dirty, len(self.dirty))
+            slot.value = value
+            self.cond.notify()
+            return slot.status
+
+    def _take(self):
+        with self.cond:
+            while True:
+                names = [c for c in self.dirty if c not in self.in_flight][:self.batch]
+                if names:
+                    break
+                self.cond.wait()
+            batch = []
+            for c in names:
+                del self.dirty[c]
+                self.in_flight.add(c)
+                slot = self.slots[c]
+                batch.append((c, slot.value, slot.changed))
+            return batch
+
+    def _acquire(self, n):
+        if self.rate <= 0:
+            return
+        with self.bucket:
+            now = time.monotonic()
+            self.tokens = min(float(self.batch), self.tokens + (now - self.refill) * self.rate)
+            self.refill = now
+            self.tokens -= n
+            wait = -self.tokens / self.rate
+        if wait > 0:
+            time.sleep(wait)  # meanwhile newer values replace the queued ones
+
+    def _run(self, client):
+        while True:
+            batch = self._take()
+            self._acquire(len(batch))
+            statuses = client.set_values([(c, v) for c, v, _ in batch])
+            done = time.perf_counter()
+            with self.cond:
+                for (c, _, changed), status in zip(batch, statuses):
+                    self.in_flight.discard(c)
+                    self.slots[c].status = status
+                    self.forwarded += 1
+                    if status != 200:
+                        self.failures += 1
+                    self.age.add(done - changed)
+                self.cond.notify_all()
+
+    def report(self):
+        with self.cond:
+            elapsed = max(1e-6, time.monotonic() - self.started)
+            print("[Bridge] forward: %d received, %d coalesced, %d sent (%.0f/s), %d failures, "
+                  "max %d queued, %d controllers" % (
+                      self.received, self.coalesced, self.forwarded, self.forwarded / elapsed,
+                      self.failures, self.max_dirty, len(self.slots)))
+        print("[Bridge] value age at TSW: %s" % self.age.summary())
+        requests = sum(c.requests for c in set(self.clients))
+        failures = sum(c.failures for c in set(self.clients))
+        print("[Bridge] TSW: %d connections, %d requests, %d failures, %s" % (
+            len(self.clients), requests, failures, self.clients[0].latency.summary()))
+
+
+class Peer:
+    """State of one controller session (one boot of one device)."""
+
+    def __init__(self, session):
+        self.session = session
+        self.send = None       # pushes a message to the controller, set by the transport
+        self.subscriptions = {}  # wire id -> last value pushed (quantized) or None
+        self.interval = 0.1    # poll interval of the subscriptions, seconds
+        self.next_poll = 0.0
+        self.out_seq = 0       # seq of the messages the bridge sends on its own
+        self.updates = 0       # values pushed
+        self.names = {}        # wire id -> controller name
+        self.applied = {}      # wire id -> seq of the value last forwarded
+        self.highest = None    # highest seq seen
+        self.received = 0
+        self.last_seen = time.monotonic()
+        self.lost = 0          # gaps in the sequence
+        self.reordered = 0     # arrived after a newer message
+        self.stale = 0         # values dropped because a newer one was applied
+
+
+class Bridge:
+    """Transport independent message handling; handle() returns the replies.
+
+    Values go to the Forwarder and are acknowledged right away; reads (GET,
+    subscriptions) use a connection of their own, so they never wait behind
+    the sets.
+    """
+
+    def __init__(self, forwarder, reader):
+        self.forwarder = forwarder
+        self.reader = reader
+        self.read_lock = threading.Lock()
+        self.peers = {}
+        self.lock = threading.Lock()
+
+    def peer(self, key, msg):
+        p = self.peers.get(key)
+        if p is None or p.session != msg.session:
+            p = Peer(msg.session)
+            self.peers[key] = p
+            print("[Bridge] new session %04x from %s" % (msg.session, key))
+        return p
+
+    def track_seq(self, p, seq):
+        p.received += 1
+        p.last_seen = time.monotonic()
+        if p.highest is None:
+            p.highest = seq
+        elif wire.seq_newer(seq, p.highest):
+            p.lost += ((seq - p.highest) & 0xFFFF) - 1
+            p.highest = seq
+        else:
+            p.reordered += 1
+            p.lost = max(0, p.lost - 1)  # counted as lost when the gap was seen
+
+    def handle(self, key, data, send=None):
+        """send(message) lets the bridge push subscription updates to this controller."""
+        msg = wire.decode(data)
+        if msg is None:
+            return []
+        try:
+            return self.dispatch(key, msg, send)
+        except Exception as e:  # one bad message must not stop the listener
+            print("[Bridge] error handling message from %s: %r" % (key, e))
+            return []
+
+    def disconnect(self, key):
+        with self.lock:
+            p = self.peers.get(key)
+            if p is not None:
+                p.send = None
+
+    def dispatch(self, key, msg, send=None):
+        with self.lock:
+            p = self.peer(key, msg)
+            p.send = send or p.send
+            self.track_seq(p, msg.seq)
+
+            if msg.type == wire.BIND:
+                bound = wire.decode_bind(msg.payload)
+                if bound:
+                    p.names[bound[0]] = bound[1]
+                    p.applied.pop(bound[0], None)
+                return []
+
+            if msg.type == wire.SET:
+                return self.handle_set(p, msg)
+
+            if msg.type == wire.SUBSCRIBE:
+                sub = wire.decode_subscribe(msg.payload)
+                if sub is None:
+                    return []
+                interval_ms, ids = sub
+                p.interval = max(interval_ms, 10) / 1000.0
+                # keep the last pushed value of ids already subscribed, no duplicate updates
+                p.subscriptions = {id: p.subscriptions.get(id) for id in ids}
+                return [wire.encode_unknown(msg, id) for id in ids if id not in p.names]
+
+            if msg.type == wire.GET and msg.payload:
+                id = msg.payload[0]
+                if id not in p.names:
+                    return [wire.encode_unknown(msg, id)]
+                with self.read_lock:
+                    value = self.reader.get_value(p.names[id])
+                return [wire.encode_value(msg, id, value or 0.0)]
+        return []
+
+    def handle_set(self, p, msg):
+        replies = []
+        accepted = stale = failed = 0
+        for id, value in wire.decode_set(msg.payload):
+            name = p.names.get(id)
+            if name is None:
+                replies.append(wire.encode_unknown(msg, id))
+                continue
+            last = p.applied.get(id)
+            if last is not None and not wire.seq_newer(msg.seq, last):
+                stale += 1  # a newer value of this controller already went out
+                p.stale += 1
+                continue
+            p.applied[id] = msg.seq
+            # failed reports the previous forward of this controller, the current one is still queued
+            if self.forwarder.set(name, value) in (None, 200):
+                accepted += 1
+            else:
+                failed += 1
+        replies.append(wire.encode_ack(msg, accepted, stale, failed))
+        return replies
+
+    def poll(self):
+        """Reads the due subscriptions and pushes changed values; returns seconds until the next poll."""
+        now = time.monotonic()
+        with self.lock:
+            due = [(p, [(id, p.names[id]) for id in p.subscriptions if id in p.names])
+                   for p in self.peers.values()
+                   if p.send is not None and p.subscriptions and p.next_poll <= now
+                   and now - p.last_seen < PEER_TIMEOUT]
+            for p, _ in due:
+                p.next_poll = now + p.interval
+        for p, subs in due:
+            changed = []
+            with self.read_lock:
+                values = self.reader.get_values([name for _, name in subs])
+            for (id, _), value in zip(subs, values):
+                if value is None:
+                    continue
+                q = wire.quantize(value)
+                if p.subscriptions.get(id) != q:
+                    p.subscriptions[id] = q
+                    changed.append((id, value))
+            for i in range(0, len(changed), wire.UPDATE_MAX):
+                p.out_seq = (p.out_seq + 1) & 0xFFFF
+                out = wire.encode_update(p.session, p.out_seq, int(now * 1e6) & 0xFFFFFFFF,
+                                         changed[i:i + wire.UPDATE_MAX])
+                try:
+                    p.send(out)
+                except OSError:
+                    p.send = None
+                    break
+                p.updates += min(wire.UPDATE_MAX, len(changed) - i)
+        with self.lock:
+            pending = [p.next_poll for p in self.peers.values()
+                       if p.send is not None and p.subscriptions and now - p.last_seen < PEER_TIMEOUT]
+        return max(0.005, min(pending) - time.monotonic()) if pending else 0.05
+
+    def report(self):
+        with self.lock:
+            for key, p in self.peers.items():
+                print("[Bridge] %s session %04x: %d received, %d lost, %d reordered, %d stale, %d controllers, "
+                      "%d subscribed, %d updates" % (
+                          key, p.session, p.received, p.lost, p.reordered, p.stale, len(p.names),
+                          len(p.subscriptions), p.updates))
+        self.forwarder.report()
+        print("[Bridge] TSW reads: %d requests, %d failures, %s" % (
+            self.reader.requests, self.reader.failures, self.reader.latency.summary()))
+
+
+def serve_udp(bridge, host, port):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)  # bursts of many panels, e.g. all binding at once
+    sock.bind((host, port))
+    print("[Bridge] UDP on %s:%d" % (host, port))
+    while True:
+        data, addr = sock.recvfrom(2048)
+        send = lambda out, addr=addr: sock.sendto(out, addr)
+        for out in bridge.handle("%s:%d" % addr, data, send):
+            sock.sendto(out, addr)
+
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+def ws_frame(opcode, payload):
+    """Unmasked server frame (RFC 6455)."""
+    n = len(payload)
+    if n < 126:
+        head = bytes([0x80 | opcode, n])
+    elif n < 0x10000:
+        head = bytes([0x80 | opcode, 126]) + n.to_bytes(2, "big")
+    else:
+        head = bytes([0x80 | opcode, 127]) + n.to_bytes(8, "big")
+    return head + payload
+
+
+def recv_exact(conn, n):
+    data = b""
+    while len(data) < n:
+        chunk = conn.recv(n - len(data))
+        if not chunk:
+            raise ConnectionError("closed")
+        data += chunk
+    return data
+
+
+def ws_handshake(conn):
+    request = b""
+    while b"\r\n\r\n" not in request:
+        chunk = conn.recv(1024)
+        if not chunk or len(request) > 8192:
+            return False
+        request += chunk
+    headers = {}
+    for line in request.decode(errors="replace").split("\r\n")[1:]:
+        name, _, value = line.partition(":")
+        headers[name.strip().lower()] = value.strip()
+    key = headers.get("sec-websocket-key")
+    if not key or headers.get("upgrade", "").lower() != "websocket":
+        conn.sendall(b"HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n")
+        return False
+    accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+    conn.sendall(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: %s\r\n\r\n" % accept).encode())
+    return True
+
+
+def serve_ws_client(bridge, conn, addr):
+    key = "ws:%s:%d" % addr
+    lock = threading.Lock()  # replies and pushed updates come from different threads
+
+    def send(out, opcode=0x2):
+        with lock:
+            conn.sendall(ws_frame(opcode, out))
+
+    try:
+        conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        if not ws_handshake(conn):
+            return
+        print("[Bridge] WebSocket from %s:%d" % addr)
+        while True:
+            b0, b1 = recv_exact(conn, 2)
+            n = b1 & 0x7F
+            if n == 126:
+                n = int.from_bytes(recv_exact(conn, 2), "big")
+            elif n == 127:
+                n = int.from_bytes(recv_exact(conn, 8), "big")
+            mask = recv_exact(conn, 4) if b1 & 0x80 else b"\0\0\0\0"
+            payload = bytes(c ^ mask[i & 3] for i, c in enumerate(recv_exact(conn, n)))
+            opcode = b0 & 0x0F
+            if opcode == 0x2:
+                for out in bridge.handle(key, payload, send):
+                    send(out)
+            elif opcode == 0x9:
+                send(payload, 0xA)
+            elif opcode == 0x8:
+                send(payload[:2], 0x8)
+                break
+    except OSError:
+        pass
+    finally:
+        bridge.disconnect(key)
+        conn.close()
+        print("[Bridge] WebSocket %s:%d closed" % addr)
+
+
+def serve_websocket(bridge, host, port):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((host, port))
+    server.listen(16)
+    print("[Bridge] WebSocket on ws://%s:%d/tsw" % (host, port))
+    while True:
+        conn, addr = server.accept()
+        threading.Thread(target=serve_ws_client, args=(bridge, conn, addr), daemon=True).start()
+
+
+class PosixSerial:
+    """Raw serial port via termios, used when pyserial is not installed."""
+
+    def __init__(self, fd, baud=None, keep=None):
+        import termios
+        import tty
+        self.fd = fd
+        self.keep = keep  # pty slave kept open so reads on the master do not fail
+        if baud is not None:
+            tty.setraw(fd)
+            attrs = termios.tcgetattr(fd)
+            speed = getattr(termios, "B%d" % baud, None)
+            if speed is not None:
+                attrs[4] = attrs[5] = speed
+                termios.tcsetattr(fd, termios.TCSANOW, attrs)
+
+    def read(self, size):
+        ready, _, _ = select.select([self.fd], [], [], 0.1)
+        return os.read(self.fd, size) if ready else b""
+
+    def write(self, data):
+        return os.write(self.fd, data)
+
+
+def open_serial(path, baud):
+    if path == "pty":
+        import tty
+        master, slave = os.openpty()
+        tty.setraw(slave)
+        print("[Bridge] serial pty %s" % os.ttyname(slave))
+        return PosixSerial(master, keep=slave)
+    try:
+        import serial  # pyserial, required on Windows
+        return serial.Serial(path, baud, timeout=0.1)
+    except ImportError:
+        if os.name != "posix":
+            sys.exit("pyserial is required for --serial on this system (pip install pyserial)")
+        return PosixSerial(os.open(path, os.O_RDWR | os.O_NOCTTY), baud)
+
+
+def serve_serial(bridge, path, baud):
+    port = open_serial(path, baud)
+    decoder = wire.SlipDecoder()
+    key = "serial:%s" % path
+    lock = threading.Lock()  # replies and pushed updates come from different threads
+
+    def send(out):
+        with lock:
+            port.write(wire.slip_encode(out))
+
+    print("[Bridge] serial on %s (%d baud)" % (path, baud))
+    while True:
+        data = port.read(256)
+        for valid, chunk in decoder.feed(data):
+            if not valid:
+                # log output of the controller between the frames
+                text = chunk.decode(errors="replace").rstrip()
+                if text:
+                    print("[Device] " + text.replace("\n", "\n[Device] "))
+                continue
+            for out in bridge.handle(key, chunk, send):
+                send(out)
+
+
+def load_key(args):
+    if args.key:
+        return args.key
+    if args.key_file and os.path.exists(args.key_file):
+        with open(args.key_file) as f:
+            return f.read().strip()
+    return ""
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Bridge between TSW controllers and the TSW API")
+    ap.add_argument("--tsw-host", default="127.0.0.1")
+    ap.add_argument("--tsw-port", type=int, default=31270)
+    ap.add_argument("--key", default="", help="DTGCommKey")
+    ap.add_argument("--key-file", default=DEFAULT_KEY_FILE)
+    ap.add_argument("--listen", default="0.0.0.0")
+    ap.add_argument("--udp-port", type=int, default=31271, help="0 = no UDP")
+    ap.add_argument("--ws-port", type=int, default=31272, help="WebSocket, 0 = off")
+    ap.add_argument("--serial", default="", help="serial port of a wired controller, e.g. COM3, or 'pty'")
+    ap.add_argument("--baud", type=int, default=921600)
+    ap.add_argument("--stats-interval", type=float, default=10.0, help="seconds, 0 = off")
+    ap.add_argument("--echo", action="store_true", help="do not call TSW, answer gets with the values set")
+    ap.add_argument("--pool", type=int, default=2, help="keep-alive connections for the sets")
+    ap.add_argument("--pipeline", type=int, default=8, help="requests in flight per connection")
+    ap.add_argument("--rate", type=float, default=500.0, help="max. sets per second to TSW, 0 = unlimited")
+    ap.add_argument("--no-mdns", action="store_true", help="do not announce the bridge via mDNS")
+    ap.add_argument("--mdns-name", default=None, help="service instance name (default: TSW Bridge on <PC>)")
+    args = ap.parse_args()
+
+    if args.echo:
+        echo = EchoTsw()
+        clients, reader = [echo] * args.pool, echo
+    else:
+        key = load_key(args)
+        latency = LatencyStats()  # shared by the pool
+        clients = [TswClient(args.tsw_host, args.tsw_port, key, args.pipeline, latency) for _ in range(args.pool)]
+        reader = TswClient(args.tsw_host, args.tsw_port, key, args.pipeline)
+    bridge = Bridge(Forwarder(clients, args.rate, args.pipeline), reader)
+    signal.signal(signal.SIGTERM, signal.default_int_handler)  # final report on kill as well
+    sys.setswitchinterval(0.0005)  # listener threads get the interpreter back quickly while the pool works
+
+    def poller():
+        while True:
+            time.sleep(bridge.poll())
+    threading.Thread(target=poller, daemon=True).start()
+
+    if args.stats_interval > 0:
+        def reporter():
+            while True:
+                time.sleep(args.stats_interval)
+                bridge.report()
+        threading.Thread(target=reporter, daemon=True).start()
+
+    if not args.no_mdns and (args.udp_port or args.ws_port):
+        responder = tsw_mdns.Responder(args.udp_port, args.ws_port, args.mdns_name)
+        try:
+            responder.start()
+            print("[Bridge] mDNS: %s -> %s" % (responder.instance, responder.host))
+        except OSError as e:
+            print("[Bridge] mDNS not available (%s), controllers need the IP address" % e)
+
+    if args.serial:
+        threading.Thread(target=serve_serial, args=(bridge, args.serial, args.baud), daemon=True).start()
+    if args.ws_port:
+        threading.Thread(target=serve_websocket, args=(bridge, args.listen, args.ws_port), daemon=True).start()
+
+    try:
+        if args.udp_port:
+            serve_udp(bridge, args.listen, args.udp_port)
+        else:
+            while True:
+                time.sleep(1)
+    except KeyboardInterrupt:
+        bridge.report()
+
+
+if __name__ == "__main__":
+    main()
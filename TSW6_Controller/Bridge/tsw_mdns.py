@@ -0,0 +1,255 @@
+# tsw_mdns.py
+# -------------------------------------------------------------
+#   Minimal mDNS / DNS-SD responder (RFC 6762/6763) so the
+#   controllers find the bridge on the LAN without a configured
+#   IP address. Announces one service instance:
+#
+#     _tsw-bridge._udp.local  PTR  <instance>._tsw-bridge._udp.local
+#     <instance>              SRV  0 0 <udp port> <host>.local
+#     <instance>              TXT  "udp=31271" "ws=31272"
+#     <host>.local            A    address of the interface the
+#                                  query came in on
+#
+#   Only the standard library; shares UDP port 5353 with other
+#   responders on the machine (Bonjour, Windows, avahi).
+#
+#   python3 tsw_mdns.py --query       # look for bridges on the LAN
+# -------------------------------------------------------------
+
+import socket
+import struct
+import threading
+import time
+
+MDNS_ADDR = "224.0.0.251"
+MDNS_PORT = 5353
+SERVICE = "_tsw-bridge._udp.local"
+META = "_services._dns-sd._udp.local"
+
+T_A, T_PTR, T_TXT, T_SRV, T_ANY = 1, 12, 16, 33, 255
+CLASS_IN = 1
+CACHE_FLUSH = 0x8000
+UNICAST_RESPONSE = 0x8000  # QU bit in a question
+TTL_HOST = 120
+TTL_SERVICE = 4500
+
+HEADER = struct.Struct(">HHHHHH")
+
+
+def encode_name(name):
+    out = b""
+    for label in name.rstrip(".").split("."):
+        raw = label.encode("utf-8")[:63]
+        out += bytes([len(raw)]) + raw
+    return out + b"\x00"
+
+
+def decode_name(data, pos):
+    """Returns (name, position after the name); follows compression pointers."""
+    labels = []
+    end = None
+    for _ in range(64):  # bounded, malformed packets must not loop
+        length = data[pos]
+        if length & 0xC0 == 0xC0:
+            if end is None:
+                end = pos + 2
+            pos = ((length & 0x3F) << 8) | data[pos + 1]
+            continue
+        pos += 1
+        if length == 0:
+            break
+        labels.append(data[pos:pos + length].decode("utf-8", "replace"))
+        pos += length
+    return ".".join(labels), end if end is not None else pos
+
+
+def record(name, rtype, rclass, ttl, rdata):
+    return encode_name(name) + struct.pack(">HHIH", rtype, rclass, ttl, len(rdata)) + rdata
+
+
+def local_address_for(peer):
+    """Address of the interface that routes to peer (no packet is sent)."""
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        try:
+            s.connect((peer, MDNS_PORT))
+            return s.getsockname()[0]
+        except OSError:
+            return "127.0.0.1"
+
+
+class Responder:
+    """Answers queries for the bridge service until stop() is called."""
+
+    def __init__(self, udp_port, ws_port, instance=None):
+        host = socket.gethostname().split(".")[0] or "pc"
+        self.host = "tsw-bridge-%s.local" % host.lower()
+        self.instance = "%s.%s" % (instance or "TSW Bridge on %s" % host, SERVICE)
+        self.udp_port = udp_port
+        self.ws_port = ws_port
+        self.queries = 0
+        self.answers = 0
+        self.sock = None
+        self.running = False
+
+    # --- records ---
+    def records(self, wanted, address, ttl_cap=None):
+        """(answers, additionals) for a set of (name, type) questions."""
+        def ttl(t):
+            return min(t, ttl_cap) if ttl_cap else t
+
+        txt = b"".join(bytes([len(s)]) + s for s in
+                       (b"udp=%d" % self.udp_port, b"ws=%d" % self.ws_port))
+        srv = struct.pack(">HHH", 0, 0, self.udp_port) + encode_name(self.host)
+        a = socket.inet_aton(address)
+        flush = 0 if ttl_cap else CACHE_FLUSH  # no cache-flush in legacy unicast replies
+
+        ptr_rr = record(SERVICE, T_PTR, CLASS_IN, ttl(TTL_SERVICE), encode_name(self.instance))
+        srv_rr = record(self.instance, T_SRV, CLASS_IN | flush, ttl(TTL_HOST), srv)
+        txt_rr = record(self.instance, T_TXT, CLASS_IN | flush, ttl(TTL_SERVICE), txt)
+        a_rr = record(self.host, T_A, CLASS_IN | flush, ttl(TTL_HOST), a)
+        meta_rr = record(META, T_PTR, CLASS_IN, ttl(TTL_SERVICE), encode_name(SERVICE))
+
+        answers, extra = [], []
+        for name, qtype in wanted:
+            name = name.lower()
+            if name == SERVICE.lower() and qtype in (T_PTR, T_ANY):
+                answers.append(ptr_rr)
+                extra += [srv_rr, txt_rr, a_rr]
+            elif name == self.instance.lower() and qtype in (T_SRV, T_TXT, T_ANY):
+                answers += [srv_rr] if qtype == T_SRV else [txt_rr] if qtype == T_TXT else [srv_rr, txt_rr]
+                extra.append(a_rr)
+            elif name == self.host.lower() and qtype in (T_A, T_ANY):
+                answers.append(a_rr)
+            elif name == META.lower() and qtype in (T_PTR, T_ANY):
+                answers.append(meta_rr)
+        extra = [r for i, r in enumerate(extra) if r not in answers and r not in extra[:i]]
+        return answers, extra
+
+    @staticmethod
+    def message(msg_id, answers, extra, questions=b"", qdcount=0):
+        return HEADER.pack(msg_id, 0x8400, qdcount, len(answers), 0, len(extra)) + questions + \
+            b"".join(answers) + b"".join(extra)
+
+    # --- socket ---
+    def start(self):
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if hasattr(socket, "SO_REUSEPORT"):
+            try:
+                s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+            except OSError:
+                pass
+        s.bind(("", MDNS_PORT))
+        s.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP,
+                     socket.inet_aton(MDNS_ADDR) + socket.inet_aton("0.0.0.0"))
+        s.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 255)
+        self.sock = s
+        self.running = True
+        threading.Thread(target=self._run, daemon=True).start()
+        threading.Thread(target=self._announce, daemon=True).start()
+
+    def stop(self):
+        self.running = False
+        if self.sock:
+            self.sock.close()
+
+    def _announce(self):
+        # unsolicited responses, so caches of already running devices learn the address
+        for delay in (0.0, 1.0, 2.0):
+            time.sleep(delay)
+            if not self.running:
+                return
+            answers, extra = self.records([(SERVICE, T_PTR)], local_address_for(MDNS_ADDR))
+            try:
+                self.sock.sendto(self.message(0, answers, extra), (MDNS_ADDR, MDNS_PORT))
+            except OSError:
+                return
+
+    def _run(self):
+        while self.running:
+            try:
+                data, (peer, port) = self.sock.recvfrom(9000)
+            except OSError:
+                return
+            try:
+                self.handle(data, peer, port)
+            except (IndexError, struct.error, UnicodeError):
+                pass  # malformed packet
+
+    def handle(self, data, peer, port):
+        msg_id, flags, qdcount, _, _, _ = HEADER.unpack_from(data)
+        if flags & 0x8000:
+            return  # a response, not a query
+        pos = HEADER.size
+        wanted = []
+        unicast = port != MDNS_PORT  # legacy unicast resolver (e.g. dig)
+        for _ in range(qdcount):
+            start = pos
+            name, pos = decode_name(data, pos)
+            qtype, qclass = struct.unpack_from(">HH", data, pos)
+            pos += 4
+            wanted.append((name, qtype, data[start:pos]))
+            if qclass & UNICAST_RESPONSE:
+                unicast = True
+        self.queries += 1
+
+        address = local_address_for(peer)
+        legacy = port != MDNS_PORT
+        answers, extra = self.records([(n, t) for n, t, _ in wanted], address, 10 if legacy else None)
+        if not answers:
+            return
+        if legacy:
+            # echo id and questions, as a regular DNS server would
+            reply = self.message(msg_id, answers, extra, b"".join(q for _, _, q in wanted), len(wanted))
+        else:
+            reply = self.message(0, answers, extra)
+        self.sock.sendto(reply, (peer, port) if unicast else (MDNS_ADDR, MDNS_PORT))
+        self.answers += 1
+
+
+def query(timeout=2.0):
+    """Browses for bridges; returns [(instance, address, udp port)]."""
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.settimeout(0.2)
+    s.sendto(HEADER.pack(0x5453, 0, 1, 0, 0, 0) + encode_name(SERVICE) + struct.pack(">HH", T_PTR, CLASS_IN),
+             (MDNS_ADDR, MDNS_PORT))
+    found = {}
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            data, _ = s.recvfrom(9000)
+        except socket.timeout:
+            continue
+        _, _, qd, an, ns, ar = HEADER.unpack_from(data)
+        pos = HEADER.size
+        for _ in range(qd):
+            _, pos = decode_name(data, pos)
+            pos += 4
+        srv, addr = {}, {}
+        for _ in range(an + ns + ar):
+            name, pos = decode_name(data, pos)
+            rtype, _, _, length = struct.unpack_from(">HHIH", data, pos)
+            pos += 10
+            if rtype == T_SRV:
+                srv[name] = (struct.unpack_from(">H", data, pos + 4)[0], decode_name(data, pos + 6)[0])
+            elif rtype == T_A:
+                addr[name] = socket.inet_ntoa(data[pos:pos + 4])
+            pos += length
+        for name, (port, target) in srv.items():
+            if target in addr:
+                found[name] = (name, addr[target], port)
+    s.close()
+    return list(found.values())
+
+
+if __name__ == "__main__":
+    import argparse
+    ap = argparse.ArgumentParser(description="Look for TSW bridges on the LAN via mDNS")
+    ap.add_argument("--query", action="store_true", help="browse (default)")
+    ap.add_argument("--timeout", type=float, default=2.0)
+    args = ap.parse_args()
+    results = query(args.timeout)
+    for instance, address, port in results:
+        print("%s  %s:%d" % (instance, address, port))
+    if not results:
+        print("no bridge found")
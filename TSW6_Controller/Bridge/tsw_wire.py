@@ -0,0 +1,205 @@
+# tsw_wire.py
+# -------------------------------------------------------------
+#   Binary message format between controller and bridge.
+#   Mirror of src/TSW_Controls/TSWWire.h - keep both in sync.
+# -------------------------------------------------------------
+#
+#   0  u8   magic 'T'
+#   1  u8   type
+#   2  u16  session   random per boot of the controller
+#   4  u16  seq       per session, wraps around
+#   6  u32  timeUs    sender clock, echoed in replies
+#  10  ...  payload   (see TSWWire.h)
+#
+# All fields little endian, values are thousandths (i32).
+#
+# On byte streams (UART) each message is a SLIP frame with a
+# CRC-16/CCITT appended: END, escaped(message + crc), END.
+
+import binascii
+import struct
+
+MAGIC = 0x54
+HEADER = struct.Struct("<BBHHI")
+ITEM = struct.Struct("<Bi")
+
+SET = 0x01
+BIND = 0x02
+GET = 0x03
+SUBSCRIBE = 0x04
+ACK = 0x81
+UNKNOWN = 0x82
+VALUE = 0x83
+UPDATE = 0x84
+
+UPDATE_MAX = 8  # items per UPDATE message (TSW_WIRE_UPDATE_MAX)
+
+
+class Message:
+    __slots__ = ("type", "session", "seq", "time_us", "payload")
+
+    def __init__(self, type, session, seq, time_us, payload=b""):
+        self.type = type
+        self.session = session
+        self.seq = seq
+        self.time_us = time_us
+        self.payload = payload
+
+
+def seq_newer(a, b):
+    """True if sequence number a was sent after b (wrap-around safe)."""
+    d = (a - b) & 0xFFFF
+    return 0 < d < 0x8000
+
+
+QUANT_MAX = 2147483000  # TSWWire::quantize() clamps to this
+
+
+def quantize(value):
+    """Thousandths, rounded half away from zero and clamped like TSWWire::quantize()."""
+    milli = value * 1000
+    if milli > QUANT_MAX:
+        return QUANT_MAX
+    if milli < -QUANT_MAX:
+        return -QUANT_MAX
+    return int(milli - 0.5) if milli < 0 else int(milli + 0.5)
+
+
+def dequantize(milli):
+    return milli / 1000.0
+
+
+# --- Encoding ---
+def encode(type, session, seq, time_us, payload=b""):
+    return HEADER.pack(MAGIC, type, session & 0xFFFF, seq & 0xFFFF, time_us & 0xFFFFFFFF) + payload
+
+
+def encode_set(session, seq, time_us, items):
+    """items: iterable of (id, value as float)"""
+    items = list(items)
+    body = bytes([len(items)]) + b"".join(ITEM.pack(i, quantize(v)) for i, v in items)
+    return encode(SET, session, seq, time_us, body)
+
+
+def encode_bind(session, seq, time_us, id, name):
+    raw = name.encode()[:47]
+    return encode(BIND, session, seq, time_us, bytes([id, len(raw)]) + raw)
+
+
+def encode_get(session, seq, time_us, id):
+    return encode(GET, session, seq, time_us, bytes([id]))
+
+
+def encode_subscribe(session, seq, time_us, interval_ms, ids):
+    ids = bytes(ids)
+    return encode(SUBSCRIBE, session, seq, time_us, struct.pack("<HB", interval_ms, len(ids)) + ids)
+
+
+def encode_update(session, seq, time_us, items):
+    """items: iterable of (id, value as float); unsolicited, not a reply"""
+    items = list(items)
+    body = bytes([len(items)]) + b"".join(ITEM.pack(i, quantize(v)) for i, v in items)
+    return encode(UPDATE, session, seq, time_us, body)
+
+
+def reply(msg, type, payload):
+    """Reply to msg: same session, seq and timeUs, so the sender can match it."""
+    return encode(type, msg.session, msg.seq, msg.time_us, payload)
+
+
+def encode_ack(msg, accepted, stale, failed):
+    return reply(msg, ACK, bytes([min(accepted, 255), min(stale, 255), min(failed, 255)]))
+
+
+def encode_unknown(msg, id):
+    return reply(msg, UNKNOWN, bytes([id]))
+
+
+def encode_value(msg, id, value):
+    return reply(msg, VALUE, ITEM.pack(id, quantize(value)))
+
+
+# --- Decoding ---
+def decode(data):
+    """Returns a Message or None for anything that is not a valid message."""
+    if len(data) < HEADER.size or data[0] != MAGIC:
+        return None
+    _, type, session, seq, time_us = HEADER.unpack_from(data)
+    return Message(type, session, seq, time_us, bytes(data[HEADER.size:]))
+
+
+def decode_set(payload):
+    """-> list of (id, value as float); truncated items are dropped"""
+    if not payload:
+        return []
+    count = min(payload[0], (len(payload) - 1) // ITEM.size)
+    return [(i, dequantize(v)) for i, v in
+            (ITEM.unpack_from(payload, 1 + n * ITEM.size) for n in range(count))]
+
+
+def decode_subscribe(payload):
+    """-> (interval_ms, [ids]) or None"""
+    if len(payload) < 3:
+        return None
+    interval, count = struct.unpack_from("<HB", payload)
+    return interval, list(payload[3:3 + count])
+
+
+# UPDATE has the same layout as SET
+decode_update = decode_set
+
+
+def decode_bind(payload):
+    """-> (id, name) or None"""
+    if len(payload) < 2 or len(payload) < 2 + payload[1]:
+        return None
+    return payload[0], payload[2:2 + payload[1]].decode(errors="replace")
+
+
+# --- SLIP framing for byte streams ---
+SLIP_END = 0xC0
+SLIP_ESC = 0xDB
+SLIP_ESC_END = 0xDC
+SLIP_ESC_ESC = 0xDD
+
+
+def crc16(data):
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def slip_encode(msg):
+    raw = msg + struct.pack("<H", crc16(msg))
+    raw = raw.replace(b"\xdb", b"\xdb\xdd").replace(b"\xc0", b"\xdb\xdc")
+    return b"\xc0" + raw + b"\xc0"
+
+
+class SlipDecoder:
+    """Splits a byte stream into messages and other bytes (e.g. log text)."""
+
+    def __init__(self, max_len=512):
+        self.max_len = max_len
+        self.buf = bytearray()
+        self.frames = 0
+        self.bad_frames = 0
+
+    def feed(self, data):
+        """-> list of (True, message) for valid frames, (False, raw bytes) for anything else"""
+        out = []
+        for c in data:
+            if c != SLIP_END:
+                if len(self.buf) < self.max_len:
+                    self.buf.append(c)
+                continue
+            if not self.buf:
+                continue
+            raw = bytes(self.buf)
+            self.buf.clear()
+            frame = raw.replace(b"\xdb\xdc", b"\xc0").replace(b"\xdb\xdd", b"\xdb")
+            if len(frame) >= 3 and crc16(frame[:-2]) == struct.unpack("<H", frame[-2:])[0]:
+                self.frames += 1
+                out.append((True, frame[:-2]))
+            else:
+                if not raw.isascii():
+                    self.bad_frames += 1
+                out.append((False, raw))
+        return out
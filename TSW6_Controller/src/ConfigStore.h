@@ -9,6 +9,7 @@ struct Config
   char pass[64];
   char apiKey[64];
   bool apModePreferred; // true = Access Point, false = Client (STA)
+  char tswHost[40];     // zuletzt gefundene Adresse des TSW-Hosts (mDNS), leer = unbekannt
 };
 
 Config cfg;
@@ -45,6 +46,10 @@ bool loadConfig()
     if (mode.length())
       cfg.apModePreferred = (mode.toInt() == 1);
   }
+
+  // 5. Zeile: gecachte TSW-Host-Adresse (optional, ältere Dateien haben sie nicht)
+  if (f.available())
+    readLineToBuf(f, cfg.tswHost, sizeof(cfg.tswHost));
   f.close();
   return true;
 }
@@ -60,5 +65,6 @@ void saveConfig()
   f.println(cfg.pass);
   f.println(cfg.apiKey);
   f.println(cfg.apModePreferred ? "1" : "0");
+  f.println(cfg.tswHost);
   f.close();
 }
@@ -11,10 +11,9 @@
 #include <cmath> // for fabs
 
 // --- Constructor ---
-TSWButton::TSWButton(uint8_t pin, const String &ctrl, TSWSpider *s)
+TSWButton::TSWButton(uint8_t pin, const String &ctrl, TSWTransport *s)
     : Button(ctrl + "_HW", pin), // new Control-compatible ctor
-      TSWControl(ctrl, s),
-      lastSentValue(-1.0f)
+      TSWControl(ctrl, s)
 {
 
   // --- Default notch table for binary buttons ---
@@ -30,19 +29,31 @@ void TSWButton::loadNotches(const String &filePath)
 }
 
 // --- Update & send mapped value ---
+bool TSWButton::update()
+{
+  if (!Button::update()) // press or release
+    return false;
+
+  sendValueToTSW(mapState(isPressed()));
+  return true;
+}
+
 void TSWButton::updateAndSend()
 {
-  int event = update(); // +1 pressed / -1 released
-  if (event == 0)
-    return;
+  update();
+}
+
+// --- Startup sync: debounced state as read by begin() ---
+bool TSWButton::sampleTSWValue(float &value)
+{
+  begin();
+  value = mapState(isPressed());
+  return true;
+}
 
-  float value = isPressed() ? 1.0f : 0.0f;
+float TSWButton::mapState(bool pressed)
+{
   if (notches.hasPositions())
-    value = notches.mapToTSW(isPressed() ? 100 : 0);
-
-  if (fabs(value - lastSentValue) > 0.001f)
-  {
-    spider->setControllerValue(controllerName, value);
-    lastSentValue = value;
-  }
+    return notches.mapToTSW(pressed ? 100 : 0);
+  return pressed ? 1.0f : 0.0f;
 }
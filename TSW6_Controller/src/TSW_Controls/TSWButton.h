@@ -21,7 +21,7 @@
  * @date
  *   2025-10-28
  * @version
- *   2.0
+ *   2.1
  */
 
 #pragma once
@@ -30,12 +30,14 @@
 
 class TSWButton : public Button, public TSWControl
 {
-private:
-  float lastSentValue;
-
 public:
-  TSWButton(uint8_t pin, const String &ctrl, TSWSpider *s);
+  TSWButton(uint8_t pin, const String &ctrl, TSWTransport *s);
 
   void loadNotches(const String &filePath);
+  bool update() override; // debounces and sends a change (loop stage)
   void updateAndSend();
+  bool sampleTSWValue(float &value) override;
+
+private:
+  float mapState(bool pressed);
 };
@@ -1,25 +1,41 @@
 #include "../config.h"
 #include "../controls/Control.h"
 #include "../repo/controlsRepo.h"
+#include "../repo/controlBank.h"
 
 #if USE_BUTTON
 
 #include "TSWButton.h"
 
+#ifndef BUTTON_IDS
+#define BUTTON_IDS {"btnRed"}
+#endif
+
+// one button per entry; pins and ids line up by position
 static constexpr uint8_t BUTTON_PINS[] = PIN_BUTTONS;
+static constexpr const char *BUTTON_NAMES[] = BUTTON_IDS;
+static constexpr size_t BUTTON_COUNT = sizeof(BUTTON_PINS) / sizeof(BUTTON_PINS[0]);
+static_assert(sizeof(BUTTON_NAMES) / sizeof(BUTTON_NAMES[0]) == BUTTON_COUNT,
+              "BUTTON_IDS needs one entry per PIN_BUTTONS pin");
+
+CONTROL_TRAITS(Button, CONTROL_KIND_BUTTON);
+static ControlBank<Button, BUTTON_COUNT> buttons;
 
-inline void setup_Buttons(TSWSpider *spider)
+inline void setup_Buttons(TSWTransport *spider)
 {
-  if (sizeof(BUTTON_PINS) / sizeof(uint8_t) == 0)
-    return;
-  int i = 0;
-  static Button btn1("btnRed", BUTTON_PINS[i]);
-  ControlRegistry::registerControl(&btn1, "Button");
-  i++;
+  for (size_t i = 0; i < BUTTON_COUNT; ++i)
+  {
+    Button *btn = buttons.emplace(BUTTON_NAMES[i], BUTTON_PINS[i]);
+    if (!btn)
+      break;
+    ControlRegistry::registerControl(btn);
+  }
 }
 
 #define SETUP_BUTTONS(spiderPtr) setup_Buttons(spiderPtr)
+#define POLL_BUTTONS() buttons.poll()
 
 #else
 #define SETUP_BUTTONS(...)
+#define POLL_BUTTONS()
 #endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+/**
+ * @file TSWCircuitBreaker.cpp
+ * @brief Implementation of the TSW host circuit breaker.
+ *
+ * @details
+ * Transitions are logged once each, so a PC that is switched off for an
+ * hour produces one line per probe instead of one per request.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSWCircuitBreaker.h"
+
+bool TSWCircuitBreaker::allow()
+{
+  uint32_t now = millis();
+  bool probe = false;
+  bool ok;
+
+  portENTER_CRITICAL(&mux);
+  switch (stats.state)
+  {
+  case CLOSED:
+    ok = true;
+    break;
+  case OPEN:
+    ok = (int32_t)(now - nextProbeMs) >= 0;
+    if (ok)
+    {
+      stats.state = HALF_OPEN; // this caller is the probe, everyone else keeps failing fast
+      stats.probes++;
+      probe = true;
+    }
+    else
+      stats.rejected++;
+    break;
+  default: // HALF_OPEN, probe still running
+    ok = false;
+    stats.rejected++;
+    break;
+  }
+  portEXIT_CRITICAL(&mux);
+
+  if (probe)
+    TRACE_PRINT("[Breaker] half-open, probing TSW host\n");
+  return ok;
+}
+
+void TSWCircuitBreaker::success()
+{
+  bool recovered = false;
+  portENTER_CRITICAL(&mux);
+  failures = 0;
+  if (stats.state != CLOSED)
+  {
+    stats.state = CLOSED;
+    stats.closed++;
+    stats.probeIntervalMs = TSW_BREAKER_PROBE_MIN_MS;
+    recovered = true;
+  }
+  portEXIT_CRITICAL(&mux);
+
+  if (recovered)
+    Serial.printf("[Breaker] TSW host reachable again, circuit closed\n");
+}
+
+void TSWCircuitBreaker::failure()
+{
+  uint32_t now = millis();
+  bool opened = false;
+  bool reopened = false;
+
+  portENTER_CRITICAL(&mux);
+  if (stats.state == HALF_OPEN)
+  {
+    // probe failed: back off further
+    stats.probeIntervalMs = stats.probeIntervalMs * 2 > TSW_BREAKER_PROBE_MAX_MS
+                                ? TSW_BREAKER_PROBE_MAX_MS
+                                : stats.probeIntervalMs * 2;
+    stats.reopened++;
+    open(now);
+    reopened = true;
+  }
+  else if (stats.state == CLOSED && ++failures >= TSW_BREAKER_FAILURES)
+  {
+    stats.opened++;
+    stats.openSinceMs = now;
+    open(now);
+    opened = true;
+  }
+  portEXIT_CRITICAL(&mux);
+
+  if (opened)
+    Serial.printf("[Breaker] TSW host unreachable, circuit open (probe every %u ms)\n",
+                  (unsigned)stats.probeIntervalMs);
+  else if (reopened)
+    TRACE_PRINT("[Breaker] probe failed, next in %u ms\n", (unsigned)stats.probeIntervalMs);
+}
+
+// caller holds mux
+void TSWCircuitBreaker::open(uint32_t now)
+{
+  stats.state = OPEN;
+  failures = 0;
+  nextProbeMs = now + stats.probeIntervalMs;
+}
+
+TSWCircuitBreaker::Stats TSWCircuitBreaker::getStats()
+{
+  portENTER_CRITICAL(&mux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&mux);
+  return copy;
+}
+
+const char *TSWCircuitBreaker::stateName(State state)
+{
+  switch (state)
+  {
+  case CLOSED:
+    return "closed";
+  case OPEN:
+    return "open";
+  default:
+    return "half-open";
+  }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file TSWCircuitBreaker.h
+ * @brief Health state of the TSW host, so an unreachable PC fails fast.
+ *
+ * @details
+ * While the game PC reboots or the port proxy is down, every request would
+ * wait out its connect timeout. The breaker counts consecutive transport
+ * failures (no connection, no response; HTTP error codes count as success,
+ * the host answered) and switches between three states:
+ *
+ *   - CLOSED     normal operation, every request goes out
+ *   - OPEN       after TSW_BREAKER_FAILURES failures in a row; allow()
+ *                answers false in O(1) without touching the network
+ *   - HALF_OPEN  the probe time has come: exactly one request is let
+ *                through. Success closes the circuit, failure opens it
+ *                again with the probe interval doubled (up to
+ *                TSW_BREAKER_PROBE_MAX_MS)
+ *
+ * Every allow() that returned true must be followed by success() or
+ * failure(). All methods are safe to call from loop() and the send task.
+ *
+ * Example:
+ * @code
+ *   if (!breaker.allow())
+ *     return TSW_STATUS_CIRCUIT_OPEN;
+ *   bool ok = doRequest();
+ *   ok ? breaker.success() : breaker.failure();
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "../config.h"
+
+#ifndef TSW_BREAKER_FAILURES
+#define TSW_BREAKER_FAILURES 3
+#endif
+#ifndef TSW_BREAKER_PROBE_MIN_MS
+#define TSW_BREAKER_PROBE_MIN_MS 500
+#endif
+#ifndef TSW_BREAKER_PROBE_MAX_MS
+#define TSW_BREAKER_PROBE_MAX_MS 10000
+#endif
+
+class TSWCircuitBreaker
+{
+public:
+  enum State : uint8_t
+  {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+  struct Stats
+  {
+    State state = CLOSED;
+    uint32_t opened = 0;        // CLOSED -> OPEN
+    uint32_t reopened = 0;      // HALF_OPEN -> OPEN (probe failed)
+    uint32_t probes = 0;        // OPEN -> HALF_OPEN
+    uint32_t closed = 0;        // HALF_OPEN -> CLOSED (host is back)
+    uint32_t rejected = 0;      // requests refused while open
+    uint32_t probeIntervalMs = TSW_BREAKER_PROBE_MIN_MS;
+    uint32_t openSinceMs = 0;   // millis() of the last CLOSED -> OPEN
+  };
+
+private:
+  Stats stats;
+  uint8_t failures = 0;        // consecutive, while CLOSED
+  uint32_t nextProbeMs = 0;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  void open(uint32_t now);
+
+public:
+  bool allow();
+  void success();
+  void failure();
+
+  State getState() const { return stats.state; }
+  Stats getStats();
+  static const char *stateName(State state);
+};
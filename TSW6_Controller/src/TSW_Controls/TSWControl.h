@@ -4,44 +4,103 @@
  *
  * @details
  * Provides shared functionality for TSWLever, TSWButton, and TSWRotaryKnob.
- * Handles communication with TSWSpider and NotchTable mapping.
+ * Handles communication with a TSWTransport (TSWSpider directly or the
+ * asynchronous TSWSendQueue) and NotchTable mapping.
  *
  * Derived classes must implement:
  *   - void updateAndSend();
  *
+ * Controls with an absolute position (levers, buttons) also implement
+ * sampleTSWValue(), which TSWStartupSync uses to send every initial value in
+ * one batch at boot instead of one request per control on its first update.
+ *
+ * Every control has a priority lane. Controllers listed in
+ * TSW_PRIORITY_CONTROLLERS (emergency brake, Sifa, horn ...) start in the
+ * high lane, setPriority() changes it at setup.
+ *
+ * Composite controls that send several controllers of their own (e.g.
+ * TSWGamePadControl) use the protected constructor with bind = false: their
+ * id is no controller, so nothing is bound or prioritised for it.
+ *
  * @author Felix Lindemann
  * @date 2025-10-27
- * @version 1.0
+ * @version 1.5
  */
 
 #pragma once
 #include <Arduino.h>
 #include "NotchTable.h"
-#include "TSWSpider.h"
+#include "TSWTransport.h"
 #include "../config.h"
 
+#ifndef TSW_PRIORITY_CONTROLLERS
+#define TSW_PRIORITY_CONTROLLERS "" // comma-separated controller names of the high lane
+#endif
+
+// true if name is one of the comma-separated names in list
+inline bool tswNameInList(const char* name, const char* list) {
+  size_t len = strlen(name);
+  while (*list) {
+    const char* end = strchr(list, ',');
+    size_t n = end ? (size_t)(end - list) : strlen(list);
+    if (n == len && strncmp(list, name, len) == 0) return true;
+    if (!end) break;
+    list = end + 1;
+  }
+  return false;
+}
+
 class TSWControl {
 protected:
   String controllerName;
   NotchTable notches;
-  TSWSpider* spider;
+  TSWTransport* spider;
   float lastSentValue;
+  TSWPriority priority = TSW_PRIORITY_BULK;
 
 public:
-  TSWControl(const String& ctrl, TSWSpider* s)
-      : controllerName(ctrl), spider(s), lastSentValue(-999.0f) {}
+  TSWControl(const String& ctrl, TSWTransport* s) : TSWControl(ctrl, s, true) {}
 
   virtual ~TSWControl() = default;
 
+protected:
+  TSWControl(const String& id, TSWTransport* s, bool bind)
+      : controllerName(id), spider(s), lastSentValue(-999.0f) {
+    if (bind && spider) spider->bindController(controllerName);
+    if (bind && tswNameInList(controllerName.c_str(), TSW_PRIORITY_CONTROLLERS))
+      setPriority(TSW_PRIORITY_HIGH);
+  }
+
+public:
+
   void loadNotches(const String& filePath) { notches.loadFromFile(filePath); }
   const String& getControllerName() const { return controllerName; }
 
+  void setPriority(TSWPriority p) {
+    priority = p;
+    if (spider) spider->setPriority(controllerName, p);
+  }
+  TSWPriority getPriority() const { return priority; }
+
+  // Reads the hardware once (re-initialising its change detection) and maps
+  // the position like updateAndSend() would. false if the control has no
+  // absolute position, e.g. a rotary encoder.
+  virtual bool sampleTSWValue(float& value) { return false; }
+
+  // value is in the game already (startup sync, or unchanged since before a
+  // warm restart)
+  void markSent(float value) { lastSentValue = value; }
+
 protected:
-  void sendValueToTSW(float tswValue) {
-    if (!spider) return;
-    if (fabs(tswValue - lastSentValue) > 0.001f) {
-      spider->setControllerValue(controllerName, tswValue);
+  // returns true if the value differed from the last one and was handed on;
+  // a rejected value (e.g. queue full) is retried on the next change
+  bool sendValueToTSW(float tswValue) {
+    if (!spider) return false;
+    if (fabs(tswValue - lastSentValue) > 0.001f &&
+        spider->setControllerValue(controllerName, tswValue)) {
       lastSentValue = tswValue;
+      return true;
     }
+    return false;
   }
 };
@@ -0,0 +1,196 @@
+/**
+ * @file TSWDiscovery.cpp
+ * @brief Implementation of the mDNS based TSW host discovery.
+ *
+ * @details
+ * A probe is a plain TCP connect that is closed right away. If several
+ * instances of the service answer, the first one that accepts the probe
+ * wins. When nothing is found, a cached address is preferred over the
+ * compile-time fallback: the PC may just not be up yet, and the background
+ * task keeps looking.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSWDiscovery.h"
+#include <ESPmDNS.h>
+#include <WiFi.h>
+
+String TSWDiscovery::begin(const char *svc, const char *prt, const char *cached,
+                           const char *fb, uint16_t port, ChangeHandler handler)
+{
+  service = svc;
+  proto = prt;
+  fallback = fb;
+  probePort = port;
+  onChange = handler;
+  bool haveCache = cached && cached[0];
+
+  // fast path: the address of the last run still answers
+  if (haveCache && probe(cached))
+  {
+    setHost(cached, CACHE);
+    Serial.printf("[Discovery] Cached TSW host %s answers, discovery skipped\n", cached);
+    return getHost();
+  }
+
+  char found[TSW_HOST_LEN];
+  Source source = discover(found);
+  if (source == NONE)
+  {
+    const char *use = haveCache ? cached : fallback;
+    setHost(use, haveCache ? CACHE : FALLBACK);
+    Serial.printf("[Discovery] No TSW host found via mDNS, using %s %s\n",
+                  haveCache ? "cached" : "fallback", use);
+    return getHost();
+  }
+
+  setHost(found, source);
+  Serial.printf("[Discovery] TSW host %s found (%s, %u ms)\n", found, sourceName(source),
+                (unsigned)stats.lastDiscoveryMs);
+  if (onChange && (!haveCache || strcmp(cached, found) != 0))
+    onChange(found);
+  return getHost();
+}
+
+bool TSWDiscovery::probe(const char *address)
+{
+  WiFiClient client;
+  bool ok = client.connect(address, probePort, TSW_CONNECT_TIMEOUT_MS);
+  client.stop();
+
+  portENTER_CRITICAL(&mux);
+  stats.probes++;
+  if (!ok)
+    stats.probeFailures++;
+  portEXIT_CRITICAL(&mux);
+  return ok;
+}
+
+TSWDiscovery::Source TSWDiscovery::discover(char *out)
+{
+  uint32_t start = millis();
+  Source source = NONE;
+
+  int n = MDNS.queryService(service, proto);
+  for (int i = 0; i < n && source == NONE; i++)
+  {
+    String ip = MDNS.IP(i).toString();
+    if (i == n - 1 || probe(ip.c_str())) // last candidate is taken untested
+    {
+      strncpy(out, ip.c_str(), TSW_HOST_LEN - 1);
+      out[TSW_HOST_LEN - 1] = '\0';
+      source = SERVICE;
+    }
+  }
+
+  if (source == NONE && TSW_MDNS_HOSTNAME[0])
+  {
+    IPAddress ip = MDNS.queryHost(TSW_MDNS_HOSTNAME, TSW_DISCOVERY_TIMEOUT_MS);
+    if ((uint32_t)ip != 0)
+    {
+      strncpy(out, ip.toString().c_str(), TSW_HOST_LEN - 1);
+      out[TSW_HOST_LEN - 1] = '\0';
+      source = HOSTNAME;
+    }
+  }
+
+  portENTER_CRITICAL(&mux);
+  stats.discoveries++;
+  stats.lastDiscoveryMs = millis() - start;
+  portEXIT_CRITICAL(&mux);
+  return source;
+}
+
+void TSWDiscovery::setHost(const char *address, Source source)
+{
+  portENTER_CRITICAL(&mux);
+  strncpy(host, address, sizeof(host) - 1);
+  host[sizeof(host) - 1] = '\0';
+  stats.source = source;
+  portEXIT_CRITICAL(&mux);
+}
+
+String TSWDiscovery::getHost()
+{
+  char copy[TSW_HOST_LEN];
+  portENTER_CRITICAL(&mux);
+  memcpy(copy, host, sizeof(copy));
+  portEXIT_CRITICAL(&mux);
+  return String(copy);
+}
+
+TSWDiscovery::Stats TSWDiscovery::getStats()
+{
+  portENTER_CRITICAL(&mux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&mux);
+  return copy;
+}
+
+const char *TSWDiscovery::sourceName(Source source)
+{
+  switch (source)
+  {
+  case CACHE:
+    return "cache";
+  case SERVICE:
+    return "mDNS service";
+  case HOSTNAME:
+    return "mDNS hostname";
+  case FALLBACK:
+    return "fallback";
+  default:
+    return "none";
+  }
+}
+
+// --- Background revalidation ---
+bool TSWDiscovery::startRevalidation()
+{
+  if (task)
+    return true;
+  // mDNS queries block for seconds: own task, lowest priority, next to the WiFi stack
+  if (xTaskCreatePinnedToCore(taskEntry, "tswDiscovery", 4096, this, 1, &task, 0) != pdPASS)
+  {
+    Serial.println("[Discovery] Failed to start revalidation task");
+    task = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void TSWDiscovery::taskEntry(void *arg)
+{
+  static_cast<TSWDiscovery *>(arg)->run();
+}
+
+void TSWDiscovery::run()
+{
+  while (true)
+  {
+    vTaskDelay(pdMS_TO_TICKS(TSW_DISCOVERY_REVALIDATE_MS));
+
+    char current[TSW_HOST_LEN];
+    portENTER_CRITICAL(&mux);
+    memcpy(current, host, sizeof(current));
+    portEXIT_CRITICAL(&mux);
+    if (probe(current))
+      continue;
+
+    char found[TSW_HOST_LEN];
+    Source source = discover(found);
+    if (source == NONE || strcmp(found, current) == 0)
+      continue;
+
+    setHost(found, source);
+    portENTER_CRITICAL(&mux);
+    stats.changes++;
+    portEXIT_CRITICAL(&mux);
+    Serial.printf("[Discovery] TSW host moved: %s -> %s (%s)\n", current, found, sourceName(source));
+    if (onChange)
+      onChange(found);
+  }
+}
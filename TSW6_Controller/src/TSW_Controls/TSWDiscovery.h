@@ -0,0 +1,106 @@
+/**
+ * @file TSWDiscovery.h
+ * @brief Finds the TSW host (port proxy or PC bridge) on the LAN via mDNS.
+ *
+ * @details
+ * begin() resolves the host once at boot, in this order:
+ *   1. the address cached from the last run, if it still accepts a TCP
+ *      connection on the probe port - no discovery, no delay
+ *   2. mDNS service discovery (e.g. "_tsw-bridge._udp", announced by
+ *      tsw_bridge.py, or "_tsw-api._tcp" registered on the game PC)
+ *   3. the optional PC name (Windows answers "<name>.local" itself)
+ *   4. the compile-time fallback address
+ *
+ * Every address that differs from the cached one is reported to the change
+ * handler, which persists it (ConfigStore) and points the transport at it.
+ *
+ * startRevalidation() then starts a low-priority task that probes the
+ * current host every TSW_DISCOVERY_REVALIDATE_MS and runs the discovery
+ * again only when the probe fails (PC got a new DHCP lease, bridge moved).
+ * Name resolution thus never happens on the send path: transports always
+ * get a plain IP address.
+ *
+ * Example:
+ * @code
+ *   String host = discovery.begin("tsw-bridge", "udp", cfg.tswHost,
+ *                                 "192.168.4.2", 31272, onHostChanged);
+ *   transport.begin(host, 31271);
+ *   discovery.startRevalidation();
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "../config.h"
+
+#ifndef TSW_MDNS_HOSTNAME
+#define TSW_MDNS_HOSTNAME "" // PC name without ".local", empty = skip
+#endif
+#ifndef TSW_DISCOVERY_TIMEOUT_MS
+#define TSW_DISCOVERY_TIMEOUT_MS 1500
+#endif
+#ifndef TSW_DISCOVERY_REVALIDATE_MS
+#define TSW_DISCOVERY_REVALIDATE_MS 30000
+#endif
+#ifndef TSW_CONNECT_TIMEOUT_MS
+#define TSW_CONNECT_TIMEOUT_MS 500
+#endif
+#define TSW_HOST_LEN 40
+
+class TSWDiscovery
+{
+public:
+  typedef void (*ChangeHandler)(const char *host);
+
+  enum Source : uint8_t
+  {
+    NONE,
+    CACHE,    // cached address answered the probe
+    SERVICE,  // mDNS service discovery
+    HOSTNAME, // mDNS name of the PC
+    FALLBACK  // compile-time default
+  };
+
+  struct Stats
+  {
+    Source source = NONE;        // where the current address came from
+    uint32_t probes = 0;         // TCP probes of the current host
+    uint32_t probeFailures = 0;
+    uint32_t discoveries = 0;    // mDNS lookups (each may take seconds)
+    uint32_t changes = 0;        // address switched after the boot
+    uint32_t lastDiscoveryMs = 0; // duration of the latest lookup
+  };
+
+private:
+  const char *service = nullptr;
+  const char *proto = nullptr;
+  const char *fallback = nullptr;
+  uint16_t probePort = 0;
+  ChangeHandler onChange = nullptr;
+  char host[TSW_HOST_LEN] = "";
+  TaskHandle_t task = nullptr;
+  Stats stats;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  bool probe(const char *address);
+  Source discover(char *out);
+  void setHost(const char *address, Source source);
+  static void taskEntry(void *arg);
+  void run();
+
+public:
+  // blocking, call once WiFi and mDNS are up; returns the address to use
+  String begin(const char *service, const char *proto, const char *cached,
+               const char *fallback, uint16_t probePort, ChangeHandler onChange);
+  bool startRevalidation();
+
+  String getHost();
+  Stats getStats();
+  static const char *sourceName(Source source);
+};
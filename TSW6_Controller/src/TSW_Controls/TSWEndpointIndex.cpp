@@ -0,0 +1,251 @@
+/**
+ * @file TSWEndpointIndex.cpp
+ * @brief Implementation of the per-loco endpoint index.
+ *
+ * @details
+ * /list is not parsed as a document: the body is scanned for "Name" keys
+ * and their string values are copied into a fixed buffer, so the size of
+ * the answer does not matter. Names are sorted by strcmp and duplicates are
+ * dropped before the table is packed into its final block.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSWEndpointIndex.h"
+#include <LittleFS.h>
+#include <algorithm>
+
+#define TSW_INDEX_MAGIC 0x49575354u // "TSWI"
+
+bool TSWEndpointIndex::begin(TSWSpider *spider)
+{
+  uint32_t start = millis();
+  stats = Stats();
+  uint32_t loco = locoKey(spider);
+  if (loco == 0)
+  {
+    Serial.println("[Index] TSW does not answer, controllers not validated");
+    return false;
+  }
+  stats.loco = loco;
+
+  char path[20];
+  snprintf(path, sizeof(path), "/ep_%08lx.idx", (unsigned long)loco);
+  LittleFS.begin();
+  stats.cached = load(path, loco);
+  if (!stats.cached)
+  {
+    if (!fetch(spider, loco))
+    {
+      Serial.printf("[Index] %s failed, controllers not validated\n", TSW_INDEX_LIST_PATH);
+      return false;
+    }
+    if (!stats.truncated)
+      save(path);
+  }
+
+  // a cached index may predate an update of the loco: ask once more
+  if (stats.cached && validate(spider, false) > 0 && fetch(spider, loco))
+  {
+    stats.cached = false;
+    if (!stats.truncated)
+      save(path);
+  }
+  // a cut index cannot tell a missing name from one beyond the cut, it is
+  // neither stored nor used for flagging
+  if (!stats.truncated)
+    validate(spider, true);
+
+  stats.endpoints = getCount();
+  stats.buildMs = millis() - start;
+  Serial.printf("[Index] %u endpoints (%s, %u bytes, %lu ms), %u of %u controllers unknown\n",
+                stats.endpoints, stats.cached ? "LittleFS" : TSW_INDEX_LIST_PATH, stats.bytes,
+                (unsigned long)stats.buildMs, stats.unknown, stats.checked);
+  return true;
+}
+
+// --- Lookup ---
+int TSWEndpointIndex::idOf(const char *name) const
+{
+  if (!block)
+    return -1;
+  int lo = 0;
+  int hi = header()->count - 1;
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    int cmp = strcmp(names() + offsets()[mid], name);
+    if (cmp == 0)
+      return mid;
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  return -1;
+}
+
+const char *TSWEndpointIndex::nameOf(uint16_t id) const
+{
+  return id < getCount() ? names() + offsets()[id] : nullptr;
+}
+
+uint8_t TSWEndpointIndex::validate(TSWSpider *spider, bool flag)
+{
+  stats.checked = 0;
+  stats.unknown = 0;
+  for (uint8_t i = 0; i < spider->getRouteCount(); i++)
+  {
+    const char *name = spider->getRouteName(i);
+    stats.checked++;
+    if (idOf(name) >= 0)
+      continue;
+    stats.unknown++;
+    if (!flag)
+      continue;
+    spider->setRouteKnown(i, false);
+    Serial.printf("[Index] Controller '%s' is not offered by this loco, its sets are not sent\n", name);
+  }
+  return stats.unknown;
+}
+
+// --- Building ---
+uint32_t TSWEndpointIndex::locoKey(TSWSpider *spider)
+{
+  int code;
+  TSWHttpConnection *conn = spider->beginRequest("GET", TSW_INDEX_LOCO_PATH, code);
+  if (!conn)
+    return 0;
+
+  // the answer names the loco class; without it all locos share one index
+  char body[96];
+  conn->setTimeout(0); // read() waits for data itself and ends with the body
+  size_t n = code == 200 ? conn->readBytes(body, sizeof(body) - 1) : 0;
+  body[n] = '\0';
+  spider->endRequest(conn);
+  uint32_t h = tswHashName(n ? body : "default");
+  return h ? h : 1;
+}
+
+bool TSWEndpointIndex::fetch(TSWSpider *spider, uint32_t loco)
+{
+  int code;
+  TSWHttpConnection *conn = spider->beginRequest("GET", TSW_INDEX_LIST_PATH, code);
+  if (!conn || code != 200)
+  {
+    spider->endRequest(conn);
+    return false;
+  }
+
+  conn->setTimeout(0); // read() waits for data itself and ends with the body
+  char *buf = (char *)malloc(TSW_INDEX_MAX_BYTES);
+  uint16_t *offs = (uint16_t *)malloc(TSW_INDEX_MAX * sizeof(uint16_t));
+  if (!buf || !offs)
+  {
+    spider->endRequest(conn);
+    free(buf);
+    free(offs);
+    return false;
+  }
+
+  uint16_t count = 0;
+  uint16_t used = 0;
+  bool truncated = false;
+  while (conn->find("\"Name\"") && conn->find("\""))
+  {
+    size_t room = TSW_INDEX_MAX_BYTES - used;
+    size_t len = conn->readBytesUntil('"', buf + used, room > 1 ? room - 1 : 0);
+    if (count >= TSW_INDEX_MAX || len + 1 >= room)
+    {
+      truncated = true;
+      break;
+    }
+    buf[used + len] = '\0';
+    offs[count++] = used;
+    used += len + 1;
+  }
+  spider->endRequest(conn);
+  stats.truncated = truncated;
+  if (truncated)
+    Serial.printf("[Index] More than %u endpoints or %u bytes, the rest is ignored\n", TSW_INDEX_MAX,
+                  TSW_INDEX_MAX_BYTES);
+
+  std::sort(offs, offs + count, [buf](uint16_t a, uint16_t b) { return strcmp(buf + a, buf + b) < 0; });
+  uint16_t unique = 0;
+  for (uint16_t i = 0; i < count; i++)
+    if (unique == 0 || strcmp(buf + offs[unique - 1], buf + offs[i]) != 0)
+      offs[unique++] = offs[i];
+
+  // pack header, offsets and names (in sorted order) into one block
+  size_t namesLen = 0;
+  for (uint16_t i = 0; i < unique; i++)
+    namesLen += strlen(buf + offs[i]) + 1;
+  size_t size = sizeof(Header) + unique * sizeof(uint16_t) + namesLen;
+  uint8_t *next = (uint8_t *)malloc(size);
+  if (next)
+  {
+    Header *h = (Header *)next;
+    *h = {TSW_INDEX_MAGIC, loco, unique, (uint16_t)namesLen};
+    uint16_t *o = (uint16_t *)(next + sizeof(Header));
+    char *table = (char *)(o + unique);
+    uint16_t pos = 0;
+    for (uint16_t i = 0; i < unique; i++)
+    {
+      size_t len = strlen(buf + offs[i]) + 1;
+      memcpy(table + pos, buf + offs[i], len);
+      o[i] = pos;
+      pos += len;
+    }
+    free(block);
+    block = next;
+    stats.bytes = size;
+  }
+  free(buf);
+  free(offs);
+  return next != nullptr;
+}
+
+bool TSWEndpointIndex::load(const char *path, uint32_t loco)
+{
+  if (!LittleFS.exists(path))
+    return false;
+  File f = LittleFS.open(path, "r");
+  Header h;
+  if (!f || f.read((uint8_t *)&h, sizeof(h)) != sizeof(h) || h.magic != TSW_INDEX_MAGIC || h.loco != loco ||
+      h.count > TSW_INDEX_MAX || h.namesLen > TSW_INDEX_MAX_BYTES)
+  {
+    f.close();
+    return false;
+  }
+
+  size_t size = sizeof(Header) + h.count * sizeof(uint16_t) + h.namesLen;
+  uint8_t *next = (uint8_t *)malloc(size);
+  bool ok = next && f.size() == size;
+  if (ok)
+  {
+    memcpy(next, &h, sizeof(h));
+    ok = f.read(next + sizeof(h), size - sizeof(h)) == size - sizeof(h);
+  }
+  f.close();
+  if (!ok)
+  {
+    free(next);
+    return false;
+  }
+  free(block);
+  block = next;
+  stats.bytes = size;
+  return true;
+}
+
+bool TSWEndpointIndex::save(const char *path)
+{
+  File f = LittleFS.open(path, "w");
+  if (!f)
+    return false;
+  bool ok = f.write(block, stats.bytes) == stats.bytes;
+  f.close();
+  return ok;
+}
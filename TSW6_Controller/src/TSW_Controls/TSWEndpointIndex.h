@@ -0,0 +1,105 @@
+/**
+ * @file TSWEndpointIndex.h
+ * @brief Sorted table of the controller names the current loco offers (/list).
+ *
+ * @details
+ * Controller names are free-form strings in the setup code and the macro
+ * file; a typo used to show up only as an HTTP 404 on every single set.
+ * begin() loads the endpoint names of the current locomotive once, checks
+ * every controller bound at TSWSpider against them and flags the missing
+ * ones, so their sets are answered 404 locally (TSWSpider::setRouteKnown()).
+ *
+ * The index is built from TSW_INDEX_LIST_PATH once per locomotive and kept
+ * on LittleFS as "/ep_<loco hash>.idx": a header, a table of 16 bit
+ * offsets and the NUL-terminated names, sorted. The file is loaded as one
+ * block and searched binary, nothing is parsed at boot. The loco is told
+ * apart by the answer to TSW_INDEX_LOCO_PATH. A cached index that misses a
+ * bound name is fetched again once, before anything is flagged.
+ *
+ * Every name maps to a small integer id (its position in the sorted table)
+ * that stays the same for the loco as long as the game offers the same
+ * endpoints.
+ *
+ * Without an answer from the game (not started yet), or when /list holds
+ * more names than TSW_INDEX_MAX / TSW_INDEX_MAX_BYTES allow, nothing is
+ * flagged. The scan never holds more than those two buffers, however large
+ * the answer is.
+ *
+ * Example:
+ * @code
+ *   TSWEndpointIndex index;
+ *   index.begin(&spider); // after all controllers are bound
+ *   int id = index.idOf("Throttle"); // -1 if the loco has no such controller
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TSWSpider.h"
+#include "../config.h"
+
+#ifndef TSW_INDEX_LIST_PATH
+#define TSW_INDEX_LIST_PATH "/list"
+#endif
+#ifndef TSW_INDEX_LOCO_PATH
+#define TSW_INDEX_LOCO_PATH "/get/CurrentDrivableActor.ObjectClass"
+#endif
+#ifndef TSW_INDEX_MAX
+#define TSW_INDEX_MAX 512 // endpoints per loco
+#endif
+#ifndef TSW_INDEX_MAX_BYTES
+#define TSW_INDEX_MAX_BYTES 8192 // names per loco, NUL-terminated
+#endif
+
+class TSWEndpointIndex
+{
+public:
+  struct Stats
+  {
+    uint32_t loco = 0;       // hash of the loco answer, names the file
+    uint16_t endpoints = 0;  // names in the index
+    uint16_t bytes = 0;      // size of the table in RAM and on LittleFS
+    bool cached = false;     // loaded from LittleFS, no /list request
+    bool truncated = false;  // /list exceeded TSW_INDEX_MAX(_BYTES), nothing flagged
+    uint8_t checked = 0;     // bound controllers validated
+    uint8_t unknown = 0;     // of those, not offered by the loco
+    uint32_t buildMs = 0;    // load or fetch, sort and save
+  };
+
+private:
+  struct Header
+  {
+    uint32_t magic;
+    uint32_t loco;
+    uint16_t count;
+    uint16_t namesLen;
+  };
+
+  uint8_t *block = nullptr; // Header, uint16_t offsets[count], names
+  Stats stats;
+
+  const Header *header() const { return (const Header *)block; }
+  const uint16_t *offsets() const { return (const uint16_t *)(block + sizeof(Header)); }
+  const char *names() const { return (const char *)(offsets() + header()->count); }
+
+  uint32_t locoKey(TSWSpider *spider);
+  bool load(const char *path, uint32_t loco);
+  bool fetch(TSWSpider *spider, uint32_t loco);
+  bool save(const char *path);
+  uint8_t validate(TSWSpider *spider, bool flag);
+
+public:
+  ~TSWEndpointIndex() { free(block); }
+
+  // loads or builds the index and flags the unknown routes of the spider
+  bool begin(TSWSpider *spider);
+
+  int idOf(const char *name) const;
+  const char *nameOf(uint16_t id) const;
+  uint16_t getCount() const { return block ? header()->count : 0; }
+  const Stats &getStats() const { return stats; }
+};
@@ -15,9 +15,9 @@ TSWGamePadControl::TSWGamePadControl(const String &id,
                                      uint8_t pinX, uint8_t pinY, uint8_t pinButton,
                                      const String &ctrlX, const String &ctrlY,
                                      const String &ctrlBtn,
-                                     TSWSpider *s,
+                                     TSWTransport *s,
                                      unsigned long sendInt)
-    : TSWControl(id, s),
+    : TSWControl(id, s, false), // the pad id is no controller, only X, Y and button are bound
       gamepad(id + "_HW", pinX, pinY, pinButton),
       hasButton(true),
       controllerX(ctrlX),
@@ -30,6 +30,16 @@ TSWGamePadControl::TSWGamePadControl(const String &id,
   Notch released = {"Released", 0.0f, 0, 0};
   Notch pressed = {"Pressed", 1.0f, 1, 1};
   buttonNotches.loadFromArray({released, pressed});
+
+  if (s)
+  {
+    for (const String *ctrl : {&controllerX, &controllerY, &controllerButton})
+    {
+      s->bindController(*ctrl);
+      if (tswNameInList(ctrl->c_str(), TSW_PRIORITY_CONTROLLERS))
+        s->setPriority(*ctrl, TSW_PRIORITY_HIGH);
+    }
+  }
 }
 
 // --- Begin ---
@@ -48,24 +58,32 @@ void TSWGamePadControl::updateAndSend()
 {
   if (!spider)
     return;
-  if (!gamepad.update())
-    return;
 
+  // read the stick only once the interval is over, so the latest position
+  // is never swallowed by the change detection while we wait
   unsigned long now = millis();
+  if (now - lastSentTime < sendInterval)
+    return;
+  if (!gamepad.update())
+    return;
 
   // X axis
   int xVal = gamepad.getXCentered(); // −100 … +100
   float tswX = notchX.hasPositions() ? notchX.mapToTSW(xVal) : xVal / 100.0f;
-  spider->setControllerValue(controllerX, tswX);
 
   // Y axis
   int yVal = gamepad.getYCentered(); // −100 … +100
   float tswY = notchY.hasPositions() ? notchY.mapToTSW(yVal) : yVal / 100.0f;
-  spider->setControllerValue(controllerY, tswY);
 
   // Button
   float btnVal = buttonNotches.mapToTSW(gamepad.isPressed() ? 100 : 0);
-  spider->setControllerValue(controllerButton, btnVal);
+
+  // all three values in one batch (pipelined by TSWSpider)
+  TSWSetItem items[] = {
+      {controllerX.c_str(), tswX, -1},
+      {controllerY.c_str(), tswY, -1},
+      {controllerButton.c_str(), btnVal, -1}};
+  spider->setControllerValues(items, 3);
 
   lastSentTime = now;
 }
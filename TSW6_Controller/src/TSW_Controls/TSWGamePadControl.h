@@ -46,7 +46,7 @@ private:
   String controllerButton;
 
   unsigned long lastSentTime;
-  unsigned long sendInterval;
+  unsigned long sendInterval; // minimum ms between two batches, on top of the queue's rate limit
 
 public:
   // 2-Axis joystick (mandatory button)
@@ -54,7 +54,7 @@ public:
                     uint8_t pinX, uint8_t pinY, uint8_t pinButton,
                     const String& ctrlX, const String& ctrlY,
                     const String& ctrlBtn,
-                    TSWSpider* s,
+                    TSWTransport* s,
                     unsigned long sendInt = 100);
 
   void begin();
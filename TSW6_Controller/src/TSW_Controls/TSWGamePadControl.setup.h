@@ -10,7 +10,7 @@
 static constexpr uint8_t GAMEPAD_PINS[] = PIN_GAMEPAD; 
 
 static TSWGamePadControl *pad1Ptr = nullptr;
-inline void setup_GamePad(TSWSpider* spider)
+inline void setup_GamePad(TSWTransport* spider)
 {
         static TSWGamePadControl pad1("pad1", GAMEPAD_PINS[0], GAMEPAD_PINS[1], GAMEPAD_PINS[2]);
   ControlRegistry::registerControl(&pad1, "TSWGamePadControl");
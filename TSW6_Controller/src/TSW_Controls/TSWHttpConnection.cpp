@@ -0,0 +1,309 @@
+/**
+ * @file TSWHttpConnection.cpp
+ * @brief Implementation of the persistent TSW HTTP/1.1 connection.
+ *
+ * @details
+ * Response bodies are never copied into a String: callers either stream
+ * them through the Stream interface or drop them via discardBody(), which
+ * drains the socket through a small stack buffer.
+ *
+ * append() collects request bytes in the connection's own tx buffer and
+ * only writes to the socket when the buffer is full or on commit().
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSWHttpConnection.h"
+
+// --- Connection lifecycle ---
+bool TSWHttpConnection::open(const char *host, uint16_t port, uint32_t connectTimeoutMs)
+{
+  if (client.connected() && canReuse())
+  {
+    reused = true;
+    return true;
+  }
+
+  client.stop();
+  reused = false;
+  keepAlive = false;
+  bodyDone = true;
+  requestsOnSocket = 0;
+  txLen = 0;
+  txFailed = false;
+
+  if (!client.connect(host, port, connectTimeoutMs))
+    return false;
+
+  client.setNoDelay(true); // small requests, no Nagle delay
+  return true;
+}
+
+void TSWHttpConnection::close()
+{
+  client.stop();
+  txLen = 0;
+  txFailed = false;
+  keepAlive = false;
+  bodyDone = true;
+  reused = false;
+  requestsOnSocket = 0;
+}
+
+bool TSWHttpConnection::isOpen()
+{
+  return client.connected();
+}
+
+// --- Request ---
+bool TSWHttpConnection::send(const char *data, size_t len)
+{
+  append(data, len);
+  return commit();
+}
+
+void TSWHttpConnection::append(const char *data, size_t len)
+{
+  while (len > 0 && !txFailed)
+  {
+    size_t n = sizeof(tx) - txLen;
+    if (n > len)
+      n = len;
+    memcpy(tx + txLen, data, n);
+    txLen += n;
+    data += n;
+    len -= n;
+
+    if (txLen == sizeof(tx))
+    {
+      txFailed = client.write(reinterpret_cast<const uint8_t *>(tx), txLen) != txLen;
+      txLen = 0;
+    }
+  }
+}
+
+bool TSWHttpConnection::commit()
+{
+  bodyDone = false;
+  keepAlive = false;
+  if (txLen > 0 && !txFailed)
+    txFailed = client.write(reinterpret_cast<const uint8_t *>(tx), txLen) != txLen;
+
+  bool ok = !txFailed;
+  txLen = 0;
+  txFailed = false;
+  if (ok)
+    requestsOnSocket++;
+  return ok;
+}
+
+// --- Response head ---
+int TSWHttpConnection::readResponseHead(uint32_t timeout)
+{
+  timeoutMs = timeout;
+  char line[96];
+
+  // Status line: "HTTP/1.1 200 OK"
+  if (!readLine(line, sizeof(line)) || strncmp(line, "HTTP/1.", 7) != 0)
+  {
+    close();
+    return -1;
+  }
+  bool http11 = (line[7] == '1');
+  int code = atoi(line + 9);
+
+  keepAlive = http11;
+  chunked = false;
+  remaining = -1; // unknown length: body ends when the server closes
+
+  // Headers until the empty line
+  while (true)
+  {
+    if (!readLine(line, sizeof(line)))
+    {
+      close();
+      return -1;
+    }
+    if (line[0] == '\0')
+      break;
+
+    if (strncasecmp(line, "Content-Length:", 15) == 0)
+      remaining = atol(line + 15);
+    else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line + 18, "chunked"))
+      chunked = true;
+    else if (strncasecmp(line, "Connection:", 11) == 0)
+    {
+      if (strstr(line + 11, "close"))
+        keepAlive = false;
+      else if (strstr(line + 11, "keep-alive"))
+        keepAlive = true;
+    }
+  }
+
+  if (chunked)
+  {
+    remaining = 0;
+    bodyDone = false;
+    nextChunk();
+  }
+  else if (remaining < 0)
+  {
+    keepAlive = false; // only the close marks the end of the body
+    bodyDone = false;
+  }
+  else
+  {
+    bodyDone = (remaining == 0);
+  }
+  return code;
+}
+
+// --- Body handling ---
+bool TSWHttpConnection::discardBody()
+{
+  uint8_t scratch[64];
+  while (!bodyDone)
+  {
+    if (chunked && remaining == 0 && !nextChunk())
+      break;
+
+    unsigned long start = millis();
+    while (!client.available())
+    {
+      if (!client.connected() || millis() - start > timeoutMs)
+      {
+        // unknown-length bodies end with the close; everything else is a failure
+        bool ok = (remaining < 0 && !chunked);
+        close();
+        return ok;
+      }
+      delay(1);
+    }
+
+    size_t want = sizeof(scratch);
+    if (remaining > 0 && (size_t)remaining < want)
+      want = remaining;
+    int n = client.read(scratch, want);
+    if (n <= 0)
+      continue;
+
+    if (remaining > 0)
+    {
+      remaining -= n;
+      if (remaining == 0 && !chunked)
+        bodyDone = true;
+    }
+  }
+
+  if (!keepAlive)
+    close();
+  return true;
+}
+
+int TSWHttpConnection::available()
+{
+  if (bodyDone)
+    return 0;
+  int n = client.available();
+  if (remaining > 0 && n > remaining)
+    n = remaining;
+  return n > 0 ? n : 0;
+}
+
+int TSWHttpConnection::read()
+{
+  if (bodyDone)
+    return -1;
+  if (chunked && remaining == 0 && !nextChunk())
+    return -1;
+
+  int c = readByte();
+  if (c < 0)
+  {
+    bodyDone = true;
+    if (remaining >= 0 || chunked)
+      close(); // truncated body, socket state unknown
+    return -1;
+  }
+
+  if (remaining > 0 && --remaining == 0 && !chunked)
+    bodyDone = true;
+  return c;
+}
+
+int TSWHttpConnection::peek()
+{
+  if (bodyDone)
+    return -1;
+  if (chunked && remaining == 0 && !nextChunk())
+    return -1;
+
+  unsigned long start = millis();
+  while (!client.available())
+  {
+    if (!client.connected() || millis() - start > timeoutMs)
+      return -1;
+    delay(1);
+  }
+  return client.peek();
+}
+
+// --- Helpers ---
+int TSWHttpConnection::readByte()
+{
+  unsigned long start = millis();
+  while (!client.available())
+  {
+    if (!client.connected() || millis() - start > timeoutMs)
+      return -1;
+    delay(1);
+  }
+  return client.read();
+}
+
+bool TSWHttpConnection::readLine(char *buf, size_t len)
+{
+  size_t n = 0;
+  while (true)
+  {
+    int c = readByte();
+    if (c < 0)
+      return false;
+    if (c == '\n')
+      break;
+    if (c != '\r' && n + 1 < len)
+      buf[n++] = (char)c;
+  }
+  buf[n] = '\0';
+  return true;
+}
+
+bool TSWHttpConnection::nextChunk()
+{
+  char line[24];
+
+  // every chunk but the first is preceded by the CRLF closing the previous one
+  if (!readLine(line, sizeof(line)))
+  {
+    close();
+    return false;
+  }
+  if (line[0] == '\0' && !readLine(line, sizeof(line)))
+  {
+    close();
+    return false;
+  }
+
+  remaining = strtol(line, nullptr, 16);
+  if (remaining > 0)
+    return true;
+
+  // last chunk: skip optional trailers up to the empty line
+  while (readLine(line, sizeof(line)) && line[0] != '\0')
+  {
+  }
+  bodyDone = true;
+  return false;
+}
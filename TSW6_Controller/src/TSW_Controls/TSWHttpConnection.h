@@ -0,0 +1,85 @@
+/**
+ * @file TSWHttpConnection.h
+ * @brief Persistent HTTP/1.1 keep-alive connection used by TSWSpider.
+ *
+ * @details
+ * Wraps a single WiFiClient socket to the TSW host (or the Windows port proxy)
+ * and keeps it open across requests. Provides just enough HTTP/1.1 to talk to
+ * the TSW API:
+ *   - raw request writing (the caller formats the request head)
+ *   - status line and header parsing (Content-Length, chunked, Connection)
+ *   - streaming access to the response body without buffering it
+ *
+ * Requests can be assembled piecewise with append() into a fixed per-socket
+ * buffer and written with a single commit(), so a pipelined batch goes out
+ * in as few TCP segments as possible without touching the heap.
+ *
+ * A connection that was closed by the server while idle is detected on the
+ * next request and reported via wasReused(), so the caller can retry once on
+ * a fresh socket.
+ *
+ * Example:
+ * @code
+ *   TSWHttpConnection conn;
+ *   if (conn.open("192.168.4.2", 31270, 500) && conn.send(req, len))
+ *   {
+ *     int code = conn.readResponseHead(500);
+ *     conn.discardBody();
+ *   }
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "../config.h"
+
+#ifndef TSW_TX_BUFFER_LEN
+#define TSW_TX_BUFFER_LEN 1024
+#endif
+
+class TSWHttpConnection : public Stream
+{
+private:
+  WiFiClient client;
+  bool reused = false;        // current request runs on an already open socket
+  bool keepAlive = false;     // server allows another request on this socket
+  bool chunked = false;       // body uses chunked transfer encoding
+  bool bodyDone = true;       // body of the current response fully consumed
+  int32_t remaining = 0;      // bytes left in body (or current chunk)
+  uint32_t timeoutMs = 1000;  // per-read timeout while a response is pending
+  uint32_t requestsOnSocket = 0;
+  char tx[TSW_TX_BUFFER_LEN]; // outgoing request bytes not yet written
+  uint16_t txLen = 0;
+  bool txFailed = false;
+
+  int readByte();
+  bool readLine(char *buf, size_t len);
+  bool nextChunk();
+
+public:
+  // --- Connection lifecycle ---
+  bool open(const char *host, uint16_t port, uint32_t connectTimeoutMs);
+  void close();
+  bool isOpen();
+  bool wasReused() const { return reused; }
+  uint32_t getRequestsOnSocket() const { return requestsOnSocket; }
+
+  // --- Request / response ---
+  bool send(const char *data, size_t len);
+  void append(const char *data, size_t len);
+  bool commit();
+  int readResponseHead(uint32_t timeout);
+  bool discardBody();
+  bool canReuse() const { return keepAlive && bodyDone; }
+
+  // --- Stream interface (response body) ---
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+};
@@ -11,17 +11,16 @@
  * @date
  *   2025-10-28
  * @version
- *   2.0
+ *   2.1
  */
 
 #include "TSWLever.h"
 #include <cmath>
 
 // --- Constructor ---
-TSWLever::TSWLever(uint8_t pin, const String& ctrl, TSWSpider* s)
+TSWLever::TSWLever(uint8_t pin, const String& ctrl, TSWTransport* s)
     : AnalogSlider(ctrl + "_HW", pin),
-      TSWControl(ctrl, s),
-      lastSentValue(-999.0f) {}
+      TSWControl(ctrl, s) {}
 
 // --- Load Notch configuration ---
 void TSWLever::loadNotches(const String& filePath) {
@@ -29,16 +28,25 @@ void TSWLever::loadNotches(const String& filePath) {
 }
 
 // --- Update and send value ---
+bool TSWLever::update() {
+  if (!AnalogSlider::update())
+    return false;
+  sendValueToTSW(mapPercent(getPercentValue()));
+  return true;
+}
+
 void TSWLever::updateAndSend() {
-  if (update()) {
-    int percent = getPercentValue();  // 0–100 %
-    float tswValue = notches.hasPositions()
-                         ? notches.mapToTSW(percent)
-                         : percent / 100.0f;
+  update();
+}
+
+// --- Startup sync: current position without waiting for movement ---
+bool TSWLever::sampleTSWValue(float& value) {
+  begin();
+  value = mapPercent(getPercentValue());
+  return true;
+}
 
-    if (fabs(tswValue - lastSentValue) > 0.001f) {
-      spider->setControllerValue(controllerName, tswValue);
-      lastSentValue = tswValue;
-    }
-  }
+float TSWLever::mapPercent(int percent) {
+  // 0–100 %, pass-through without notches
+  return notches.hasPositions() ? notches.mapToTSW(percent) : percent / 100.0f;
 }
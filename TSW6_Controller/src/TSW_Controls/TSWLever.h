@@ -16,26 +16,29 @@
  * @note
  *   - Analog input (0–100 %) mapped via NotchTable.
  *   - Default behavior: pass-through if no Notches loaded.
+ *   - final: the lever bank calls update() without virtual dispatch.
  *
  * @author
  *   Felix Lindemann
  * @date
  *   2025-10-28
  * @version
- *   2.0
+ *   2.2
  */
 
 #pragma once
 #include "TSWControl.h"
 #include "../controls/AnalogSlider.h"
 
-class TSWLever : public AnalogSlider, public TSWControl {
-private:
-  float lastSentValue;
-
+class TSWLever final : public AnalogSlider, public TSWControl {
 public:
-  TSWLever(uint8_t pin, const String& ctrl, TSWSpider* s);
+  TSWLever(uint8_t pin, const String& ctrl, TSWTransport* s);
 
   void loadNotches(const String& filePath);
+  bool update() override; // polls the slider and sends a change (loop stage)
   void updateAndSend();
+  bool sampleTSWValue(float& value) override;
+
+private:
+  float mapPercent(int percent);
 };
@@ -1,27 +1,44 @@
 #include "../config.h"
 #include "../controls/Control.h"
 #include "../repo/controlsRepo.h"
+#include "../repo/controlBank.h"
 
 #if USE_ANALOG_SLIDER
 
 #include "TSWLever.h"
 
+#ifndef ANALOG_SLIDER_CONTROLLERS
+#define ANALOG_SLIDER_CONTROLLERS {"sld1", "sld2", "sld3"}
+#endif
 
+// one lever per entry; pins, inversion and controller names line up by position
 static constexpr uint8_t ANALOG_PINS[] = PIN_ANALOG_SLIDER;
 static constexpr bool ANALOG_INV[] = ANALOG_SLIDER_INVERTED;
+static constexpr const char *ANALOG_CONTROLLERS[] = ANALOG_SLIDER_CONTROLLERS;
+static constexpr size_t ANALOG_COUNT = sizeof(ANALOG_PINS) / sizeof(ANALOG_PINS[0]);
+static_assert(sizeof(ANALOG_INV) / sizeof(ANALOG_INV[0]) == ANALOG_COUNT,
+              "ANALOG_SLIDER_INVERTED needs one entry per PIN_ANALOG_SLIDER pin");
+static_assert(sizeof(ANALOG_CONTROLLERS) / sizeof(ANALOG_CONTROLLERS[0]) == ANALOG_COUNT,
+              "ANALOG_SLIDER_CONTROLLERS needs one entry per PIN_ANALOG_SLIDER pin");
 
-inline void setup_analogSlider(TSWSpider* spider)
+CONTROL_TRAITS(TSWLever, CONTROL_KIND_ANALOG);
+static ControlBank<TSWLever, ANALOG_COUNT> levers;
+
+inline void setup_analogSlider(TSWTransport* spider)
 {
-    for (int i = 0; i < 3; ++i) {
-        String id = "sld" + String(i + 1);
-        static TSWLever lever(ANALOG_PINS[i], id, spider);
-        lever.setInverted(ANALOG_INV[i]);
-        ControlRegistry::registerControl(&lever, "TSWLever");
+    for (size_t i = 0; i < ANALOG_COUNT; ++i) {
+        TSWLever *lever = levers.emplace(ANALOG_PINS[i], ANALOG_CONTROLLERS[i], spider);
+        if (!lever)
+            break; // called twice
+        lever->setInverted(ANALOG_INV[i]);
+        ControlRegistry::registerControl(lever);
     }
 }
 
 #define SETUP_ANALOG_SLIDER(  a) setup_analogSlider(a)
+#define POLL_ANALOG_SLIDER(onChange) levers.poll(onChange)
 
 #else
 #define SETUP_ANALOG_SLIDER(...)
+#define POLL_ANALOG_SLIDER(...)
 #endif
\ No newline at end of file
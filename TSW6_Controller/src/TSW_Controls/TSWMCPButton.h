@@ -22,16 +22,15 @@
 #include "TSWControl.h"
 #include "../controls/MCPButtonProxy.h"
 #include "../controls/Control.h" // wichtig für Mehrfachvererbung
-class TSWMCPButton : public Control, public TSWControl
+class TSWMCPButton final : public Control, public TSWControl
 {
 private:
     MCPButtonProxy *proxy = nullptr;
-    float lastSentValue = -1.0f;
 
 public:
     TSWMCPButton(MCPButtonProxy *proxy,
                  const String &controllerName,
-                 TSWSpider *spider)
+                 TSWTransport *spider)
         : Control(controllerName, 0),
           TSWControl(controllerName, spider),
           proxy(proxy)
@@ -67,17 +66,29 @@ public:
         if (!proxy || !spider)
             return;
 
-        float value = proxy->getValue();
-        float mapped = notches.mapToTSW(value > 0.5f ? 100 : 0);
+        float mapped = mapProxyValue();
 
-        if (fabs(mapped - lastSentValue) > 0.001f)
+        if (sendValueToTSW(mapped))
         {
-            spider->setControllerValue(controllerName, mapped);
-            lastSentValue = mapped;
             TRACE_PRINT("[TSW] %s -> %.2f\n",
                         controllerName.c_str(), mapped);
         }
     }
 
+    // the array is polled by its own begin()/update(), the proxy state is current
+    bool sampleTSWValue(float &value) override
+    {
+        if (!proxy)
+            return false;
+        value = mapProxyValue();
+        return true;
+    }
+
     MCPButtonProxy *getProxy() const { return proxy; }
+
+private:
+    float mapProxyValue()
+    {
+        return notches.mapToTSW(proxy->getValue() > 0.5f ? 100 : 0);
+    }
 };
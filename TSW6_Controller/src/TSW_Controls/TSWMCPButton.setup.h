@@ -1,6 +1,7 @@
 #include "../config.h"
 #include "../controls/Control.h"
 #include "../repo/controlsRepo.h"
+#include "../repo/controlBank.h"
 
 #if USE_MCPBUTTONARRAY
 
@@ -10,29 +11,38 @@
 
 static constexpr uint8_t MCP_CS_PINS[] = PIN_EXPANDERS;
 static constexpr uint8_t MCP_RESET_PIN = PIN_EXPANDERSRESET;
-inline void setupMCPButtonArray(TSWSpider *spider)
-{
+static_assert(sizeof(MCP_CS_PINS) / sizeof(MCP_CS_PINS[0]) == NUM_OF_EXPANDERS,
+              "PIN_EXPANDERS needs one pin per expander (NUM_OF_EXPANDERS)");
 
-    static MCPButtonArray mcpButtons("BTN");
+CONTROL_TRAITS(TSWMCPButton, CONTROL_KIND_BUTTON);
+static MCPButtonArray mcpButtons("BTN");
+static ControlBank<TSWMCPButton, TOTAL_BUTTONS> mcpTswButtons;
 
+inline void setupMCPButtonArray(TSWTransport *spider)
+{
     mcpButtons.begin(); // registriert sich selbst und seine Buttons
 
+    char ctrl[16];
     for (int i = 0; i < TOTAL_BUTTONS; ++i)
     {
-        String id = "BTN_" + String(i + 1);
-        MCPButtonProxy *proxy = (MCPButtonProxy *)ControlRegistry::find(id);
+        MCPButtonProxy *proxy = (MCPButtonProxy *)ControlRegistry::find(mcpButtons.getButtonId(i));
 
         if (!proxy)
             continue;
 
-        String ctrl = "Button_" + String(i + 1);
-        static TSWMCPButton btn(proxy, ctrl, spider);
-        ControlRegistry::registerControl(&btn, "TSWMCPButton");
+        snprintf(ctrl, sizeof(ctrl), "Button_%d", i + 1);
+        TSWMCPButton *btn = mcpTswButtons.emplace(proxy, ctrl, spider);
+        if (!btn)
+            break;
+        ControlRegistry::registerControl(btn);
     }
 }
 
 #define SETUP_MCPButtonArray(spiderPtr) setupMCPButtonArray(spiderPtr)
+// the expander scan first, so the buttons see this pass's states
+#define POLL_MCPButtonArray() (mcpButtons.MCPButtonArray::update(), mcpTswButtons.poll())
 
 #else
 #define SETUP_MCPButtonArray(...)
+#define POLL_MCPButtonArray()
 #endif
\ No newline at end of file
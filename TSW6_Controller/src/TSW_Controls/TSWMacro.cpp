@@ -0,0 +1,302 @@
+/**
+ * @file TSWMacro.cpp
+ * @brief Implementation of the macro compiler and executor.
+ *
+ * @details
+ * Delay-only steps are folded into the delay of the step that follows, so
+ * every compiled step carries a value. Names are interned: a controller
+ * that appears in several macros is stored (and bound at the transport)
+ * once.
+ *
+ * The executor keeps one cursor per macro. A pass collects the due group
+ * of every running macro - its next step and all following ones without a
+ * delay - into one batch, sends it and returns the time until the next
+ * step is due, which is how long the task sleeps.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSWMacro.h"
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "../repo/controlsRepo.h"
+
+// --- Compile ---
+bool TSWMacroEngine::begin(TSWTransport *t, const char *path)
+{
+  transport = t;
+  stepCount = 0;
+  macroCount = 0;
+  namesUsed = 0;
+  stats.unresolved = 0;
+
+  if (!LittleFS.begin() || !LittleFS.exists(path))
+  {
+    Serial.printf("[Macro] %s not found, no macros\n", path);
+    return false;
+  }
+  File file = LittleFS.open(path, "r");
+  DynamicJsonDocument doc(TSW_MACRO_JSON_LEN);
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err)
+  {
+    Serial.printf("[Macro] %s: JSON parse error (%s)\n", path, err.c_str());
+    return false;
+  }
+
+  for (JsonObject m : doc["macros"].as<JsonArray>())
+  {
+    const char *name = m["name"] | "";
+    if (macroCount >= TSW_MACRO_MAX)
+    {
+      Serial.printf("[Macro] More than %u macros, '%s' and the rest skipped\n", TSW_MACRO_MAX, name);
+      break;
+    }
+
+    int nameOffset = intern(name);
+    if (nameOffset < 0)
+    {
+      Serial.printf("[Macro] Name pool full (TSW_MACRO_NAMES_LEN), '%s' and the rest skipped\n", name);
+      break;
+    }
+    Macro &macro = macros[macroCount];
+    macro.name = nameOffset;
+    macro.first = stepCount;
+    macro.count = 0;
+    macro.at = m["at"] | 1.0f;
+    macro.next = -1;
+    macro.dueMs = 0;
+
+    uint32_t delay = 0;
+    bool complete = true;
+    for (JsonObject s : m["steps"].as<JsonArray>())
+    {
+      delay += s["delay"].as<uint32_t>(); // 0 if missing
+      const char *controller = s["controller"];
+      if (!controller)
+        continue; // delay only, added to the next step
+      int offset = intern(controller);
+      if (stepCount >= TSW_MACRO_STEPS || offset < 0)
+      {
+        complete = false;
+        break;
+      }
+      steps[stepCount++] = {(uint16_t)offset, (uint16_t)(delay > 0xFFFF ? 0xFFFF : delay), s["value"] | 0.0f};
+      macro.count++;
+      delay = 0;
+    }
+    if (!complete || macro.count == 0)
+    {
+      Serial.printf("[Macro] '%s' %s, skipped\n", name, complete ? "has no steps" : "does not fit (TSW_MACRO_STEPS / TSW_MACRO_NAMES_LEN)");
+      stepCount = macro.first;
+      continue;
+    }
+
+    const char *trigger = m["trigger"] | "";
+    macro.trigger = trigger[0] ? ControlRegistry::find(trigger) : nullptr;
+    if (trigger[0] && !macro.trigger)
+    {
+      Serial.printf("[Macro] '%s': trigger control '%s' not found\n", name, trigger);
+      stats.unresolved++;
+    }
+    macro.last = macro.trigger ? macro.trigger->getValue() : 0.0f; // held at boot is no press
+    macroCount++;
+  }
+
+  // route table entries for the step controllers, once per name
+  for (uint8_t i = 0; i < stepCount; i++)
+  {
+    bool first = true;
+    for (uint8_t k = 0; k < i && first; k++)
+      first = steps[k].name != steps[i].name;
+    if (first && transport)
+      transport->bindController(names + steps[i].name);
+  }
+
+  stats.macros = macroCount;
+  stats.steps = stepCount;
+  stats.names = namesUsed;
+  stats.ramBytes = stepCount * sizeof(Step) + macroCount * sizeof(Macro) + namesUsed;
+  Serial.printf("[Macro] %u macros with %u steps compiled (%u bytes), %u triggers not found\n", stats.macros,
+                stats.steps, stats.ramBytes, stats.unresolved);
+  return macroCount > 0;
+}
+
+int TSWMacroEngine::intern(const char *name)
+{
+  for (uint16_t pos = 0; pos < namesUsed; pos += strlen(names + pos) + 1)
+    if (strcmp(names + pos, name) == 0)
+      return pos;
+
+  size_t len = strlen(name) + 1;
+  if (namesUsed + len > sizeof(names))
+    return -1;
+  memcpy(names + namesUsed, name, len);
+  namesUsed += len;
+  return namesUsed - len;
+}
+
+int TSWMacroEngine::find(const char *name) const
+{
+  for (uint8_t i = 0; i < macroCount; i++)
+    if (strcmp(names + macros[i].name, name) == 0)
+      return i;
+  return -1;
+}
+
+// --- Triggers ---
+void TSWMacroEngine::update()
+{
+  for (uint8_t i = 0; i < macroCount; i++)
+  {
+    Macro &macro = macros[i];
+    if (!macro.trigger)
+      continue;
+    float value = macro.trigger->getValue();
+    if (fabsf(value - macro.at) < 0.001f && fabsf(macro.last - macro.at) >= 0.001f)
+      trigger(i);
+    macro.last = value;
+  }
+
+  if (!task)
+    runDue(millis());
+}
+
+bool TSWMacroEngine::trigger(uint8_t index)
+{
+  if (index >= macroCount)
+    return false;
+  if (task)
+    return xQueueSend(triggers, &index, 0) == pdTRUE;
+  start(index, millis());
+  return true;
+}
+
+void TSWMacroEngine::start(uint8_t index, uint32_t now)
+{
+  Macro &macro = macros[index];
+  portENTER_CRITICAL(&mux);
+  if (macro.next >= 0)
+    stats.ignored++;
+  else
+    stats.triggered++;
+  portEXIT_CRITICAL(&mux);
+  if (macro.next >= 0)
+    return;
+
+  macro.next = 0;
+  macro.dueMs = now + steps[macro.first].delayMs; // a leading delay is kept
+  TRACE_PRINT("[Macro] %s started\n", names + macro.name);
+}
+
+// --- Execution ---
+uint32_t TSWMacroEngine::runDue(uint32_t now)
+{
+  TSWSetItem items[TSW_MACRO_BATCH];
+  uint8_t n = 0;
+  uint32_t wait = UINT32_MAX;
+
+  for (uint8_t i = 0; i < macroCount; i++)
+  {
+    Macro &macro = macros[i];
+    if (macro.next < 0)
+      continue;
+    if ((int32_t)(macro.dueMs - now) > 0)
+    {
+      if (macro.dueMs - now < wait)
+        wait = macro.dueMs - now;
+      continue;
+    }
+
+    // the due step and every following one without a delay
+    do
+    {
+      const Step &step = steps[macro.first + macro.next];
+      items[n++] = {names + step.name, step.value, -1};
+      macro.next++;
+    } while (n < TSW_MACRO_BATCH && macro.next < macro.count && steps[macro.first + macro.next].delayMs == 0);
+
+    if (macro.next >= macro.count)
+    {
+      macro.next = -1;
+      TRACE_PRINT("[Macro] %s done\n", names + macro.name);
+    }
+    else
+    {
+      // a full batch continues right away, otherwise after the step's delay
+      uint16_t delay = steps[macro.first + macro.next].delayMs;
+      macro.dueMs = now + delay;
+      if (delay < wait)
+        wait = delay;
+    }
+    if (n >= TSW_MACRO_BATCH)
+    {
+      wait = 0; // macros not visited yet get their turn on the next pass
+      break;
+    }
+  }
+
+  if (n > 0 && transport)
+  {
+    uint8_t ok = transport->setControllerValues(items, n);
+    portENTER_CRITICAL(&mux);
+    stats.batches++;
+    stats.values += n;
+    stats.failed += n - ok;
+    portEXIT_CRITICAL(&mux);
+  }
+  return wait;
+}
+
+bool TSWMacroEngine::startTask()
+{
+  if (task)
+    return true;
+  if (macroCount == 0)
+    return false;
+
+  triggers = xQueueCreate(TSW_MACRO_MAX, sizeof(uint8_t));
+  if (!triggers)
+    return false;
+  // blocking sets run here, next to the send queue, instead of in loop()
+  if (xTaskCreatePinnedToCore(taskEntry, "tswMacro", 4096, this, 1, &task, 0) != pdPASS)
+  {
+    Serial.println("[Macro] Failed to start task");
+    task = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void TSWMacroEngine::taskEntry(void *arg)
+{
+  static_cast<TSWMacroEngine *>(arg)->run();
+}
+
+void TSWMacroEngine::run()
+{
+  uint32_t wait = UINT32_MAX;
+  while (true)
+  {
+    uint8_t index;
+    TickType_t ticks = wait == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(wait);
+    if (xQueueReceive(triggers, &index, ticks) == pdTRUE)
+    {
+      start(index, millis());
+      while (xQueueReceive(triggers, &index, 0) == pdTRUE)
+        start(index, millis());
+    }
+    wait = runDue(millis());
+  }
+}
+
+TSWMacroEngine::Stats TSWMacroEngine::getStats()
+{
+  portENTER_CRITICAL(&mux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&mux);
+  return copy;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file TSWMacro.h
+ * @brief Stored sequences of controller values, started by a button or knob.
+ *
+ * @details
+ * Cab procedures such as "pantograph up, main breaker on, reverser forward"
+ * are a fixed series of sets. TSWMacroEngine loads them from LittleFS
+ * (TSW_MACRO_FILE) once at boot and compiles them into fixed tables in RAM:
+ * an 8 byte step per value (name offset, delay before, value) and a pool
+ * holding every controller name once. The JSON document is freed right
+ * after compiling, nothing is allocated afterwards.
+ *
+ * File format:
+ * @code
+ *   { "macros": [
+ *       { "name": "Aufruesten", "trigger": "BTN_03",
+ *         "steps": [ { "controller": "Pantograph", "value": 1 },
+ *                    { "delay": 1500 },
+ *                    { "controller": "MainBreaker", "value": 1 },
+ *                    { "controller": "Reverser", "value": 1 } ] },
+ *       { "name": "Fernlicht", "trigger": "rotary01", "at": 2,
+ *         "steps": [ ... ] } ] }
+ * @endcode
+ *
+ * A macro starts when the value of its trigger control (any id in the
+ * ControlRegistry, e.g. the MCP button proxies "BTN_01" ...) becomes "at"
+ * (default 1, i.e. a button press). A macro that is still running ignores
+ * further triggers; a trigger that is not registered is logged and counted.
+ *
+ * Steps without a delay between them are handed to the transport in one
+ * setControllerValues() call: TSWSpider pipelines them over one connection,
+ * the wire transports pack them into one SET message. Groups of several
+ * macros that are due at the same time share that batch.
+ *
+ * update() checks the triggers and belongs into loop(). With a blocking
+ * transport (TSWSendQueue, TSWSpider), startTask() moves the execution into
+ * a task of its own, so loop() never waits for HTTP; without it update()
+ * runs the due steps itself, which suits the non-blocking wire transports.
+ * Over HTTP the engine goes through TSWSendQueue, which sends each batch
+ * ahead of its slots and replaces pending values of the same controllers,
+ * so a lever value queued before the macro cannot undo a step.
+ *
+ * Example:
+ * @code
+ *   TSWMacroEngine macros;
+ *   macros.begin(&queue, "/macros.json"); // after all controls are registered
+ *   macros.startTask();
+ *   ...
+ *   macros.update(); // in loop()
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "TSWTransport.h"
+#include "../controls/Control.h"
+#include "../config.h"
+
+#ifndef TSW_MACRO_FILE
+#define TSW_MACRO_FILE "/macros.json"
+#endif
+#ifndef TSW_MACRO_MAX
+#define TSW_MACRO_MAX 16
+#endif
+#ifndef TSW_MACRO_STEPS
+#define TSW_MACRO_STEPS 128 // all macros together
+#endif
+#ifndef TSW_MACRO_NAMES_LEN
+#define TSW_MACRO_NAMES_LEN 1024 // pool for the controller and macro names
+#endif
+#ifndef TSW_MACRO_JSON_LEN
+#define TSW_MACRO_JSON_LEN 8192 // parse buffer, only used while compiling
+#endif
+#define TSW_MACRO_BATCH 16      // values per setControllerValues() call
+
+class TSWMacroEngine
+{
+public:
+  struct Stats
+  {
+    uint8_t macros = 0;     // compiled
+    uint8_t steps = 0;      // values in all macros
+    uint16_t names = 0;     // bytes of the name pool in use
+    uint16_t ramBytes = 0;  // steps, macros and names as compiled
+    uint8_t unresolved = 0; // macros whose trigger control is not registered
+    uint32_t triggered = 0; // macro starts
+    uint32_t ignored = 0;   // triggers of a macro that was still running
+    uint32_t batches = 0;   // setControllerValues() calls
+    uint32_t values = 0;    // values sent
+    uint32_t failed = 0;    // values not answered with HTTP 200
+  };
+
+private:
+  struct Step
+  {
+    uint16_t name;    // offset into names
+    uint16_t delayMs; // wait before this step, 0 = same batch as the previous one
+    float value;
+  };
+
+  struct Macro
+  {
+    uint16_t name;    // offset into names
+    uint8_t first;    // index into steps
+    uint8_t count;
+    Control *trigger; // nullptr: no such control
+    float at;         // trigger value
+    float last;       // trigger value of the previous update(), loop only
+    int16_t next;     // next step while running, -1 when idle
+    uint32_t dueMs;   // time of the next step
+  };
+
+  TSWTransport *transport = nullptr;
+  Step steps[TSW_MACRO_STEPS];
+  Macro macros[TSW_MACRO_MAX];
+  char names[TSW_MACRO_NAMES_LEN];
+  uint8_t stepCount = 0;
+  uint8_t macroCount = 0;
+  uint16_t namesUsed = 0;
+
+  QueueHandle_t triggers = nullptr;
+  TaskHandle_t task = nullptr;
+  Stats stats;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  int intern(const char *name);
+  void start(uint8_t index, uint32_t now);
+  uint32_t runDue(uint32_t now);
+  static void taskEntry(void *arg);
+  void run();
+
+public:
+  // compiles the macro file; call after all controls are registered
+  bool begin(TSWTransport *transport, const char *path = TSW_MACRO_FILE);
+  bool startTask();
+
+  void update();
+  bool trigger(uint8_t index);
+  int find(const char *name) const;
+
+  uint8_t getMacroCount() const { return macroCount; }
+  const char *getMacroName(uint8_t index) const { return index < macroCount ? names + macros[index].name : ""; }
+  Stats getStats();
+};
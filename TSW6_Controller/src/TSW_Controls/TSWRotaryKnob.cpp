@@ -10,7 +10,7 @@
 
 // --- Constructor ---
 TSWRotaryKnob::TSWRotaryKnob(const String &id, uint8_t a, uint8_t b,
-                             TSWSpider *spider, float minVal, float maxVal)
+                             TSWTransport *spider, float minVal, float maxVal)
     : RotaryKnob(id, a, b), TSWControl(id, spider),
       minValue(minVal), maxValue(maxVal), currentTSWValue(0.0f) {}
 
@@ -49,14 +49,12 @@ bool TSWRotaryKnob::update()
   // Serial.printf("[TSWRotaryKnob] %s => %.2f (%s)\n",
   //               getId().c_str(), currentTSWValue, getChangeReason());
 
+  sendValueToTSW(currentTSWValue);
   return true;
 }
 
 // --- Update + Send ---
 void TSWRotaryKnob::updateAndSend()
 {
-  if (update())
-  {
-    sendValueToTSW(currentTSWValue);
-  }
+  update();
 }
@@ -19,7 +19,7 @@
  * @date
  *   2025-11-02
  * @version
- *   2.1
+ *   2.2
  */ 
 
 #pragma once
@@ -36,7 +36,7 @@ private:
 public:
   // --- Constructors ---
   TSWRotaryKnob(const String& id, uint8_t a, uint8_t b,
-                TSWSpider* spider, float minVal = 0.0f, float maxVal = 1.0f);
+                TSWTransport* spider, float minVal = 0.0f, float maxVal = 1.0f);
 
   // --- Legacy overload for backward compatibility ---
   TSWRotaryKnob(const String& id, uint8_t a, uint8_t b,
@@ -44,7 +44,7 @@ public:
 
   // --- Lifecycle ---
   void begin() override;
-  bool update() override;
+  bool update() override; // maps a step and sends it (loop stage)
 
   // --- TSW mapping ---
   void updateAndSend();
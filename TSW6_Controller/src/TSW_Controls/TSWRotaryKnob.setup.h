@@ -1,22 +1,38 @@
 #include "../config.h"
 #include "../controls/Control.h"
 #include "../repo/controlsRepo.h"
+#include "../repo/controlBank.h"
 
 #if USE_Rotary
 
 #include "TSWRotaryKnob.h"
 
+// two pins (A, B) per knob, ids rot01, rot02, ...
 static constexpr uint8_t ROTARY_PINS[] = PIN_Rotary;
+static constexpr size_t ROTARY_COUNT = sizeof(ROTARY_PINS) / sizeof(ROTARY_PINS[0]) / 2;
+static_assert(sizeof(ROTARY_PINS) / sizeof(ROTARY_PINS[0]) % 2 == 0, "PIN_Rotary needs two pins per knob");
 
-inline void setup_RotaryButton(TSWSpider *spider)
+CONTROL_TRAITS(RotaryKnob, CONTROL_KIND_ROTARY);
+static ControlBank<RotaryKnob, ROTARY_COUNT> rotaries;
+
+inline void setup_RotaryButton(TSWTransport *spider)
 {
-  static RotaryKnob rotary01("rot01", GPIO_NUM_16, GPIO_NUM_17);
-  ControlRegistry::registerControl(&rotary01, "RotaryKnob");
-  rotary01.begin();
+  char id[8];
+  for (size_t i = 0; i < ROTARY_COUNT; ++i)
+  {
+    snprintf(id, sizeof(id), "rot%02u", (unsigned)(i + 1));
+    RotaryKnob *rotary = rotaries.emplace(id, ROTARY_PINS[2 * i], ROTARY_PINS[2 * i + 1]);
+    if (!rotary)
+      break;
+    ControlRegistry::registerControl(rotary);
+    rotary->begin();
+  }
 }
 
 #define SETUP_ROTARYBUTTON(spiderPtr) setup_RotaryButton(spiderPtr)
+#define POLL_ROTARYBUTTON(onChange) rotaries.poll(onChange)
 
 #else
 #define SETUP_ROTARYBUTTON(...)
+#define POLL_ROTARYBUTTON(...)
 #endif
\ No newline at end of file
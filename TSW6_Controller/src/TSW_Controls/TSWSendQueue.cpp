@@ -0,0 +1,512 @@
+/**
+ * @file TSWSendQueue.cpp
+ * @brief Implementation of the asynchronous TSW send queue.
+ *
+ * @details
+ * The network task is pinned to TSW_SEND_TASK_CORE (core 0 by default, the
+ * core running the WiFi stack) while the Arduino loop() keeps core 1 for
+ * polling the hardware.
+ *
+ * A slot is marked pending when its index is put into the queue and cleared
+ * when the network task takes the value out. Values arriving while a slot
+ * is pending only replace the stored value; values arriving while the
+ * previous one is in flight queue the slot again.
+ *
+ * The task collects every slot that is waiting (up to TSW_PIPELINE_DEPTH)
+ * and hands them to the transport as one batch, which TSWSpider pipelines
+ * over a single connection.
+ *
+ * After a batch with undelivered items the task wakes up every
+ * TSW_SEND_RESYNC_MS and lets the transport replay them, until resync()
+ * reports that nothing is left.
+ *
+ * Slots that are not due yet go to a waiting list instead of the batch. They
+ * stay pending, so new values only overwrite them and the queue can still
+ * hold every slot at most once. The task sleeps until the first of them is
+ * due or something new arrives.
+ *
+ * High priority slots are never held back and go out first in the next
+ * pass, as a batch of their own ahead of the bulk values: they wait at most
+ * for the batch already in flight, however many bulk controllers are
+ * streaming. Their enqueue-to-answer latency is
+ * tracked separately and checked against TSW_PRIORITY_BUDGET_MS.
+ *
+ * A setControllerValues() batch travels through the queue as BATCH_INDEX,
+ * put at its front. The task sends it as soon as it takes it out: after
+ * the batch in flight, before the slots collected in the same pass. The
+ * caller sleeps on its task notification until the answers are in.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.8
+ */
+
+#include "TSWSendQueue.h"
+
+static_assert(TSW_SEND_SLOTS < 255, "slot indices share the queue with the batch marker 0xFF");
+
+bool TSWSendQueue::begin()
+{
+  if (task)
+    return true;
+  if (!target)
+    return false;
+
+  // the startup sync may have left values the transport could not deliver
+  resyncPending = true;
+
+  // every slot is queued at most once, plus one batch: the queue can never overflow
+  queue = xQueueCreate(TSW_SEND_SLOTS + 1, sizeof(uint8_t));
+  if (!queue)
+  {
+    Serial.println("[SendQueue] Failed to create queue");
+    return false;
+  }
+
+  if (xTaskCreatePinnedToCore(taskEntry, "tswSend", TSW_SEND_TASK_STACK, this,
+                              TSW_SEND_TASK_PRIO, &task, TSW_SEND_TASK_CORE) != pdPASS)
+  {
+    Serial.println("[SendQueue] Failed to start network task");
+    task = nullptr;
+    return false;
+  }
+
+  Serial.printf("[SendQueue] Started (%u slots, core %d)\n", TSW_SEND_SLOTS, TSW_SEND_TASK_CORE);
+  return true;
+}
+
+// --- Slots ---
+int TSWSendQueue::findOrAddSlot(const char *controller)
+{
+  // a cut copy would never match the name again and take a slot per value
+  if (strlen(controller) >= TSW_CONTROLLER_NAME_LEN)
+    return -1;
+
+  uint32_t h = tswHashName(controller);
+  for (uint8_t i = 0; i < slotCount; i++)
+    if (slots[i].hash == h && strcmp(slots[i].controller, controller) == 0)
+      return i;
+
+  if (slotCount >= TSW_SEND_SLOTS)
+    return -1;
+
+  // only loop() adds slots; the task never reads beyond slotCount
+  Slot &slot = slots[slotCount];
+  memset(&slot, 0, sizeof(slot));
+  strncpy(slot.controller, controller, sizeof(slot.controller) - 1);
+  slot.hash = h;
+  slot.intervalMs = TSW_RATE_MIN_INTERVAL_MS;
+  return slotCount++;
+}
+
+// read-only lookup, safe from any task: slots are only added from loop()
+int TSWSendQueue::findSlot(const char *controller) const
+{
+  uint32_t h = tswHashName(controller);
+  for (uint8_t i = 0; i < slotCount; i++)
+    if (slots[i].hash == h && strcmp(slots[i].controller, controller) == 0)
+      return i;
+  return -1;
+}
+
+// --- TSWTransport ---
+int TSWSendQueue::bindController(const String &controller)
+{
+  if (target)
+    target->bindController(controller);
+  int index = findOrAddSlot(controller.c_str()); // slot exists before the first value
+  if (index < 0)
+    Serial.printf("[SendQueue] Cannot bind %s (%s), its values are dropped\n", controller.c_str(),
+                  controller.length() >= TSW_CONTROLLER_NAME_LEN ? "name longer than TSW_CONTROLLER_NAME_LEN - 1"
+                                                                 : "no free slot");
+  return index;
+}
+
+void TSWSendQueue::setPriority(const String &controller, TSWPriority priority)
+{
+  if (target)
+    target->setPriority(controller, priority);
+  int index = findOrAddSlot(controller.c_str());
+  if (index >= 0)
+    slots[index].priority = priority; // setup only, before the first value
+}
+
+bool TSWSendQueue::setControllerValue(const String &controller, float value)
+{
+  if (!queue)
+    return target ? target->setControllerValue(controller, value) : false;
+
+  int index = findOrAddSlot(controller.c_str());
+  if (index < 0)
+  {
+    portENTER_CRITICAL(&mux);
+    stats.dropped++;
+    portEXIT_CRITICAL(&mux);
+    TRACE_PRINT("[SendQueue] no free slot, dropped %s -> %.3f\n", controller.c_str(), value);
+    return false;
+  }
+
+  Slot &slot = slots[index];
+  bool enqueue = false;
+
+  portENTER_CRITICAL(&mux);
+  slot.value = value;
+  slot.updates++;
+  stats.enqueued++;
+  if (slot.pending)
+  {
+    slot.coalesced++;
+    stats.coalesced++;
+  }
+  else
+  {
+    slot.pending = true;
+    slot.pendingSinceUs = micros();
+    enqueue = true;
+  }
+  portEXIT_CRITICAL(&mux);
+
+  if (enqueue)
+  {
+    uint8_t idx = index;
+    xQueueSend(queue, &idx, 0);
+
+    uint16_t depth = uxQueueMessagesWaiting(queue);
+    portENTER_CRITICAL(&mux);
+    if (depth > stats.maxDepth)
+      stats.maxDepth = depth;
+    portEXIT_CRITICAL(&mux);
+  }
+  return true;
+}
+
+uint8_t TSWSendQueue::setControllerValues(TSWSetItem *items, uint8_t count)
+{
+  if (count == 0)
+    return 0;
+  // not started yet, or called by the network task itself: nothing to overtake
+  TaskHandle_t caller = xTaskGetCurrentTaskHandle();
+  if (!queue || caller == task)
+    return target ? target->setControllerValues(items, count) : 0;
+
+  // one batch at a time; a second caller waits for the first
+  while (true)
+  {
+    portENTER_CRITICAL(&mux);
+    bool claimed = batch == nullptr;
+    if (claimed)
+    {
+      batch = items;
+      batchCount = count;
+      batchCaller = caller;
+    }
+    portEXIT_CRITICAL(&mux);
+    if (claimed)
+      break;
+    vTaskDelay(1);
+  }
+
+  uint8_t marker = BATCH_INDEX;
+  xQueueSendToFront(queue, &marker, 0);
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+  portENTER_CRITICAL(&mux);
+  uint8_t delivered = batchDelivered;
+  batch = nullptr;
+  portEXIT_CRITICAL(&mux);
+  return delivered;
+}
+
+float TSWSendQueue::getControllerValue(const String &controller)
+{
+  return target ? target->getControllerValue(controller) : 0.0f;
+}
+
+// --- Statistics ---
+TSWSendQueue::Stats TSWSendQueue::getStats()
+{
+  portENTER_CRITICAL(&mux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&mux);
+  copy.depth = queue ? uxQueueMessagesWaiting(queue) : 0;
+  return copy;
+}
+
+bool TSWSendQueue::getControllerStats(uint8_t index, ControllerStats &out)
+{
+  if (index >= slotCount)
+    return false;
+
+  const Slot &slot = slots[index];
+  portENTER_CRITICAL(&mux);
+  out.controller = slot.controller;
+  out.value = slot.value;
+  out.updates = slot.updates;
+  out.coalesced = slot.coalesced;
+  out.sent = slot.sent;
+  out.deferred = slot.deferred;
+  out.intervalMs = slot.intervalMs;
+  out.priority = slot.priority;
+  uint32_t idle = millis() - slot.lastSendMs;
+  uint16_t gap = slot.avgGapMs;
+  portEXIT_CRITICAL(&mux);
+  out.rateHz = (slot.sent && gap && idle < TSW_RATE_WINDOW_MS) ? 1000.0f / gap : 0.0f;
+  return true;
+}
+
+// --- Network task ---
+void TSWSendQueue::taskEntry(void *arg)
+{
+  static_cast<TSWSendQueue *>(arg)->run();
+}
+
+void TSWSendQueue::run()
+{
+  uint8_t indices[TSW_PIPELINE_DEPTH];
+  TSWSetItem items[TSW_PIPELINE_DEPTH];
+  uint32_t since[TSW_PIPELINE_DEPTH];
+
+  uint32_t lastResyncMs = 0;
+
+  while (true)
+  {
+    // checked on every pass, so a steady stream of new values cannot starve it
+    if (resyncPending && millis() - lastResyncMs >= TSW_SEND_RESYNC_MS)
+    {
+      resyncPending = target->resync() > 0;
+      lastResyncMs = millis();
+    }
+
+    // new slots: high priority ones straight into the batch, the rest
+    // joins the waiting list behind the slots held back earlier
+    uint32_t now = millis();
+    TickType_t wait = resyncPending ? pdMS_TO_TICKS(TSW_SEND_RESYNC_MS) : portMAX_DELAY;
+    TickType_t due = nextDue(now);
+    if (due < wait)
+      wait = due;
+    uint8_t n = 0;
+    uint8_t index;
+    if (xQueueReceive(queue, &index, wait) == pdTRUE)
+    {
+      now = millis();
+      do
+      {
+        if (index == BATCH_INDEX)
+          sendBatch(); // ahead of the slots of this pass
+        else
+          admit(index, indices, n, now);
+      } while (xQueueReceive(queue, &index, 0) == pdTRUE);
+    }
+
+    // fill up with the waiting slots that are due, oldest first
+    uint8_t keep = 0;
+    for (uint8_t i = 0; i < waitingCount; i++)
+    {
+      if (n < TSW_PIPELINE_DEPTH && isDue(slots[waiting[i]], now))
+        indices[n++] = waiting[i];
+      else
+        waiting[keep++] = waiting[i];
+    }
+    waitingCount = keep;
+    if (n == 0)
+      continue;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < n; i++)
+    {
+      Slot &slot = slots[indices[i]];
+      items[i] = {slot.controller, slot.value, -1};
+      since[i] = slot.pendingSinceUs;
+      slot.pending = false; // from here on a new value queues the slot again
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // a high lane prefix goes out on its own, so its answer does not wait
+    // for the pipelined bulk values behind it
+    uint8_t high = 0;
+    while (high < n && slots[indices[high]].priority == TSW_PRIORITY_HIGH)
+      high++;
+    uint8_t split = high < n ? high : 0;
+    uint32_t highDoneUs = 0;
+    if (split > 0)
+    {
+      target->setControllerValues(items, split);
+      highDoneUs = micros();
+    }
+    uint32_t startUs = micros();
+    target->setControllerValues(items + split, n - split);
+    uint32_t doneUs = micros();
+    uint32_t rttUs = doneUs - startUs;
+    now = millis();
+
+    bool reached = false; // refused batches say nothing about the host's load
+    for (uint8_t i = 0; i < n; i++)
+    {
+      if (items[i].status < 0)
+        resyncPending = true;
+      if (items[i].status == TSW_STATUS_CIRCUIT_OPEN)
+      {
+        portENTER_CRITICAL(&mux);
+        stats.parked++;
+        portEXIT_CRITICAL(&mux);
+      }
+      else
+      {
+        recordSend(slots[indices[i]], (i < split ? highDoneUs : doneUs) - since[i],
+                   items[i].status == 200, now);
+        reached = true;
+      }
+    }
+    if (!reached)
+      continue;
+
+    adaptRate(rttUs, now);
+    uint16_t targetMs = stats.intervalMs; // only written by this task
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < n; i++)
+    {
+      if (items[i].status == TSW_STATUS_CIRCUIT_OPEN)
+        continue;
+      // back off fast, recover gently
+      uint16_t &interval = slots[indices[i]].intervalMs;
+      if (targetMs > interval)
+        interval += (targetMs - interval + 1) / 2;
+      else
+        interval -= (interval - targetMs) / 8;
+    }
+    portEXIT_CRITICAL(&mux);
+  }
+}
+
+void TSWSendQueue::sendBatch()
+{
+  portENTER_CRITICAL(&mux);
+  TSWSetItem *items = batch;
+  uint8_t count = batchCount;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    // a pending slot would send its older value after the batch
+    int index = findSlot(items[i].controller);
+    if (index >= 0 && slots[index].pending)
+    {
+      slots[index].value = items[i].value;
+      stats.superseded++;
+    }
+  }
+  portEXIT_CRITICAL(&mux);
+
+  uint8_t delivered = target->setControllerValues(items, count);
+  for (uint8_t i = 0; i < count; i++)
+    if (items[i].status < 0)
+      resyncPending = true;
+
+  portENTER_CRITICAL(&mux);
+  stats.batches++;
+  batchDelivered = delivered;
+  TaskHandle_t caller = batchCaller;
+  portEXIT_CRITICAL(&mux);
+  xTaskNotifyGive(caller);
+}
+
+// --- Lanes and rate limit ---
+bool TSWSendQueue::isDue(const Slot &slot, uint32_t now) const
+{
+  return slot.priority == TSW_PRIORITY_HIGH || now - slot.lastSendMs >= slot.intervalMs;
+}
+
+void TSWSendQueue::admit(uint8_t index, uint8_t *indices, uint8_t &n, uint32_t now)
+{
+  Slot &slot = slots[index];
+  if (slot.priority == TSW_PRIORITY_HIGH && n < TSW_PIPELINE_DEPTH)
+  {
+    indices[n++] = index; // ahead of every bulk slot of this batch
+    return;
+  }
+
+  waiting[waitingCount++] = index; // one entry per slot, the slot stays pending
+  if (isDue(slot, now))
+    return;
+  portENTER_CRITICAL(&mux);
+  slot.deferred++;
+  stats.deferred++;
+  portEXIT_CRITICAL(&mux);
+}
+
+TickType_t TSWSendQueue::nextDue(uint32_t now) const
+{
+  if (waitingCount == 0)
+    return portMAX_DELAY;
+
+  uint32_t soonest = TSW_RATE_MAX_INTERVAL_MS;
+  for (uint8_t i = 0; i < waitingCount; i++)
+  {
+    const Slot &slot = slots[waiting[i]];
+    if (isDue(slot, now))
+      return 0;
+    uint32_t left = slot.intervalMs - (now - slot.lastSendMs);
+    if (left < soonest)
+      soonest = left;
+  }
+  TickType_t ticks = pdMS_TO_TICKS(soonest);
+  return ticks ? ticks : 1;
+}
+
+void TSWSendQueue::adaptRate(uint32_t rttUs, uint32_t now)
+{
+  uint8_t active = 0;
+  for (uint8_t i = 0; i < slotCount; i++)
+    if (slots[i].sent && now - slots[i].lastSendMs < TSW_RATE_WINDOW_MS)
+      active++;
+
+  uint32_t rtt = stats.rttUs ? stats.rttUs - (stats.rttUs >> 3) + (rttUs >> 3) : rttUs;
+
+  // Little's law: budget requests in flight allow budget / RTT requests per
+  // second, shared by the active controllers
+  uint32_t target = (uint32_t)active * rtt / (1000u * TSW_RATE_BUDGET);
+  if (target < TSW_RATE_MIN_INTERVAL_MS)
+    target = TSW_RATE_MIN_INTERVAL_MS;
+  if (target > TSW_RATE_MAX_INTERVAL_MS)
+    target = TSW_RATE_MAX_INTERVAL_MS;
+
+  portENTER_CRITICAL(&mux);
+  stats.rttUs = rtt;
+  stats.active = active;
+  stats.intervalMs = target;
+  portEXIT_CRITICAL(&mux);
+}
+
+void TSWSendQueue::recordSend(Slot &slot, uint32_t latency, bool ok, uint32_t now)
+{
+  uint32_t gap = now - slot.lastSendMs;
+
+  portENTER_CRITICAL(&mux);
+  // the first send after a quiet phase starts a new rate measurement
+  if (!slot.sent || gap >= TSW_RATE_WINDOW_MS)
+    slot.avgGapMs = 0;
+  else
+    slot.avgGapMs = slot.avgGapMs ? slot.avgGapMs - (slot.avgGapMs >> 2) + (gap >> 2) : gap;
+  slot.lastSendMs = now;
+  slot.sent++;
+  if (ok)
+    stats.sent++;
+  else
+    stats.failed++;
+  stats.lastLatencyUs = latency;
+  stats.avgLatencyUs = stats.avgLatencyUs
+                           ? stats.avgLatencyUs - (stats.avgLatencyUs >> 3) + (latency >> 3)
+                           : latency;
+  if (latency > stats.maxLatencyUs)
+    stats.maxLatencyUs = latency;
+  if (slot.priority == TSW_PRIORITY_HIGH)
+  {
+    stats.highSent++;
+    stats.highAvgLatencyUs = stats.highAvgLatencyUs
+                                 ? stats.highAvgLatencyUs - (stats.highAvgLatencyUs >> 3) + (latency >> 3)
+                                 : latency;
+    if (latency > stats.highMaxLatencyUs)
+      stats.highMaxLatencyUs = latency;
+    if (latency > TSW_PRIORITY_BUDGET_MS * 1000u)
+      stats.highOverBudget++;
+  }
+  portEXIT_CRITICAL(&mux);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file TSWSendQueue.h
+ * @brief Asynchronous outbound queue between the controls and TSWSpider.
+ *
+ * @details
+ * A TSWTransport for the controls: setControllerValue() stores the value in
+ * the controller's slot (latest value wins) and returns at once, a network
+ * task forwards all waiting slots in one batch to the wrapped transport.
+ * The task limits the send rate per controller from the measured round
+ * trip, serves the high priority lane first and calls resync() until
+ * nothing is left undelivered. setControllerValues() sends an ordered batch
+ * (macros) ahead of the slots and waits for the answers; call it from a
+ * task. Reads are passed through.
+ *
+ * Example:
+ * @code
+ *   TSWSpider spider;
+ *   TSWSendQueue queue(&spider);
+ *   spider.begin("192.168.4.2");
+ *   queue.begin();
+ *   TSWLever throttle(A0, "Throttle", &queue);
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.10
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "TSWTransport.h"
+#include "../config.h"
+
+#ifndef TSW_SEND_SLOTS
+#define TSW_SEND_SLOTS 48
+#endif
+#ifndef TSW_SEND_TASK_CORE
+#define TSW_SEND_TASK_CORE 0
+#endif
+#ifndef TSW_SEND_TASK_STACK
+#define TSW_SEND_TASK_STACK 4096
+#endif
+#ifndef TSW_SEND_TASK_PRIO
+#define TSW_SEND_TASK_PRIO 2
+#endif
+#ifndef TSW_PIPELINE_DEPTH
+#define TSW_PIPELINE_DEPTH 8
+#endif
+#ifndef TSW_SEND_RESYNC_MS
+#define TSW_SEND_RESYNC_MS 100
+#endif
+#ifndef TSW_RATE_BUDGET
+#define TSW_RATE_BUDGET 4
+#endif
+#ifndef TSW_RATE_MIN_INTERVAL_MS
+#define TSW_RATE_MIN_INTERVAL_MS 20
+#endif
+#ifndef TSW_RATE_MAX_INTERVAL_MS
+#define TSW_RATE_MAX_INTERVAL_MS 1000
+#endif
+#ifndef TSW_RATE_WINDOW_MS
+#define TSW_RATE_WINDOW_MS 1000
+#endif
+#ifndef TSW_PRIORITY_BUDGET_MS
+#define TSW_PRIORITY_BUDGET_MS 50
+#endif
+#define TSW_CONTROLLER_NAME_LEN 48
+
+class TSWSendQueue : public TSWTransport {
+public:
+  struct Stats {
+    uint32_t enqueued = 0;      // updates accepted from the controls
+    uint32_t coalesced = 0;     // updates that overwrote a still pending value
+    uint32_t sent = 0;          // updates delivered successfully
+    uint32_t failed = 0;        // updates the transport could not deliver
+    uint32_t dropped = 0;       // updates rejected because no slot was free
+    uint32_t parked = 0;        // updates refused while the TSW host was down, left to resync()
+    uint16_t depth = 0;         // controllers currently waiting
+    uint16_t maxDepth = 0;      // high-water mark of depth
+    uint32_t lastLatencyUs = 0; // enqueue-to-answer of the latest update
+    uint32_t avgLatencyUs = 0;  // moving average (1/8 weight)
+    uint32_t maxLatencyUs = 0;
+    uint32_t deferred = 0;      // values held back until their controller was due
+    uint32_t rttUs = 0;         // smoothed round-trip time of a batch (1/8 weight)
+    uint16_t intervalMs = 0;    // current target interval per active controller
+    uint8_t active = 0;         // controllers sent within the last TSW_RATE_WINDOW_MS
+    uint32_t highSent = 0;      // high priority updates sent
+    uint32_t highAvgLatencyUs = 0; // enqueue-to-answer of high priority updates (1/8 weight)
+    uint32_t highMaxLatencyUs = 0;
+    uint32_t highOverBudget = 0; // high priority updates slower than TSW_PRIORITY_BUDGET_MS
+    uint32_t batches = 0;       // setControllerValues() batches sent ahead of the slots
+    uint32_t superseded = 0;    // pending slot values replaced by a batch value
+  };
+
+  struct ControllerStats {
+    const char *controller;
+    float value;                // latest value handed in
+    uint32_t updates;           // values handed in by the control
+    uint32_t coalesced;         // values overwritten before they were sent
+    uint32_t sent;              // requests actually sent
+    uint32_t deferred;          // values held back by the rate limit
+    uint16_t intervalMs;        // minimum interval between two sends
+    float rateHz;               // effective send rate, 0 when idle
+    TSWPriority priority;
+  };
+
+private:
+  struct Slot {
+    char controller[TSW_CONTROLLER_NAME_LEN];
+    uint32_t hash;
+    float value;
+    bool pending;               // queued, waiting for the network task
+    uint32_t pendingSinceUs;
+    uint32_t updates;
+    uint32_t coalesced;
+    uint32_t sent;
+    uint32_t deferred;
+    uint32_t lastSendMs;        // network task only, like the two below
+    uint16_t intervalMs;
+    uint16_t avgGapMs;          // smoothed time between two sends (1/4 weight)
+    TSWPriority priority;
+  };
+
+  TSWTransport *target;
+  QueueHandle_t queue = nullptr;
+  TaskHandle_t task = nullptr;
+  Slot slots[TSW_SEND_SLOTS];
+  uint8_t slotCount = 0;
+  bool resyncPending = false;   // only touched by the network task
+  uint8_t waiting[TSW_SEND_SLOTS]; // pending slots not yet due, network task only
+  uint8_t waitingCount = 0;
+  Stats stats;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  // setControllerValues() batch, handed to the network task
+  static const uint8_t BATCH_INDEX = 0xFF; // queued in place of a slot index
+  TSWSetItem *batch = nullptr;  // claimed under mux, one batch at a time
+  uint8_t batchCount = 0;
+  uint8_t batchDelivered = 0;
+  TaskHandle_t batchCaller = nullptr;
+
+  int findOrAddSlot(const char *controller);
+  int findSlot(const char *controller) const;
+  void sendBatch();
+  static void taskEntry(void *arg);
+  void run();
+  void recordSend(Slot &slot, uint32_t latencyUs, bool ok, uint32_t now);
+  bool isDue(const Slot &slot, uint32_t now) const;
+  void admit(uint8_t index, uint8_t *indices, uint8_t &n, uint32_t now);
+  TickType_t nextDue(uint32_t now) const;
+  void adaptRate(uint32_t rttUs, uint32_t now);
+
+public:
+  explicit TSWSendQueue(TSWTransport *transport) : target(transport) {}
+
+  bool begin();
+  bool isRunning() const { return task != nullptr; }
+
+  // --- TSWTransport ---
+  bool setControllerValue(const String &controller, float value) override;
+  float getControllerValue(const String &controller) override;
+  int bindController(const String &controller) override;
+  void setPriority(const String &controller, TSWPriority priority) override;
+  void setDeliveryHandler(TSWDeliveryHandler handler) override
+  {
+    if (target)
+      target->setDeliveryHandler(handler);
+  }
+  uint8_t setControllerValues(TSWSetItem *items, uint8_t count) override;
+
+  Stats getStats();
+  uint8_t getControllerCount() const { return slotCount; }
+  bool getControllerStats(uint8_t index, ControllerStats &out);
+};
@@ -0,0 +1,43 @@
+/**
+ * @file TSWSerialTransport.cpp
+ * @brief Implementation of the SLIP framed serial transport to the PC bridge.
+ *
+ * @details
+ * Frames are written with a single write() from a stack buffer, so log
+ * output from the same task cannot end up inside a frame.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSWSerialTransport.h"
+
+void TSWSerialTransport::begin()
+{
+  start();
+  TRACE_PRINT("[Serial] Bridge link started\n");
+}
+
+bool TSWSerialTransport::writeMessage(const uint8_t *buf, uint16_t len)
+{
+  uint8_t frame[TSW_SLIP_FRAME_LEN(TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_BATCH * TSW_WIRE_ITEM_LEN)];
+  if ((size_t)TSW_SLIP_FRAME_LEN(len) > sizeof(frame))
+    return false;
+  uint16_t n = TSWWire::slipEncode(frame, buf, len);
+  return port.write(frame, n) == n;
+}
+
+uint16_t TSWSerialTransport::readMessage(uint8_t *buf, uint16_t size)
+{
+  while (port.available() > 0)
+  {
+    uint16_t len = decoder.feed((uint8_t)port.read());
+    if (len > 0 && len <= size)
+    {
+      memcpy(buf, decoder.buf, len);
+      return len;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file TSWSerialTransport.h
+ * @brief Binary transport to the PC bridge over the USB-serial UART.
+ *
+ * @details
+ * For panels wired to the game PC: TSWWire messages are sent as SLIP frames
+ * with CRC over the existing UART (Serial), so there is no WiFi jitter at
+ * all. The bridge (Bridge/tsw_bridge.py --serial COM3) reads the frames and
+ * forwards them to TSW.
+ *
+ * Log output (Serial.print / TRACE_PRINT) may keep using the same UART:
+ * frames start and end with the SLIP END byte, which never occurs in text,
+ * and text between frames fails the CRC. The bridge prints it as device log.
+ *
+ * The UART runs at TSW_SERIAL_BAUD (config.h), set the serial monitor to
+ * the same rate.
+ *
+ * Example:
+ * @code
+ *   TSWSerialTransport link(Serial);
+ *   Serial.begin(TSW_SERIAL_BAUD);
+ *   link.begin();
+ *   TSWLever throttle(A0, "Throttle", &link);
+ *   ...
+ *   void loop() { link.update(); throttle.updateAndSend(); }
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TSWWireTransport.h"
+#include "../config.h"
+
+class TSWSerialTransport : public TSWWireTransport {
+private:
+  Stream &port;
+  TSWSlipDecoder<TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_UPDATE_MAX * TSW_WIRE_ITEM_LEN> decoder; // bridge -> device messages are short
+
+protected:
+  bool writeMessage(const uint8_t *buf, uint16_t len) override;
+  uint16_t readMessage(uint8_t *buf, uint16_t size) override;
+
+public:
+  explicit TSWSerialTransport(Stream &stream) : port(stream) {}
+
+  void begin();
+  uint32_t getBadFrames() const { return decoder.badFrames; }
+};
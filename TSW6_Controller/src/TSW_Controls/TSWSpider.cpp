@@ -8,48 +8,739 @@
  *   /set/ControllerValue/<Controller>/<Value>
  *   /get/CurrentDrivableActor/<Controller>
  *
+ * Reads are looked up in the read cache first (under stateMux, like the
+ * route table); a miss marks its entry in flight and fetches outside the
+ * lock, so readers of other paths are not held up. Entries are claimed in
+ * order and, once the cache is full, the one fetched longest ago that is
+ * neither pinned nor in flight is reused.
+ *
+ * A read answer is either the bare number or the JSON document of the game
+ * ({"Result":"Success","Values":{"<property>":0.5}}); scanValue() walks it
+ * on the socket up to the first value of "Values" and stops there.
+ *
+ * Connections are kept alive between requests. A request on a reused socket
+ * that fails before any response arrives is retried once on a new socket,
+ * because the server may have closed the idle connection in the meantime.
+ *
+ * Batched sets are pipelined: up to TSW_PIPELINE_DEPTH requests are written
+ * back-to-back on one socket and the responses are read in order afterwards.
+ * If the server closes the connection part-way, the unanswered requests are
+ * sent again on a new socket.
+ *
+ * Set requests are assembled without heap allocations from the header
+ * buffer, the route table and a fixed-point value string.
+ *
+ * Each batch or request asks the circuit breaker first and reports back
+ * whether the host answered at all; HTTP error codes count as an answer.
+ *
+ * Desired state: every item is recorded in its route (value, dirty) before
+ * it is sent and marked clean when the host answered it, unless a newer
+ * value arrived in the meantime. An item that got an HTTP error is clean as
+ * well, sending it again would not change the answer.
+ *
+ * Sets come from several tasks (send queue, macros, loop), so whether a
+ * batch is a replay travels with the call, and resync() claims the single
+ * replay slot under stateMux: a second task finding a replay running leaves
+ * the dirty entries to it. Routes count the batches carrying them, so a
+ * replay never duplicates a set that is still on the wire; whichever batch
+ * fails leaves its value dirty for the next resync(). Stats are counted
+ * under stateMux as well and getStats() hands out a copy.
+ *
  * @note
  * Designed for ESP32 / ESP8266 based controllers.
  *
  * @author Felix Lindemann
  * @date 2025-10-26
- * @version 1.0
+ * @version 1.14
  */
 
 #include "TSWSpider.h"
+#include "TSWSubscription.h"
 
 void TSWSpider::begin(const String &ip, uint16_t p) {
   host = ip;
   port = p;
-  Serial.printf("[Spider] Initialized for host %s:%u\n", host.c_str(), port);
+  for (auto &conn : connections)
+    conn.close();
+  buildHeaderBlock();
+  Serial.printf("[Spider] Initialized for host %s:%u (%u keep-alive connections)\n",
+                host.c_str(), port, TSW_SPIDER_CONNECTIONS);
+}
+
+// Switches to another host at runtime (discovery found a new address): every
+// connection is taken out of the pool first, so no request is in flight while
+// host and header block change. Senders wait in acquire() meanwhile.
+void TSWSpider::retarget(const String &ip, uint16_t p) {
+  for (int i = 0; i < TSW_SPIDER_CONNECTIONS; i++) {
+    while (true) {
+      portENTER_CRITICAL(&poolMux);
+      bool taken = !busy[i];
+      busy[i] = true;
+      portEXIT_CRITICAL(&poolMux);
+      if (taken)
+        break;
+      delay(1);
+    }
+  }
+
+  host = ip;
+  port = p;
+  for (auto &conn : connections)
+    conn.close();
+  buildHeaderBlock();
+
+  portENTER_CRITICAL(&poolMux);
+  for (int i = 0; i < TSW_SPIDER_CONNECTIONS; i++)
+    busy[i] = false;
+  portEXIT_CRITICAL(&poolMux);
+  Serial.printf("[Spider] Switched to host %s:%u\n", host.c_str(), port);
+}
+
+void TSWSpider::setCommKey(const String &key) {
+  commKey = key;
+  buildHeaderBlock();
+}
+
+void TSWSpider::buildHeaderBlock() {
+  int n;
+  if (commKey.length())
+    n = snprintf(header, sizeof(header),
+                 " HTTP/1.1\r\nHost: %s:%u\r\nConnection: keep-alive\r\nDTGCommKey: %s\r\n\r\n",
+                 host.c_str(), port, commKey.c_str());
+  else
+    n = snprintf(header, sizeof(header),
+                 " HTTP/1.1\r\nHost: %s:%u\r\nConnection: keep-alive\r\n\r\n",
+                 host.c_str(), port);
+
+  if (n < 0 || n >= (int)sizeof(header)) {
+    Serial.println("[Spider] Header too long, increase TSW_HEADER_LEN");
+    n = snprintf(header, sizeof(header), " HTTP/1.1\r\n\r\n");
+  }
+  headerLen = n;
+}
+
+// --- Route table ---
+int TSWSpider::bindController(const String &controller) {
+  return addRoute(controller.c_str());
+}
+
+int TSWSpider::addRoute(const char *controller) {
+  int index = findRoute(controller);
+  if (index >= 0)
+    return index;
+  if (routeCount >= TSW_SPIDER_ROUTES)
+    return -1;
+
+  Route route = {};
+  int n = snprintf(route.line, sizeof(route.line), "GET /set/ControllerValue/%s", controller);
+  if (n < 0 || n + 1 >= (int)sizeof(route.line))
+    return -1; // name too long, sent through the unbound path
+  route.len = n;
+  route.hash = tswHashName(controller);
+
+  // bound during setup or on the first set from the network task; the entry
+  // is complete before it becomes visible
+  portENTER_CRITICAL(&stateMux);
+  index = findRoute(controller);
+  if (index < 0 && routeCount < TSW_SPIDER_ROUTES) {
+    routes[routeCount] = route;
+    index = routeCount++;
+  }
+  portEXIT_CRITICAL(&stateMux);
+  return index;
+}
+
+int TSWSpider::findRoute(const char *controller) const {
+  uint32_t h = tswHashName(controller);
+  size_t len = strlen(controller);
+  for (uint8_t i = 0; i < routeCount; i++) {
+    const Route &r = routes[i];
+    // line = "GET /set/ControllerValue/" + controller
+    if (r.hash == h && r.len == 25 + len && memcmp(r.name(), controller, len) == 0)
+      return i;
+  }
+  return -1;
+}
+
+// --- Desired state ---
+void TSWSpider::remember(const TSWSetItem &item) {
+  int index = findRoute(item.controller);
+  if (index < 0)
+    index = addRoute(item.controller);
+  if (index < 0)
+    return; // table full, this controller is not resynced
+
+  portENTER_CRITICAL(&stateMux);
+  routes[index].value = item.value;
+  routes[index].dirty = true;
+  routes[index].inFlight++;
+  portEXIT_CRITICAL(&stateMux);
+}
+
+// every sent item comes back here once, answered or not
+void TSWSpider::settle(const TSWSetItem &item) {
+  int index = findRoute(item.controller);
+  if (index < 0)
+    return;
+
+  portENTER_CRITICAL(&stateMux);
+  Route &r = routes[index];
+  if (r.inFlight > 0)
+    r.inFlight--;
+  if (item.status >= 0 && r.value == item.value)
+    r.dirty = false; // a value that never reached the host stays dirty
+  uint32_t hash = r.hash;
+  portEXIT_CRITICAL(&stateMux);
+  if (item.status >= 0 && deliveryHandler)
+    deliveryHandler(hash, item.value);
+}
+
+const char *TSWSpider::getRouteName(uint8_t index) const {
+  return index < routeCount ? routes[index].name() : nullptr;
+}
+
+void TSWSpider::setRouteKnown(uint8_t index, bool known) {
+  if (index >= routeCount)
+    return;
+  portENTER_CRITICAL(&stateMux);
+  if (routes[index].unknown != !known) {
+    routes[index].unknown = !known;
+    if (!known)
+      routes[index].dirty = false; // nothing to replay for a controller TSW does not have
+    unknownCount += known ? -1 : 1;
+  }
+  portEXIT_CRITICAL(&stateMux);
+}
+
+// dirty entries no batch is carrying right now, i.e. what resync() would send
+uint8_t TSWSpider::getDirtyCount() {
+  uint8_t n = 0;
+  portENTER_CRITICAL(&stateMux);
+  for (uint8_t i = 0; i < routeCount; i++)
+    if (routes[i].dirty && routes[i].inFlight == 0)
+      n++;
+  portEXIT_CRITICAL(&stateMux);
+  return n;
+}
+
+uint8_t TSWSpider::resync() {
+  TSWSetItem items[TSW_SPIDER_ROUTES];
+  uint8_t n = 0;
+  bool claimed = false;
+  portENTER_CRITICAL(&stateMux);
+  for (uint8_t i = 0; i < routeCount; i++)
+    if (routes[i].dirty && routes[i].inFlight == 0)
+      items[n++] = {routes[i].name(), routes[i].value, -1};
+  if (n > 0 && !resyncing) {
+    resyncing = true; // one replay at a time, whichever task comes first
+    claimed = true;
+    for (uint8_t i = 0; i < routeCount; i++)
+      if (routes[i].dirty && routes[i].inFlight == 0)
+        routes[i].inFlight++; // carried by this replay now
+  }
+  portEXIT_CRITICAL(&stateMux);
+  if (!claimed)
+    return n; // nothing dirty, or another task is replaying right now
+
+  // one pipelined batch, a refused circuit costs nothing
+  sendBatch(items, n, true);
+
+  uint8_t answered = 0;
+  for (uint8_t i = 0; i < n; i++)
+    if (items[i].status >= 0)
+      answered++;
+  portENTER_CRITICAL(&stateMux);
+  resyncing = false;
+  if (answered > 0) {
+    stats.resyncs++;
+    stats.replayed += answered;
+  }
+  portEXIT_CRITICAL(&stateMux);
+  if (answered > 0)
+    Serial.printf("[Spider] Resynced %u of %u controllers after reconnect\n", answered, n);
+  return getDirtyCount();
+}
+
+void TSWSpider::countStat(uint32_t Stats::*counter, uint32_t n) {
+  portENTER_CRITICAL(&stateMux);
+  stats.*counter += n;
+  portEXIT_CRITICAL(&stateMux);
+}
+
+TSWSpider::Stats TSWSpider::getStats() {
+  portENTER_CRITICAL(&stateMux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&stateMux);
+  return copy;
+}
+
+// Fixed-point with three decimals, same output as String(value, 3) but
+// without going through the allocating float conversion of the libc.
+uint8_t TSWSpider::formatValue(char *buf, float value) {
+  if (!isfinite(value) || fabsf(value) >= 2.0e6f)
+    return snprintf(buf, 16, "%.3f", value);
+
+  char *p = buf;
+  int32_t milli = lroundf(value * 1000.0f);
+  if (milli < 0) {
+    *p++ = '-';
+    milli = -milli;
+  }
+
+  char digits[10];
+  uint8_t n = 0;
+  uint32_t whole = milli / 1000;
+  do {
+    digits[n++] = '0' + whole % 10;
+    whole /= 10;
+  } while (whole);
+  while (n)
+    *p++ = digits[--n];
+
+  uint32_t frac = milli % 1000;
+  *p++ = '.';
+  *p++ = '0' + frac / 100;
+  *p++ = '0' + frac / 10 % 10;
+  *p++ = '0' + frac % 10;
+  *p = '\0';
+  return p - buf;
+}
+
+void TSWSpider::appendSet(TSWHttpConnection *conn, const TSWSetItem &item) {
+  int route = findRoute(item.controller);
+  if (route >= 0) {
+    conn->append(routes[route].line, routes[route].len);
+  } else {
+    conn->append("GET /set/ControllerValue/", 25);
+    conn->append(item.controller, strlen(item.controller));
+  }
+  conn->append("/", 1);
+
+  char value[16];
+  conn->append(value, formatValue(value, item.value));
+  conn->append(header, headerLen);
+}
+
+// --- Connection pool ---
+TSWHttpConnection *TSWSpider::acquire() {
+  unsigned long start = millis();
+  while (true) {
+    int pick = -1;
+    portENTER_CRITICAL(&poolMux);
+    // prefer an idle socket that is still open, otherwise any idle slot
+    for (int i = 0; i < TSW_SPIDER_CONNECTIONS; i++) {
+      if (busy[i])
+        continue;
+      if (pick < 0 || connections[i].canReuse())
+        pick = i;
+    }
+    if (pick >= 0)
+      busy[pick] = true;
+    portEXIT_CRITICAL(&poolMux);
+
+    if (pick >= 0)
+      return &connections[pick];
+    if (millis() - start > TSW_RESPONSE_TIMEOUT_MS)
+      return nullptr;
+    delay(1);
+  }
+}
+
+void TSWSpider::release(TSWHttpConnection *conn) {
+  portENTER_CRITICAL(&poolMux);
+  busy[conn - connections] = false;
+  portEXIT_CRITICAL(&poolMux);
+}
+
+uint8_t TSWSpider::getOpenConnections() {
+  uint8_t n = 0;
+  for (auto &conn : connections)
+    if (conn.isOpen())
+      n++;
+  return n;
+}
+
+// --- Request / response on a pooled connection ---
+int TSWSpider::exchange(TSWHttpConnection *conn, const char *method, const char *path) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!conn->open(host.c_str(), port, TSW_CONNECT_TIMEOUT_MS))
+      break;
+
+    bool reused = conn->wasReused();
+    countStat(reused ? &Stats::reused : &Stats::connects);
+
+    int code = -1;
+    conn->append(method, strlen(method));
+    conn->append(" ", 1);
+    conn->append(path, strlen(path));
+    conn->append(header, headerLen);
+    if (conn->commit())
+      code = conn->readResponseHead(TSW_RESPONSE_TIMEOUT_MS);
+
+    if (code > 0) {
+      countStat(&Stats::requests);
+      return code;
+    }
+
+    conn->close();
+    if (!reused)
+      break;
+    countStat(&Stats::retries); // idle socket was closed by the server, try a fresh one
+  }
+
+  countStat(&Stats::failures);
+  return -1;
 }
 
 bool TSWSpider::setControllerValue(const String &controller, float value) {
-  String url = "http://" + host + ":" + String(port) +
-               "/set/ControllerValue/" + controller + "/" + String(value, 3);
+  TSWSetItem item = {controller.c_str(), value, -1};
+  return setControllerValues(&item, 1) == 1;
+}
+
+// --- Pipelined sets ---
+uint8_t TSWSpider::setControllerValues(TSWSetItem *items, uint8_t count) {
+  portENTER_CRITICAL(&stateMux);
+  bool anyUnknown = unknownCount > 0;
+  portEXIT_CRITICAL(&stateMux);
+  if (!anyUnknown)
+    return sendBatch(items, count, false);
+
+  // controllers the endpoint index does not know are answered right here
+  // instead of costing a round trip for a 404 each
+  TSWSetItem known[TSW_PIPELINE_DEPTH];
+  uint8_t from[TSW_PIPELINE_DEPTH];
+  uint8_t ok = 0;
+  uint8_t i = 0;
+  while (i < count) {
+    uint8_t k = 0;
+    for (; i < count && k < TSW_PIPELINE_DEPTH; i++) {
+      int route = findRoute(items[i].controller);
+      bool unknown = false;
+      if (route >= 0) {
+        portENTER_CRITICAL(&stateMux);
+        unknown = routes[route].unknown;
+        portEXIT_CRITICAL(&stateMux);
+      }
+      if (unknown) {
+        items[i].status = 404;
+        countStat(&Stats::rejected);
+        continue;
+      }
+      known[k] = items[i];
+      from[k++] = i;
+    }
+    if (k == 0)
+      continue;
+    ok += sendBatch(known, k, false);
+    for (uint8_t j = 0; j < k; j++)
+      items[from[j]].status = known[j].status;
+  }
+  return ok;
+}
 
-  HTTPClient http;
-  http.begin(url);
-  int code = http.GET();
-  http.end();
+// replay: items come from resync(), their routes already hold the values
+uint8_t TSWSpider::sendBatch(TSWSetItem *items, uint8_t count, bool replay) {
+  for (uint8_t i = 0; i < count; i++) {
+    items[i].status = -1;
+    if (!replay)
+      remember(items[i]);
+  }
+
+  TSWHttpConnection *conn = acquire();
+  if (!conn) {
+    countStat(&Stats::failures, count);
+    for (uint8_t i = 0; i < count; i++)
+      settle(items[i]);
+    return 0;
+  }
+  if (!breaker.allow()) {
+    release(conn); // host is down, fail fast
+    for (uint8_t i = 0; i < count; i++) {
+      items[i].status = TSW_STATUS_CIRCUIT_OPEN;
+      settle(items[i]);
+    }
+    return 0;
+  }
+
+  uint8_t done = 0;  // items before this index have been answered
+  uint8_t ok = 0;
+  bool retried = false;
+
+  while (done < count) {
+    if (!conn->open(host.c_str(), port, TSW_CONNECT_TIMEOUT_MS))
+      break;
+
+    bool reused = conn->wasReused();
+    countStat(reused ? &Stats::reused : &Stats::connects);
+
+    // write up to TSW_PIPELINE_DEPTH requests before reading any response
+    uint8_t n = count - done;
+    if (n > TSW_PIPELINE_DEPTH)
+      n = TSW_PIPELINE_DEPTH;
+    for (uint8_t i = done; i < done + n; i++)
+      appendSet(conn, items[i]);
+
+    uint8_t answered = 0;
+    if (conn->commit()) {
+      if (n > 1)
+        countStat(&Stats::pipelined, n);
+      // responses arrive in request order
+      while (answered < n) {
+        int code = conn->readResponseHead(TSW_RESPONSE_TIMEOUT_MS);
+        if (code < 0)
+          break;
+        items[done + answered].status = code;
+        countStat(&Stats::requests);
+        if (code == 200)
+          ok++;
+        answered++;
+        conn->discardBody();
+        if (answered < n && !conn->canReuse())
+          break; // server closed after this response, resend the rest
+      }
+    }
 
-  Serial.printf("[Spider] %s -> %s (HTTP %d)\n",
-                controller.c_str(), url.c_str(), code);
-  return code == 200;
+    if (answered < n)
+      conn->close();
+    if (answered > 0) {
+      done += answered;
+      continue;
+    }
+
+    // nothing answered: a stale keep-alive socket gets one fresh attempt
+    if (!reused || retried)
+      break;
+    retried = true;
+    countStat(&Stats::retries);
+  }
+  release(conn);
+  if (done > 0)
+    breaker.success();
+  else
+    breaker.failure();
+
+  countStat(&Stats::failures, count - done);
+  for (uint8_t i = 0; i < count; i++) {
+    settle(items[i]);
+    TRACE_PRINT("[Spider] %s -> %.3f (HTTP %d)\n",
+                items[i].controller, items[i].value, items[i].status);
+  }
+
+  // the host answers again: catch up on what was missed while it did not
+  if (done > 0 && !replay && getDirtyCount() > 0)
+    resync();
+  return ok;
 }
 
 float TSWSpider::getControllerValue(const String &controller) {
-  String url = "http://" + host + ":" + String(port) +
-               "/get/CurrentDrivableActor/" + controller;
+  const char *name = controller.c_str();
+
+  // a subscribed controller comes with the bulk poll, no request of its own
+  if (subscription) {
+    char path[TSW_SUBSCRIPTION_PATH_LEN];
+    float val;
+    int n = snprintf(path, sizeof(path), TSW_SUBSCRIPTION_ACTOR "%s", name);
+    if (n < (int)sizeof(path) && subscription->read(path, val)) {
+      countStat(&Stats::subscribed);
+      return val;
+    }
+  }
+
+  uint32_t hash = tswHashName(name);
+  uint32_t now = millis();
+  int e = -1;
+  bool fetch = false;
+
+  portENTER_CRITICAL(&stateMux);
+  if (TSW_READ_CACHE > 0) {
+    e = findRead(hash, name);
+    if (e >= 0 && cache[e].ttlMs == 0) {
+      e = -1; // cached entry of an uncached path, it only holds the TTL
+    } else if (e >= 0 && !cache[e].inFlight && cache[e].valid && now - cache[e].fetchedMs < cache[e].ttlMs) {
+      uint32_t age = now - cache[e].fetchedMs;
+      float val = cache[e].value;
+      stats.cacheHits++;
+      stats.cacheAgeSumMs += age;
+      if (age > stats.cacheAgeMaxMs)
+        stats.cacheAgeMaxMs = age;
+      portEXIT_CRITICAL(&stateMux);
+      return val;
+    } else if (e >= 0 && cache[e].inFlight) {
+      stats.cacheShared++;
+    } else {
+      if (e < 0)
+        e = claimRead(hash, name);
+      if (e >= 0) {
+        cache[e].inFlight = true;
+        stats.cacheMisses++;
+        fetch = true;
+      }
+    }
+  }
+  portEXIT_CRITICAL(&stateMux);
+
+  bool ok;
+  if (e < 0) // not cacheable: uncached path, long name or a full cache
+    return fetchValue(controller, ok);
+
+  if (fetch) {
+    float val = fetchValue(controller, ok);
+    portENTER_CRITICAL(&stateMux);
+    cache[e].value = val;
+    cache[e].valid = ok;
+    cache[e].fetchedMs = millis();
+    cache[e].inFlight = false;
+    portEXIT_CRITICAL(&stateMux);
+    return val;
+  }
+
+  // another reader is fetching this path: wait for its answer
+  uint32_t start = millis();
+  while (true) {
+    portENTER_CRITICAL(&stateMux);
+    bool done = !cache[e].inFlight;
+    float val = cache[e].valid ? cache[e].value : 0.0f;
+    bool same = cache[e].hash == hash;
+    portEXIT_CRITICAL(&stateMux);
+    if (done && same)
+      return val;
+    if (done || millis() - start > 2 * TSW_RESPONSE_TIMEOUT_MS)
+      return fetchValue(controller, ok); // entry reused meanwhile, or the reader hangs
+    delay(1);
+  }
+}
+
+float TSWSpider::fetchValue(const String &controller, bool &ok) {
+  ok = false;
+  char path[TSW_ROUTE_LEN]; // formatted on the stack like a set route, no heap per read
+  int n = snprintf(path, sizeof(path), "/get/CurrentDrivableActor/%s", controller.c_str());
+  if (n < 0 || n >= (int)sizeof(path)) {
+    Serial.printf("[Spider] Controller name too long to read: %s\n", controller.c_str());
+    return 0.0f;
+  }
+  int code;
+  TSWHttpConnection *conn = beginRequest("GET", path, code);
+  if (!conn)
+    return 0.0f;
 
-  HTTPClient http;
-  http.begin(url);
-  int code = http.GET();
   float val = 0.0f;
   if (code == 200) {
-    String payload = http.getString();
-    val = payload.toFloat(); // TSW returns numeric string
+    ok = scanValue(conn, val);
+    countStat(&Stats::reads);
+    if (!ok)
+      countStat(&Stats::unparsed);
   }
-  http.end();
+  endRequest(conn);
   return val;
 }
+
+// caller holds stateMux
+int TSWSpider::findRead(uint32_t hash, const char *controller) const {
+  for (uint8_t i = 0; i < cacheCount; i++)
+    if (cache[i].hash == hash && strcmp(cache[i].name, controller) == 0)
+      return i;
+  return -1;
+}
+
+// caller holds stateMux; a free entry, else the one fetched longest ago
+int TSWSpider::claimRead(uint32_t hash, const char *controller) {
+  if (strlen(controller) >= TSW_READ_NAME_LEN)
+    return -1;
+  int e = -1;
+  if (cacheCount < TSW_READ_CACHE) {
+    e = cacheCount++;
+  } else {
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < cacheCount; i++)
+      if (!cache[i].pinned && !cache[i].inFlight &&
+          (e < 0 || now - cache[i].fetchedMs > now - cache[e].fetchedMs))
+        e = i;
+    if (e < 0)
+      return -1;
+  }
+  cache[e] = ReadEntry();
+  cache[e].hash = hash;
+  cache[e].ttlMs = TSW_READ_TTL_MS;
+  strcpy(cache[e].name, controller);
+  return e;
+}
+
+bool TSWSpider::setReadTtl(const String &controller, uint32_t ttlMs) {
+  if (TSW_READ_CACHE == 0)
+    return false;
+  uint32_t hash = tswHashName(controller.c_str());
+  portENTER_CRITICAL(&stateMux);
+  int e = findRead(hash, controller.c_str());
+  if (e < 0)
+    e = claimRead(hash, controller.c_str());
+  if (e >= 0) {
+    cache[e].ttlMs = ttlMs;
+    cache[e].pinned = true;
+  }
+  portEXIT_CRITICAL(&stateMux);
+  return e >= 0;
+}
+
+bool TSWSpider::scanValue(TSWHttpConnection *conn, float &value) {
+  // read() waits for data by itself and returns -1 right at the end of the
+  // body, the Stream helpers must not wait on top of that
+  conn->setTimeout(0);
+  int c;
+  while ((c = conn->read()) == ' ' || c == '\t' || c == '\r' || c == '\n') {
+  }
+
+  // {"Result":"Success","Values":{"<property>":0.5}}: skip to the first value
+  if (c == '{') {
+    if (!conn->find("\"Values\"") || !conn->find("{") || !conn->find(":"))
+      return false;
+    while ((c = conn->read()) == ' ' || c == '\t' || c == '\r' || c == '\n') {
+    }
+  }
+  if (c == 't' || c == 'f') { // booleans map to 1 / 0
+    value = c == 't' ? 1.0f : 0.0f;
+    return true;
+  }
+
+  // plain text answer ("0.500") or the number inside Values
+  char buf[24];
+  size_t n = 0;
+  while (n + 1 < sizeof(buf) && c >= 0 && (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+    buf[n++] = (char)c;
+    c = conn->read();
+  }
+  buf[n] = '\0';
+  if (n == 0)
+    return false;
+  value = atof(buf);
+  return true;
+}
+
+// --- Generic requests with streamed body ---
+TSWHttpConnection *TSWSpider::beginRequest(const char *method, const char *path, int &code) {
+  code = -1;
+  TSWHttpConnection *conn = acquire();
+  if (!conn)
+    return nullptr;
+  if (!breaker.allow()) {
+    release(conn);
+    code = TSW_STATUS_CIRCUIT_OPEN;
+    return nullptr;
+  }
+
+  code = exchange(conn, method, path);
+  if (code < 0) {
+    breaker.failure();
+    release(conn);
+    return nullptr;
+  }
+  breaker.success();
+  conn->setTimeout(TSW_RESPONSE_TIMEOUT_MS); // Stream helpers used by parsers
+  return conn;
+}
+
+void TSWSpider::endRequest(TSWHttpConnection *conn) {
+  if (!conn)
+    return;
+  conn->discardBody();
+  release(conn);
+}
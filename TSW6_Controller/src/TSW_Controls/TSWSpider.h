@@ -3,19 +3,28 @@
  * @brief HTTP interface for communication with the Train Sim World (TSW) API.
  *
  * @details
- * Provides simple GET-based communication with a running TSW instance or proxy
- * to set and query controller values.
+ * Sets and reads controller values over a small pool of keep-alive
+ * connections. setControllerValues() pipelines a batch on one connection
+ * and reports the HTTP status of every item; bound controllers are sent
+ * without heap allocations. A TSWCircuitBreaker fails requests fast while
+ * the host is down, and resync() replays the values TSW has not answered
+ * yet. Reads are served from an attached TSWSubscription or a short-lived
+ * read cache before a request goes out. Routes flagged by setRouteKnown()
+ * are answered with 404 locally.
  *
  * Example:
  * @code
  *   TSWSpider spider;
  *   spider.begin("192.168.4.2");
  *   spider.setControllerValue("Throttle", 0.75f);
+ *
+ *   TSWSetItem burst[] = {{"AFBX", 0.2f}, {"AFBY", -0.5f}, {"AFBConfirm", 1.0f}};
+ *   spider.setControllerValues(burst, 3); // one round-trip, burst[i].status = HTTP code
  * @endcode
  *
  * @author Felix Lindemann
  * @date 2025-10-26
- * @version 1.0
+ * @version 1.14
  *
  * @copyright
  * This code is part of the TSW Controller Project.
@@ -24,16 +33,165 @@
 
 #pragma once
 #include <Arduino.h>
-#include <WiFiClient.h>
-#include <HTTPClient.h>
+#include "TSWCircuitBreaker.h"
+#include "TSWHttpConnection.h"
+#include "TSWTransport.h"
+#include "../config.h"
+
+class TSWSubscription;
+
+#ifndef TSW_SPIDER_CONNECTIONS
+#define TSW_SPIDER_CONNECTIONS 2
+#endif
+#ifndef TSW_CONNECT_TIMEOUT_MS
+#define TSW_CONNECT_TIMEOUT_MS 500
+#endif
+#ifndef TSW_RESPONSE_TIMEOUT_MS
+#define TSW_RESPONSE_TIMEOUT_MS 1000
+#endif
+#ifndef TSW_PIPELINE_DEPTH
+#define TSW_PIPELINE_DEPTH 8
+#endif
+#ifndef TSW_SPIDER_ROUTES
+#define TSW_SPIDER_ROUTES 48
+#endif
+#ifndef TSW_ROUTE_LEN
+#define TSW_ROUTE_LEN 80
+#endif
+#ifndef TSW_HEADER_LEN
+#define TSW_HEADER_LEN 160
+#endif
+#ifndef TSW_READ_CACHE
+#define TSW_READ_CACHE 16 // cached read paths, 0 = every read goes to the host
+#endif
+#ifndef TSW_READ_TTL_MS
+#define TSW_READ_TTL_MS 100 // default age up to which a cached read is returned
+#endif
+#ifndef TSW_READ_NAME_LEN
+#define TSW_READ_NAME_LEN 48 // longer controller names are read uncached
+#endif
+
+class TSWSpider : public TSWTransport {
+public:
+  struct Stats {
+    uint32_t requests = 0;  // requests answered by the server
+    uint32_t connects = 0;  // new TCP connections opened
+    uint32_t reused = 0;    // requests sent on an already open connection
+    uint32_t retries = 0;   // stale keep-alive sockets reopened
+    uint32_t failures = 0;  // requests without a valid response
+    uint32_t pipelined = 0; // requests sent as part of a pipelined batch
+    uint32_t resyncs = 0;   // replays of undelivered values that reached the host
+    uint32_t replayed = 0;  // values delivered by a replay
+    uint32_t rejected = 0;  // sets of controllers unknown to the endpoint index, answered 404 locally
+    uint32_t reads = 0;     // getControllerValue() answered with HTTP 200
+    uint32_t unparsed = 0;  // of those, without a number in the body (read as 0)
+    uint32_t cacheHits = 0;   // reads answered from the read cache
+    uint32_t cacheShared = 0; // reads that waited for the request of another reader
+    uint32_t cacheMisses = 0; // reads that went to the host (cacheable paths only)
+    uint32_t cacheAgeSumMs = 0; // age of the values returned by hits, summed
+    uint32_t cacheAgeMaxMs = 0; // oldest value returned by a hit
+    uint32_t subscribed = 0;  // reads answered by the attached TSWSubscription
+  };
 
-class TSWSpider {
 private:
   String host;
   uint16_t port = 31270;
+  String commKey;
+  char header[TSW_HEADER_LEN]; // " HTTP/1.1\r\nHost: ...\r\n\r\n", built in begin()
+  uint8_t headerLen = 0;
+
+  // precomputed "GET /set/ControllerValue/<controller>" per bound controller,
+  // plus the value TSW should have for it
+  struct Route {
+    uint32_t hash;
+    uint8_t len;              // of line, the terminating '/' is appended on send
+    bool dirty;               // value not yet confirmed by the host
+    uint8_t inFlight;         // batches on the wire with this controller, resync() leaves it to them
+    bool unknown;             // not in the endpoint index of the loco, never sent
+    float value;              // last value handed to setControllerValues()
+    char line[TSW_ROUTE_LEN]; // NUL-terminated, so name() is a C string
+    const char *name() const { return line + 25; }
+  };
+  Route routes[TSW_SPIDER_ROUTES];
+  uint8_t routeCount = 0;
+  bool resyncing = false;     // a resync() is replaying, claimed under stateMux
+  uint8_t unknownCount = 0;   // routes flagged by setRouteKnown(..., false)
+  portMUX_TYPE stateMux = portMUX_INITIALIZER_UNLOCKED; // routes, read cache and stats
+
+  TSWHttpConnection connections[TSW_SPIDER_CONNECTIONS];
+  bool busy[TSW_SPIDER_CONNECTIONS] = {};
+  portMUX_TYPE poolMux = portMUX_INITIALIZER_UNLOCKED;
+  Stats stats;
+  TSWCircuitBreaker breaker;
+
+  // read cache, one entry per controller path
+  struct ReadEntry {
+    uint32_t hash;
+    uint32_t fetchedMs; // millis() of the answer
+    uint32_t ttlMs;
+    float value;
+    bool valid;         // value holds an answer of the host
+    bool pinned;        // TTL set by setReadTtl(), never evicted
+    bool inFlight;      // a reader is fetching it, others wait for that answer
+    char name[TSW_READ_NAME_LEN];
+  };
+  ReadEntry cache[TSW_READ_CACHE > 0 ? TSW_READ_CACHE : 1];
+  uint8_t cacheCount = 0;
+  TSWSubscription *subscription = nullptr;
+  TSWDeliveryHandler deliveryHandler = nullptr;
+
+  int findRead(uint32_t hash, const char *controller) const;
+  int claimRead(uint32_t hash, const char *controller);
+  float fetchValue(const String &controller, bool &ok);
+
+  void buildHeaderBlock();
+  int findRoute(const char *controller) const;
+  int addRoute(const char *controller);
+  void remember(const TSWSetItem &item);
+  void settle(const TSWSetItem &item);
+  uint8_t sendBatch(TSWSetItem *items, uint8_t count, bool replay);
+  void countStat(uint32_t Stats::*counter, uint32_t n = 1);
+  TSWHttpConnection *acquire();
+  void release(TSWHttpConnection *conn);
+  int exchange(TSWHttpConnection *conn, const char *method, const char *path);
+
+protected:
+  // request builder of the set path (test/bench_request_builder.cpp)
+  void appendSet(TSWHttpConnection *conn, const TSWSetItem &item);
+  static uint8_t formatValue(char *buf, float value);
 
 public:
   void begin(const String &ip, uint16_t port = 31270);
-  bool setControllerValue(const String &controller, float value);
-  float getControllerValue(const String &controller);
+  void retarget(const String &ip, uint16_t port = 31270);
+  void setCommKey(const String &key);
+  bool setControllerValue(const String &controller, float value) override;
+  float getControllerValue(const String &controller) override;
+  uint8_t setControllerValues(TSWSetItem *items, uint8_t count) override;
+  int bindController(const String &controller) override;
+  void setDeliveryHandler(TSWDeliveryHandler handler) override { deliveryHandler = handler; }
+  uint8_t resync() override;
+
+  // Raw request for other endpoints (e.g. /subscription): on success the
+  // response body is read from the returned connection, which must be
+  // handed back with endRequest(). Returns nullptr if no response arrived.
+  TSWHttpConnection *beginRequest(const char *method, const char *path, int &code);
+  void endRequest(TSWHttpConnection *conn);
+
+  // first value of a read answer, plain number or JSON "Values"; no buffering
+  static bool scanValue(TSWHttpConnection *conn, float &value);
+
+  Stats getStats();
+  TSWCircuitBreaker::Stats getBreakerStats() { return breaker.getStats(); }
+  uint8_t getOpenConnections();
+  uint8_t getRouteCount() const { return routeCount; }
+  const char *getRouteName(uint8_t index) const;
+  // a route that is not known is answered with 404 without a request (TSWEndpointIndex)
+  void setRouteKnown(uint8_t index, bool known);
+  uint8_t getDirtyCount();
+
+  // reads of this controller are served from the cache up to ttlMs old
+  // (0 = always from the host); the entry is kept for good
+  bool setReadTtl(const String &controller, uint32_t ttlMs);
+  // reads of subscribed controllers are answered from its polls
+  void setSubscription(TSWSubscription *s) { subscription = s; }
 };
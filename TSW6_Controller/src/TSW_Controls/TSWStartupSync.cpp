@@ -0,0 +1,164 @@
+/**
+ * @file TSWStartupSync.cpp
+ * @brief Implementation of the boot-time sync burst and the RTC value table.
+ *
+ * @details
+ * Slots are assigned in two passes: controls first take the entry that
+ * carries their own name hash, the rest take entries nobody claimed. A
+ * control that was added or renamed since the last boot thus never inherits
+ * another control's value.
+ *
+ * run() registers confirm() as the delivery handler of the transport before
+ * the batch goes out, so the sync values and every later send reach the
+ * RTC table the same way: by hash, once answered.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#include "TSWStartupSync.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include "TSWControl.h"
+#include "../repo/controlsRepo.h"
+
+#define TSW_SYNC_RTC_MAGIC 0x54535753u // "TSWS"
+
+namespace
+{
+  struct RtcEntry
+  {
+    uint32_t hash;  // tswHashName(controller)
+    float value;    // last value sent
+    uint32_t check; // hash ^ value bits ^ magic, invalid after power-on
+  };
+
+  RTC_NOINIT_ATTR RtcEntry rtcEntries[TSW_SYNC_MAX];
+  bool owned[TSW_SYNC_MAX]; // slot belongs to a control of this boot
+  portMUX_TYPE rtcMux = portMUX_INITIALIZER_UNLOCKED;
+
+  uint32_t checkWord(const RtcEntry &e)
+  {
+    uint32_t bits;
+    memcpy(&bits, &e.value, sizeof(bits));
+    return e.hash ^ bits ^ TSW_SYNC_RTC_MAGIC;
+  }
+
+  bool isValid(const RtcEntry &e) { return e.check == checkWord(e); }
+}
+
+TSWStartupSync::Stats TSWStartupSync::stats;
+
+// called by the transport (send task or loop()) for every answered value
+void TSWStartupSync::confirm(uint32_t hash, float value)
+{
+  portENTER_CRITICAL(&rtcMux);
+  for (uint8_t s = 0; s < TSW_SYNC_MAX; s++)
+    if (owned[s] && rtcEntries[s].hash == hash)
+    {
+      rtcEntries[s].value = value;
+      rtcEntries[s].check = checkWord(rtcEntries[s]);
+      break;
+    }
+  portEXIT_CRITICAL(&rtcMux);
+}
+
+uint8_t TSWStartupSync::run(TSWTransport *transport)
+{
+  uint32_t start = millis();
+  stats = Stats();
+
+  // RTC_NOINIT memory is random after a power cycle
+  esp_reset_reason_t reason = esp_reset_reason();
+  stats.warm = reason != ESP_RST_POWERON && reason != ESP_RST_BROWNOUT && reason != ESP_RST_UNKNOWN;
+  if (!stats.warm)
+    memset(rtcEntries, 0, sizeof(rtcEntries)); // check 0 never matches
+
+  TSWControl *controls[TSW_SYNC_MAX];
+  float values[TSW_SYNC_MAX];
+  int8_t slots[TSW_SYNC_MAX];
+  bool claimed[TSW_SYNC_MAX] = {};
+  uint8_t count = 0;
+
+  // --- sample every control once ---
+  for (auto &entry : ControlRegistry::getAll())
+  {
+    TSWControl *control = dynamic_cast<TSWControl *>(entry.instance);
+    float value;
+    if (!control || !control->sampleTSWValue(value))
+      continue;
+    stats.sampled++;
+    if (count >= TSW_SYNC_MAX)
+      continue; // left to the first regular update
+    controls[count] = control;
+    values[count] = value;
+    slots[count] = -1;
+    count++;
+  }
+
+  // --- pass 1: entries carrying the controller's own hash ---
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint32_t h = tswHashName(controls[i]->getControllerName().c_str());
+    for (uint8_t s = 0; s < TSW_SYNC_MAX; s++)
+      if (!claimed[s] && isValid(rtcEntries[s]) && rtcEntries[s].hash == h)
+      {
+        claimed[s] = true;
+        slots[i] = s;
+        break;
+      }
+  }
+
+  // --- pass 2: free entries for the rest, then build the batch ---
+  TSWSetItem items[TSW_SYNC_MAX];
+  uint8_t owner[TSW_SYNC_MAX];
+  uint8_t n = 0;
+  uint8_t next = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (slots[i] >= 0 && fabsf(rtcEntries[slots[i]].value - values[i]) <= 0.001f)
+    {
+      controls[i]->markSent(values[i]); // game still has it
+      stats.unchanged++;
+      continue;
+    }
+    if (slots[i] < 0)
+    {
+      while (next < TSW_SYNC_MAX && claimed[next])
+        next++;
+      if (next < TSW_SYNC_MAX)
+      {
+        claimed[next] = true;
+        slots[i] = next;
+        rtcEntries[next].hash = tswHashName(controls[i]->getControllerName().c_str());
+      }
+    }
+    items[n] = {controls[i]->getControllerName().c_str(), values[i], -1};
+    owner[n] = i;
+    n++;
+  }
+
+  // --- one transmission, answers reach the RTC table through confirm() ---
+  memcpy(owned, claimed, sizeof(owned));
+  if (transport)
+    transport->setDeliveryHandler(confirm);
+  if (n > 0 && transport)
+    stats.delivered = transport->setControllerValues(items, n);
+  for (uint8_t k = 0; k < n; k++)
+  {
+    if (!transport || items[k].status < 0)
+    {
+      stats.unanswered++; // not in the game, the control sends it again
+      continue;
+    }
+    controls[owner[k]]->markSent(values[owner[k]]);
+  }
+  stats.sent = n;
+  stats.durationMs = millis() - start;
+
+  Serial.printf("[Sync] %s start: %u controls sampled, %u sent in one batch (%u ok, %u unanswered), %u unchanged, %lu ms\n",
+                stats.warm ? "Warm" : "Cold", stats.sampled, stats.sent, stats.delivered,
+                stats.unanswered, stats.unchanged, (unsigned long)stats.durationMs);
+  return n;
+}
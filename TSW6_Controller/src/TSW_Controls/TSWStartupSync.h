@@ -0,0 +1,73 @@
+/**
+ * @file TSWStartupSync.h
+ * @brief One batched transmission of all initial control values at boot.
+ *
+ * @details
+ * Without a sync phase every control starts with an unknown last value, so
+ * its first update fires a request of its own and 30+ requests hit the API
+ * in the first seconds. run() instead samples every registered TSWControl
+ * with an absolute position once (sampleTSWValue()), hands all values to the
+ * transport in a single setControllerValues() call - pipelined by TSWSpider,
+ * packed into one SET message by the wire transports - and marks them as
+ * sent. From then on the controls only send deltas.
+ *
+ * The last sent value of every control is mirrored into RTC memory
+ * (RTC_NOINIT_ATTR, survives software resets, watchdog and panic restarts
+ * but not a power cycle). After a warm restart, values that still match
+ * are not sent again, the game has them already. Entries are keyed by the
+ * controller name hash and carry their own check word, so a power-on or a
+ * changed control set never restores garbage.
+ *
+ * Values of the sync batch that got no answer stay unsent: the control
+ * sends them with its next change, and TSWSpider replays them from its
+ * desired-state table after reconnect. The RTC table is only written from
+ * the delivery handler of the transport (confirm()), i.e. once the host
+ * answered a value; a value that is merely queued while the PC is down is
+ * never taken for the game's state after a warm restart.
+ *
+ * Example:
+ * @code
+ *   SETUP_ANALOG_SLIDER(&spider);        // controls registered
+ *   TSWStartupSync::run(&spider);        // one burst, then deltas only
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TSWTransport.h"
+#include "../config.h"
+
+#ifndef TSW_SYNC_MAX
+#define TSW_SYNC_MAX 48 // controls per sync batch and RTC table entries
+#endif
+
+class TSWStartupSync
+{
+public:
+  struct Stats
+  {
+    uint8_t sampled = 0;     // controls with an absolute position
+    uint8_t sent = 0;        // values in the sync batch
+    uint8_t delivered = 0;   // of those, answered with HTTP 200
+    uint8_t unchanged = 0;   // not sent, unchanged since before the warm restart
+    uint8_t unanswered = 0;  // sent, but no answer (host down): left unsent, not stored
+    bool warm = false;       // RTC table survived the restart
+    uint32_t durationMs = 0; // sampling plus transmission
+  };
+
+private:
+  static Stats stats;
+
+public:
+  // call once after all controls are registered; returns the values sent
+  static uint8_t run(TSWTransport *transport);
+
+  // delivery handler: keeps the RTC entry of an answered controller current
+  static void confirm(uint32_t hash, float value);
+
+  static const Stats &getStats() { return stats; }
+};
@@ -0,0 +1,233 @@
+/**
+ * @file TSWSubscription.cpp
+ * @brief Implementation of the TSW subscription manager.
+ *
+ * @details
+ * Expected response of GET /subscription?Subscription=<id>:
+ * @code
+ *   {"RequestedSubscriptionID":1,
+ *    "Entries":[{"Path":"CurrentDrivableActor/Function.HUD_GetSpeed",
+ *                "NodeValid":true,"Values":{"Speed (ms)":12.5}}, ...]}
+ * @endcode
+ * Each entry is deserialized on its own with an ArduinoJson filter, so only
+ * one entry is in memory at a time. The first value of "Values" is cached.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.4
+ */
+
+#include "TSWSubscription.h"
+#include <ArduinoJson.h>
+
+// --- Setup ---
+int TSWSubscription::add(const char *path)
+{
+  int index = indexOf(path);
+  if (index >= 0)
+    return index;
+  if (count >= TSW_SUBSCRIPTION_MAX || strlen(path) >= TSW_SUBSCRIPTION_PATH_LEN)
+  {
+    Serial.printf("[Subscription] Cannot add %s\n", path);
+    return -1;
+  }
+
+  Entry &e = entries[count];
+  strncpy(e.path, path, sizeof(e.path) - 1);
+  e.path[sizeof(e.path) - 1] = '\0';
+  e.hash = tswHashName(path);
+  e.value = 0.0f;
+  e.valid = false;
+  registered = false;
+  return count++;
+}
+
+bool TSWSubscription::begin()
+{
+  if (!spider)
+    return false;
+
+  int code;
+  char path[TSW_SUBSCRIPTION_PATH_LEN + 40];
+
+  // drop whatever a previous boot left under this id
+  snprintf(path, sizeof(path), "/subscription?Subscription=%u", id);
+  spider->endRequest(spider->beginRequest("DELETE", path, code));
+
+  bool ok = true;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    snprintf(path, sizeof(path), "/subscription/%s?Subscription=%u", entries[i].path, id);
+    TSWHttpConnection *conn = spider->beginRequest("POST", path, code);
+    spider->endRequest(conn);
+    if (code != 200)
+    {
+      Serial.printf("[Subscription] %s not registered (HTTP %d)\n", entries[i].path, code);
+      ok = false;
+    }
+  }
+
+  registered = ok;
+  Serial.printf("[Subscription] #%u registered %u paths%s\n", id, count, ok ? "" : " (with errors)");
+  return ok;
+}
+
+bool TSWSubscription::startPolling(uint32_t intervalMs)
+{
+  if (task)
+    return true;
+  pollInterval = intervalMs;
+  return xTaskCreatePinnedToCore(taskEntry, "tswPoll", 4096, this, 1, &task, TSW_SEND_TASK_CORE) == pdPASS;
+}
+
+void TSWSubscription::taskEntry(void *arg)
+{
+  TSWSubscription *self = static_cast<TSWSubscription *>(arg);
+  while (true)
+  {
+    if (!self->registered)
+      self->begin();
+    else
+      self->poll();
+    vTaskDelay(pdMS_TO_TICKS(self->pollInterval));
+  }
+}
+
+// --- Polling ---
+bool TSWSubscription::poll()
+{
+  if (!spider || count == 0)
+    return false;
+
+  uint32_t start = micros();
+  int code;
+  char path[32]; // on the stack, a poll allocates nothing
+  snprintf(path, sizeof(path), "/subscription?Subscription=%u", id);
+  TSWHttpConnection *conn = spider->beginRequest("GET", path, code);
+
+  bool ok = conn && code == 200 && parseEntries(*conn);
+  spider->endRequest(conn);
+
+  portENTER_CRITICAL(&mux);
+  if (ok)
+  {
+    stats.polls++;
+    stats.lastPollUs = micros() - start;
+    stats.lastPollMs = millis();
+  }
+  else
+  {
+    stats.failures++;
+  }
+  portEXIT_CRITICAL(&mux);
+  if (!ok && code == 404)
+    registered = false; // game restarted, register again
+  return ok;
+}
+
+bool TSWSubscription::parseEntries(Stream &body)
+{
+  if (!body.find("\"Entries\"") || !body.find("["))
+    return false;
+
+  StaticJsonDocument<64> filter;
+  filter["Path"] = true;
+  filter["NodeValid"] = true;
+  filter["Values"] = true;
+
+  do
+  {
+    StaticJsonDocument<384> entry;
+    DeserializationError err = deserializeJson(entry, body, DeserializationOption::Filter(filter));
+    if (err)
+      return false;
+
+    // by path only, the order of the answer is no reliable key
+    int index = indexOf(entry["Path"] | "");
+    if (index < 0)
+    {
+      portENTER_CRITICAL(&mux);
+      stats.unmatched++;
+      portEXIT_CRITICAL(&mux);
+      continue;
+    }
+
+    bool valid = entry["NodeValid"] | false;
+    float value = entries[index].value;
+    for (JsonPair kv : entry["Values"].as<JsonObject>())
+    {
+      value = kv.value().as<float>();
+      break;
+    }
+    portENTER_CRITICAL(&mux);
+    entries[index].valid = valid;
+    entries[index].value = value;
+    portEXIT_CRITICAL(&mux);
+  } while (body.findUntil(",", "]"));
+
+  return true;
+}
+
+// --- Cache access ---
+float TSWSubscription::get(int index, float fallback) const
+{
+  if (index < 0 || index >= count)
+    return fallback;
+  portENTER_CRITICAL(&mux);
+  float value = entries[index].valid ? entries[index].value : fallback;
+  portEXIT_CRITICAL(&mux);
+  return value;
+}
+
+float TSWSubscription::get(const char *path, float fallback) const
+{
+  return get(indexOf(path), fallback);
+}
+
+bool TSWSubscription::isValid(int index) const
+{
+  return index >= 0 && index < count && entries[index].valid;
+}
+
+bool TSWSubscription::read(const char *path, float &value) const
+{
+  int index = indexOf(path);
+  if (index < 0)
+    return false;
+  uint32_t maxAge = pollInterval ? 2 * pollInterval : TSW_READ_TTL_MS;
+  portENTER_CRITICAL(&mux);
+  bool fresh = stats.polls && millis() - stats.lastPollMs < maxAge && entries[index].valid;
+  if (fresh)
+    value = entries[index].value;
+  portEXIT_CRITICAL(&mux);
+  return fresh;
+}
+
+const char *TSWSubscription::getPath(int index) const
+{
+  return (index >= 0 && index < count) ? entries[index].path : "";
+}
+
+uint32_t TSWSubscription::getAgeMs() const
+{
+  Stats s = getStats();
+  return s.polls ? millis() - s.lastPollMs : UINT32_MAX;
+}
+
+TSWSubscription::Stats TSWSubscription::getStats() const
+{
+  portENTER_CRITICAL(&mux);
+  Stats copy = stats;
+  portEXIT_CRITICAL(&mux);
+  return copy;
+}
+
+// --- Helpers ---
+int TSWSubscription::indexOf(const char *path) const
+{
+  uint32_t h = tswHashName(path);
+  for (uint8_t i = 0; i < count; i++)
+    if (entries[i].hash == h && strcmp(entries[i].path, path) == 0)
+      return i;
+  return -1;
+}
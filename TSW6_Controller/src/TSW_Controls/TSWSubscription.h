@@ -0,0 +1,113 @@
+/**
+ * @file TSWSubscription.h
+ * @brief Bulk reads of TSW game state through the /subscription endpoints.
+ *
+ * @details
+ * Registers a set of API paths once under one subscription id and reads
+ * all of them with a single request:
+ *   POST   /subscription/<Path>?Subscription=<id>   (once per path, in begin())
+ *   GET    /subscription?Subscription=<id>          (every poll)
+ *   DELETE /subscription?Subscription=<id>          (clears stale entries)
+ *
+ * The GET response is parsed straight from the socket, one entry of the
+ * "Entries" array at a time, into a fixed-size cache keyed by path. The body
+ * is never held in memory as a whole, so the heap use of a poll does not
+ * grow with the number of subscribed paths. Entries are matched by their
+ * "Path"; one that matches no subscribed path is dropped and counted.
+ *
+ * Reading the cache (get()) never touches the network, so displays, LEDs or
+ * closed-loop logic can query it at any rate. Polling can run from the
+ * caller or in its own FreeRTOS task (startPolling()).
+ *
+ * Attached to a TSWSpider (TSWSpider::setSubscription()), the cache also
+ * answers getControllerValue() for every subscribed
+ * "CurrentDrivableActor/<controller>" path while the last poll is fresh
+ * (read()), so those controllers cost no request of their own. main.cpp
+ * subscribes the controllers in TSW_STATE_READS this way.
+ *
+ * Example:
+ * @code
+ *   TSWSubscription state(&spider, 1);
+ *   int speed = state.add("CurrentDrivableActor/Function.HUD_GetSpeed");
+ *   state.begin();
+ *   state.startPolling(100);
+ *   float mps = state.get(speed);
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.3
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TSWSpider.h"
+#include "../config.h"
+
+#ifndef TSW_SUBSCRIPTION_MAX
+#define TSW_SUBSCRIPTION_MAX 16
+#endif
+#ifndef TSW_SUBSCRIPTION_PATH_LEN
+#define TSW_SUBSCRIPTION_PATH_LEN 96
+#endif
+#define TSW_SUBSCRIPTION_ACTOR "CurrentDrivableActor/" // path prefix of a controller read
+
+class TSWSubscription
+{
+public:
+  struct Stats
+  {
+    uint32_t polls = 0;       // successful bulk reads
+    uint32_t failures = 0;    // bulk reads without a usable response
+    uint32_t unmatched = 0;   // entries whose path matched no subscribed one, dropped
+    uint32_t lastPollUs = 0;  // duration of the latest bulk read
+    uint32_t lastPollMs = 0;  // millis() of the latest successful read
+  };
+
+private:
+  struct Entry
+  {
+    char path[TSW_SUBSCRIPTION_PATH_LEN];
+    uint32_t hash;
+    float value;
+    bool valid;               // NodeValid reported by the game
+  };
+
+  TSWSpider *spider;
+  uint8_t id;
+  Entry entries[TSW_SUBSCRIPTION_MAX];
+  uint8_t count = 0;
+  bool registered = false;
+  Stats stats;
+  uint32_t pollInterval = 0;
+  TaskHandle_t task = nullptr;
+  mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED; // entries and stats, poll task vs. readers
+
+  int indexOf(const char *path) const;
+  bool parseEntries(Stream &body);
+  static void taskEntry(void *arg);
+
+public:
+  TSWSubscription(TSWSpider *s, uint8_t subscriptionId = 1)
+      : spider(s), id(subscriptionId) {}
+
+  // --- Setup ---
+  int add(const char *path);
+  bool begin();
+  bool startPolling(uint32_t intervalMs);
+
+  // --- Polling ---
+  bool poll();
+
+  // --- Cache access (no network) ---
+  float get(int index, float fallback = 0.0f) const;
+  float get(const char *path, float fallback = 0.0f) const;
+  bool isValid(int index) const;
+  // value of a subscribed path if the game reported it in a poll of the
+  // last two intervals (TSW_READ_TTL_MS when polled by the caller)
+  bool read(const char *path, float &value) const;
+  uint8_t size() const { return count; }
+  const char *getPath(int index) const;
+  uint32_t getAgeMs() const;
+  Stats getStats() const;
+};
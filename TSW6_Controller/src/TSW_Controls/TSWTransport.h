@@ -0,0 +1,95 @@
+/**
+ * @file TSWTransport.h
+ * @brief Common interface for everything that delivers controller values to TSW.
+ *
+ * @details
+ * TSWControl instances only talk to this interface. The concrete
+ * implementation decides how a value reaches the game:
+ *   - TSWSpider      sends it directly over HTTP (blocking)
+ *   - TSWSendQueue   queues it and lets a network task forward it
+ *
+ * Several values can be handed over at once with setControllerValues().
+ * The default implementation sends them one by one; TSWSpider pipelines
+ * them over a single connection.
+ *
+ * resync() asks the transport to send again whatever did not reach the game
+ * (TSWSpider keeps the last value of every controller for that).
+ *
+ * bindController() announces a controller once at setup, so transports can
+ * prepare everything per controller that does not depend on the value.
+ * setPriority() puts a controller into the high priority lane; TSWSendQueue
+ * serves that lane first, transports without a queue ignore it.
+ *
+ * setDeliveryHandler() registers a function that is called once the host
+ * answered a value (TSWSpider: any HTTP status, wire transports: the ACK of
+ * the bridge), never when a value was only queued.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.6
+ */
+
+#pragma once
+#include <Arduino.h>
+
+// status of a request the transport refused without trying (TSW host known to be down)
+#define TSW_STATUS_CIRCUIT_OPEN -2
+
+// send lane of a controller; safety-critical controls must not wait behind a lever sweep
+enum TSWPriority : uint8_t {
+  TSW_PRIORITY_BULK,
+  TSW_PRIORITY_HIGH
+};
+
+// One entry of a batched set; status receives the HTTP code, -1 or TSW_STATUS_CIRCUIT_OPEN
+struct TSWSetItem {
+  const char *controller;
+  float value;
+  int status;
+};
+
+// FNV-1a hash of a controller name or path, the one hash of every lookup table
+// (routes, send slots, control registry, subscription entries)
+inline uint32_t tswHashName(const char *name) {
+  uint32_t h = 2166136261u;
+  while (*name) {
+    h ^= (uint8_t)*name++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// called with tswHashName(controller) and the value the host answered
+typedef void (*TSWDeliveryHandler)(uint32_t hash, float value);
+
+class TSWTransport {
+public:
+  virtual ~TSWTransport() = default;
+
+  virtual bool setControllerValue(const String &controller, float value) = 0;
+  virtual float getControllerValue(const String &controller) = 0;
+
+  // optional: returns a transport specific index or -1 if nothing was bound
+  virtual int bindController(const String &controller) { return -1; }
+
+  // optional: lane of a controller, call after bindController()
+  virtual void setPriority(const String &controller, TSWPriority priority) {}
+
+  // optional: answered values are reported to handler, nullptr turns it off
+  virtual void setDeliveryHandler(TSWDeliveryHandler handler) {}
+
+  // optional: sends values that did not get through again, returns how many
+  // are still undelivered afterwards
+  virtual uint8_t resync() { return 0; }
+
+  // returns the number of items answered with HTTP 200
+  virtual uint8_t setControllerValues(TSWSetItem *items, uint8_t count) {
+    uint8_t ok = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      items[i].status = setControllerValue(items[i].controller, items[i].value) ? 200 : -1;
+      if (items[i].status == 200)
+        ok++;
+    }
+    return ok;
+  }
+};
@@ -0,0 +1,48 @@
+/**
+ * @file TSWUdpTransport.cpp
+ * @brief Implementation of the binary UDP transport to the PC bridge.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSWUdpTransport.h"
+
+bool TSWUdpTransport::begin(const String &ip, uint16_t p)
+{
+  if (!host.fromString(ip))
+  {
+    Serial.printf("[UDP] Invalid bridge address %s\n", ip.c_str());
+    return false;
+  }
+  port = p;
+
+  if (!udp.begin(port))
+  {
+    Serial.println("[UDP] Failed to open socket");
+    return false;
+  }
+  start();
+  Serial.printf("[UDP] Bridge %s:%u\n", ip.c_str(), port);
+  return true;
+}
+
+bool TSWUdpTransport::writeMessage(const uint8_t *buf, uint16_t len)
+{
+  if (!udp.beginPacket(host, port))
+    return false;
+  udp.write(buf, len);
+  return udp.endPacket();
+}
+
+uint16_t TSWUdpTransport::readMessage(uint8_t *buf, uint16_t size)
+{
+  while (udp.parsePacket() > 0)
+  {
+    int len = udp.read(buf, size);
+    if (len > 0)
+      return len;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file TSWUdpTransport.h
+ * @brief Binary UDP transport to the PC bridge (Bridge/tsw_bridge.py).
+ *
+ * @details
+ * Sends every TSWWire message as one datagram over WiFi. Delivery, ids and
+ * statistics are handled by TSWWireTransport.
+ *
+ * Example:
+ * @code
+ *   TSWUdpTransport udp;
+ *   udp.begin("192.168.4.2");
+ *   TSWLever throttle(A0, "Throttle", &udp);
+ *   ...
+ *   void loop() { udp.update(); throttle.updateAndSend(); }
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "TSWWireTransport.h"
+#include "../config.h"
+
+#ifndef TSW_BRIDGE_PORT
+#define TSW_BRIDGE_PORT 31271
+#endif
+
+class TSWUdpTransport : public TSWWireTransport {
+private:
+  WiFiUDP udp;
+  IPAddress host;
+  uint16_t port = TSW_BRIDGE_PORT;
+
+protected:
+  bool writeMessage(const uint8_t *buf, uint16_t len) override;
+  uint16_t readMessage(uint8_t *buf, uint16_t size) override;
+
+public:
+  bool begin(const String &ip, uint16_t port = TSW_BRIDGE_PORT);
+};
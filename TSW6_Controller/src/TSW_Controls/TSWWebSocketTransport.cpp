@@ -0,0 +1,406 @@
+/**
+ * @file TSWWebSocketTransport.cpp
+ * @brief Implementation of the WebSocket transport to the PC bridge.
+ *
+ * @details
+ * Frames are assembled in a stack buffer and written with a single write(),
+ * so a message never spans more TCP segments than necessary. While the
+ * connection is down, TSWWireTransport::update() is not called: the latest
+ * value of every controller stays pending and goes out with the first
+ * update() after the reconnect instead of being counted as lost.
+ *
+ * The connect task sleeps until update() asks for a connection, then opens
+ * the socket and runs the handshake with the usual timeouts. The result is
+ * handed back through the link state; session start (binds, subscriptions)
+ * and all traffic stay in loop(). The server's Sec-WebSocket-Accept is
+ * checked against SHA-1 of the key, so a plain HTTP server or proxy on the
+ * port is not mistaken for the bridge.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSWWebSocketTransport.h"
+
+#define WS_OP_BINARY 0x2
+#define WS_OP_CLOSE 0x8
+#define WS_OP_PING 0x9
+#define WS_OP_PONG 0xA
+#define WS_FIN 0x80
+#define WS_MASK 0x80
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void base64(char *out, const uint8_t *in, uint8_t len)
+{
+  for (uint8_t i = 0; i < len; i += 3)
+  {
+    uint32_t v = (uint32_t)in[i] << 16;
+    if (i + 1 < len)
+      v |= (uint32_t)in[i + 1] << 8;
+    if (i + 2 < len)
+      v |= in[i + 2];
+    *out++ = base64Chars[(v >> 18) & 0x3F];
+    *out++ = base64Chars[(v >> 12) & 0x3F];
+    *out++ = i + 1 < len ? base64Chars[(v >> 6) & 0x3F] : '=';
+    *out++ = i + 2 < len ? base64Chars[v & 0x3F] : '=';
+  }
+  *out = '\0';
+}
+
+// SHA-1 (FIPS 180-4), only for the handshake: key + GUID fit in two blocks
+static void sha1(const uint8_t *msg, uint8_t len, uint8_t out[20])
+{
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  uint8_t block[64];
+  uint8_t blocks = (len + 8) / 64 + 1;
+  for (uint8_t b = 0; b < blocks; b++)
+  {
+    // message, 0x80, zero padding, bit length in the last 8 bytes
+    for (uint8_t i = 0; i < 64; i++)
+    {
+      uint16_t pos = b * 64 + i;
+      block[i] = pos < len ? msg[pos] : pos == len ? 0x80 : 0;
+    }
+    if (b == blocks - 1)
+    {
+      block[62] = (uint8_t)((len * 8) >> 8);
+      block[63] = (uint8_t)(len * 8);
+    }
+
+    uint32_t w[80];
+    for (uint8_t i = 0; i < 16; i++)
+      w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 | block[4 * i + 2] << 8 | block[4 * i + 3];
+    for (uint8_t i = 16; i < 80; i++)
+    {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = x << 1 | x >> 31;
+    }
+
+    uint32_t a = h[0], bb = h[1], c = h[2], d = h[3], e = h[4];
+    for (uint8_t i = 0; i < 80; i++)
+    {
+      uint32_t f, k;
+      if (i < 20)
+        f = (bb & c) | (~bb & d), k = 0x5A827999;
+      else if (i < 40)
+        f = bb ^ c ^ d, k = 0x6ED9EBA1;
+      else if (i < 60)
+        f = (bb & c) | (bb & d) | (c & d), k = 0x8F1BBCDC;
+      else
+        f = bb ^ c ^ d, k = 0xCA62C1D6;
+      uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = bb << 30 | bb >> 2;
+      bb = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += bb;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+  for (uint8_t i = 0; i < 20; i++)
+    out[i] = h[i / 4] >> (24 - 8 * (i % 4));
+}
+
+static bool readLine(WiFiClient &c, char *buf, size_t len, uint32_t timeoutMs)
+{
+  size_t n = 0;
+  uint32_t start = millis();
+  while (millis() - start < timeoutMs)
+  {
+    int ch = c.read();
+    if (ch < 0)
+    {
+      if (!c.connected())
+        return false;
+      delay(1);
+      continue;
+    }
+    if (ch == '\n')
+    {
+      if (n > 0 && buf[n - 1] == '\r')
+        n--;
+      buf[n] = '\0';
+      return true;
+    }
+    if (n < len - 1)
+      buf[n++] = (char)ch;
+  }
+  return false;
+}
+
+bool TSWWebSocketTransport::begin(const String &h, uint16_t p)
+{
+  host = h;
+  port = p;
+  Serial.printf("[WS] Bridge ws://%s:%u%s\n", host.c_str(), port, TSW_WS_PATH);
+  // connect and handshake block for up to two timeouts: own task, next to the WiFi stack
+  if (!task && xTaskCreatePinnedToCore(taskEntry, "tswWs", 4096, this, 1, &task, 0) != pdPASS)
+  {
+    Serial.println("[WS] Failed to start connect task");
+    task = nullptr;
+    return false;
+  }
+  nextAttemptMs = millis(); // first attempt with the next update()
+  return true;
+}
+
+// --- Connection ---
+void TSWWebSocketTransport::taskEntry(void *arg)
+{
+  static_cast<TSWWebSocketTransport *>(arg)->run();
+}
+
+void TSWWebSocketTransport::run()
+{
+  while (true)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (link == LINK_CONNECTING)
+      setLink(connect() ? LINK_READY : LINK_DOWN);
+  }
+}
+
+void TSWWebSocketTransport::setLink(Link state)
+{
+  portENTER_CRITICAL(&mux);
+  link = state;
+  portEXIT_CRITICAL(&mux);
+}
+
+// connect task only: TCP connect and handshake; on failure the next attempt
+// is scheduled with backoff
+bool TSWWebSocketTransport::connect()
+{
+  if (client.connect(host.c_str(), port, TSW_CONNECT_TIMEOUT_MS))
+  {
+    client.setNoDelay(true); // small frames, no Nagle delay
+    if (handshake())
+      return true;
+    client.stop();
+  }
+  nextAttemptMs = millis() + retryMs;
+  retryMs = retryMs * 2 > TSW_WS_RETRY_MAX_MS ? TSW_WS_RETRY_MAX_MS : retryMs * 2;
+  return false;
+}
+
+void TSWWebSocketTransport::disconnect()
+{
+  if (link != LINK_UP)
+    return;
+  disconnects++;
+  client.stop();
+  nextAttemptMs = millis() + retryMs;
+  setLink(LINK_DOWN);
+  TRACE_PRINT("[WS] Disconnected\n");
+}
+
+// RFC 6455 client handshake, the answer must carry the accept hash of our key
+bool TSWWebSocketTransport::handshake()
+{
+  uint8_t nonce[16];
+  for (uint8_t i = 0; i < sizeof(nonce); i += 4)
+  {
+    uint32_t r = esp_random();
+    memcpy(nonce + i, &r, 4);
+  }
+  char key[25];
+  base64(key, nonce, sizeof(nonce));
+
+  char req[200];
+  int n = snprintf(req, sizeof(req),
+                   "GET " TSW_WS_PATH " HTTP/1.1\r\n"
+                   "Host: %s:%u\r\n"
+                   "Upgrade: websocket\r\n"
+                   "Connection: Upgrade\r\n"
+                   "Sec-WebSocket-Key: %s\r\n"
+                   "Sec-WebSocket-Version: 13\r\n\r\n",
+                   host.c_str(), port, key);
+  if (n <= 0 || n >= (int)sizeof(req) || client.write((const uint8_t *)req, n) != (size_t)n)
+    return false;
+
+  // Sec-WebSocket-Accept = base64(SHA-1(key + GUID))
+  char keyGuid[24 + sizeof(WS_GUID)];
+  snprintf(keyGuid, sizeof(keyGuid), "%s" WS_GUID, key);
+  uint8_t digest[20];
+  sha1((const uint8_t *)keyGuid, strlen(keyGuid), digest);
+  char accept[29];
+  base64(accept, digest, sizeof(digest));
+
+  // status line, then headers up to the empty line
+  char line[96] = "";
+  if (!readLine(client, line, sizeof(line), TSW_CONNECT_TIMEOUT_MS) || strncmp(line, "HTTP/1.1 101", 12) != 0)
+  {
+    Serial.printf("[WS] Handshake rejected: %s\n", line);
+    return false;
+  }
+  bool accepted = false;
+  while (readLine(client, line, sizeof(line), TSW_CONNECT_TIMEOUT_MS))
+  {
+    if (line[0] == '\0')
+    {
+      if (!accepted)
+        Serial.println("[WS] Handshake rejected: Sec-WebSocket-Accept missing or wrong");
+      return accepted;
+    }
+    if (strncasecmp(line, "Sec-WebSocket-Accept:", 21) == 0)
+    {
+      const char *value = line + 21;
+      while (*value == ' ')
+        value++;
+      accepted = strcmp(value, accept) == 0;
+    }
+  }
+  return false;
+}
+
+void TSWWebSocketTransport::update()
+{
+  if (link == LINK_UP && !client.connected())
+    disconnect();
+
+  if (link == LINK_READY)
+  {
+    // the task has handed the open socket over
+    setLink(LINK_UP);
+    connects++;
+    retryMs = TSW_WS_RETRY_MIN_MS;
+    headLen = 0;
+    start(); // new session: binds and subscriptions go out again
+    TRACE_PRINT("[WS] Connected\n");
+  }
+  else if (link == LINK_DOWN && task && host.length() > 0 && (int32_t)(millis() - nextAttemptMs) >= 0)
+  {
+    setLink(LINK_CONNECTING);
+    xTaskNotifyGive(task);
+  }
+
+  if (link != LINK_UP)
+    return; // keep pending values for the next connection
+  TSWWireTransport::update();
+}
+
+// --- Frames ---
+bool TSWWebSocketTransport::writeFrame(uint8_t opcode, const uint8_t *buf, uint16_t len)
+{
+  uint8_t frame[8 + TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_BATCH * TSW_WIRE_ITEM_LEN];
+  if ((size_t)len + 8 > sizeof(frame))
+    return false;
+
+  uint8_t n = 0;
+  frame[n++] = WS_FIN | opcode;
+  if (len < 126)
+    frame[n++] = WS_MASK | len;
+  else
+  {
+    frame[n++] = WS_MASK | 126;
+    frame[n++] = len >> 8;
+    frame[n++] = len & 0xFF;
+  }
+  // client frames must be masked
+  uint32_t r = esp_random();
+  uint8_t *mask = frame + n;
+  memcpy(mask, &r, 4);
+  n += 4;
+  for (uint16_t i = 0; i < len; i++)
+    frame[n + i] = buf[i] ^ mask[i & 3];
+
+  if (client.write(frame, n + len) != (size_t)(n + len))
+  {
+    disconnect();
+    return false;
+  }
+  return true;
+}
+
+bool TSWWebSocketTransport::writeMessage(const uint8_t *buf, uint16_t len)
+{
+  if (link != LINK_UP)
+    return false;
+  return writeFrame(WS_OP_BINARY, buf, len);
+}
+
+uint8_t TSWWebSocketTransport::headNeeded() const
+{
+  if (headLen < 2)
+    return 2;
+  uint8_t len7 = head[1] & 0x7F;
+  return 2 + (len7 == 126 ? 2 : len7 == 127 ? 8 : 0) + ((head[1] & WS_MASK) ? 4 : 0);
+}
+
+uint16_t TSWWebSocketTransport::readMessage(uint8_t *buf, uint16_t size)
+{
+  while (link == LINK_UP)
+  {
+    // frame header, byte by byte
+    if (headLen < headNeeded())
+    {
+      if (client.available() <= 0)
+        return 0;
+      head[headLen++] = (uint8_t)client.read();
+      if (headLen < headNeeded())
+        continue;
+
+      uint8_t len7 = head[1] & 0x7F;
+      frameLen = len7;
+      if (len7 >= 126)
+      {
+        frameLen = 0;
+        for (uint8_t i = 2; i < (len7 == 126 ? 4 : 10); i++)
+          frameLen = (frameLen << 8) | head[i];
+      }
+      frameRead = 0;
+    }
+
+    // payload; bytes beyond rx are skipped
+    if (frameRead < frameLen)
+    {
+      int available = client.available();
+      if (available <= 0)
+        return 0;
+      if (frameRead < sizeof(rx))
+      {
+        uint64_t end = frameLen < sizeof(rx) ? frameLen : sizeof(rx);
+        size_t n = end - frameRead < (uint64_t)available ? (size_t)(end - frameRead) : (size_t)available;
+        int got = client.read(rx + frameRead, n);
+        if (got > 0)
+          frameRead += got;
+      }
+      else
+      {
+        client.read();
+        frameRead++;
+      }
+      if (frameRead < frameLen)
+        continue;
+    }
+
+    // complete frame
+    uint8_t opcode = head[0] & 0x0F;
+    uint16_t len = frameLen <= sizeof(rx) ? (uint16_t)frameLen : 0;
+    if (head[1] & WS_MASK)
+    {
+      const uint8_t *mask = head + headLen - 4;
+      for (uint16_t i = 0; i < len; i++)
+        rx[i] ^= mask[i & 3];
+    }
+    headLen = 0;
+
+    if (opcode == WS_OP_BINARY && len > 0 && frameLen <= size)
+    {
+      memcpy(buf, rx, len);
+      return len;
+    }
+    if (opcode == WS_OP_PING)
+      writeFrame(WS_OP_PONG, rx, len);
+    else if (opcode == WS_OP_CLOSE)
+      disconnect();
+  }
+  return 0;
+}
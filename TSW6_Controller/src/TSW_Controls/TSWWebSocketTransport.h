@@ -0,0 +1,109 @@
+/**
+ * @file TSWWebSocketTransport.h
+ * @brief Binary WebSocket transport to the PC bridge (Bridge/tsw_bridge.py).
+ *
+ * @details
+ * One long-lived TCP connection per device, upgraded to a WebSocket
+ * (RFC 6455). Every TSWWire message travels as one binary frame in both
+ * directions, so updates pushed by the bridge for subscribed controllers
+ * (TSWWireTransport::subscribe) arrive on the same connection without
+ * polling. Compared to UDP, the stream is reliable and ordered, and it
+ * passes networks that drop or rate-limit datagrams.
+ *
+ * Only the parts of RFC 6455 the bridge uses are implemented:
+ *   - client handshake (Sec-WebSocket-Key from esp_random, expects 101 and
+ *     the matching Sec-WebSocket-Accept)
+ *   - masked binary frames up to 64 KiB, written with a single write()
+ *   - non-blocking frame parser; ping is answered with pong, close drops
+ *     the connection; text and continuation frames are ignored
+ *
+ * Connecting blocks for up to two timeouts (TCP connect, handshake), so it
+ * never runs in loop(): a small task opens the socket and does the
+ * handshake, update() only hands the request over and picks up the open
+ * connection. The socket belongs to the task while it connects and to
+ * update() once the link is up. A lost connection is requested again with
+ * exponential backoff (TSW_WS_RETRY_MIN_MS .. TSW_WS_RETRY_MAX_MS). Each new
+ * connection starts a new session, which announces all bindings and
+ * subscriptions again.
+ *
+ * Example:
+ * @code
+ *   TSWWebSocketTransport ws;
+ *   ws.begin("192.168.4.2");
+ *   TSWLever throttle(A0, "Throttle", &ws);
+ *   ws.subscribe("Speedometer.Speed");
+ *   ...
+ *   void loop() { ws.update(); throttle.updateAndSend(); }
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "TSWWireTransport.h"
+#include "../config.h"
+
+#ifndef TSW_BRIDGE_WS_PORT
+#define TSW_BRIDGE_WS_PORT 31272
+#endif
+#ifndef TSW_CONNECT_TIMEOUT_MS
+#define TSW_CONNECT_TIMEOUT_MS 500
+#endif
+#ifndef TSW_WS_RETRY_MIN_MS
+#define TSW_WS_RETRY_MIN_MS 250
+#endif
+#ifndef TSW_WS_RETRY_MAX_MS
+#define TSW_WS_RETRY_MAX_MS 5000
+#endif
+
+#define TSW_WS_PATH "/tsw"
+#define TSW_WS_RX_LEN (TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_UPDATE_MAX * TSW_WIRE_ITEM_LEN)
+
+class TSWWebSocketTransport : public TSWWireTransport {
+private:
+  // who owns the socket: update() while DOWN/READY/UP, the task while CONNECTING
+  enum Link : uint8_t { LINK_DOWN, LINK_CONNECTING, LINK_READY, LINK_UP };
+
+  WiFiClient client;
+  String host;
+  uint16_t port = TSW_BRIDGE_WS_PORT;
+  volatile Link link = LINK_DOWN;
+  TaskHandle_t task = nullptr;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t nextAttemptMs = 0;
+  uint32_t retryMs = TSW_WS_RETRY_MIN_MS;
+  uint32_t connects = 0;
+  uint32_t disconnects = 0;
+
+  // incoming frame
+  uint8_t head[14];     // 2 bytes + extended length + mask key
+  uint8_t headLen = 0;
+  uint64_t frameLen = 0;
+  uint64_t frameRead = 0;
+  uint8_t rx[TSW_WS_RX_LEN];
+
+  static void taskEntry(void *arg);
+  void run();
+  void setLink(Link state);
+  bool connect();
+  void disconnect();
+  bool handshake();
+  uint8_t headNeeded() const;
+  bool writeFrame(uint8_t opcode, const uint8_t *buf, uint16_t len);
+
+protected:
+  bool writeMessage(const uint8_t *buf, uint16_t len) override;
+  uint16_t readMessage(uint8_t *buf, uint16_t size) override;
+
+public:
+  bool begin(const String &host, uint16_t port = TSW_BRIDGE_WS_PORT);
+  void update() override;
+
+  bool isConnected() const { return link == LINK_UP; }
+  uint32_t getConnects() const { return connects; }
+  uint32_t getDisconnects() const { return disconnects; }
+};
@@ -0,0 +1,250 @@
+/**
+ * @file TSWWire.h
+ * @brief Compact binary message format between the controller and the PC bridge.
+ *
+ * @details
+ * Used by the transports that talk to the bridge (Bridge/tsw_bridge.py)
+ * instead of the TSW HTTP API. The bridge resolves the small controller ids
+ * to names and issues the HTTP calls locally on the game PC.
+ *
+ * The header has no Arduino dependencies, so the codec also builds on the
+ * host (g++ -std=gnu++14) for checks against the bridge.
+ *
+ * Layout (little endian):
+ * @code
+ *   0  u8   magic 'T'
+ *   1  u8   type
+ *   2  u16  session   random per boot, a new session resets the bridge state
+ *   4  u16  seq       per session, wraps around
+ *   6  u32  timeUs    sender clock, echoed in replies for round-trip times
+ *  10  ...  payload
+ *
+ *   SET     device -> bridge  u8 count, count * { u8 id, i32 value * 1000 }
+ *   BIND    device -> bridge  u8 id, u8 len, name
+ *   GET     device -> bridge  u8 id
+ *   SUBSCRIBE device -> bridge u16 intervalMs, u8 count, count * u8 id
+ *   ACK     bridge -> device  u8 accepted, u8 stale, u8 failed  (seq/timeUs echoed;
+ *                             failed: TSW refused the previous value of the id)
+ *   UNKNOWN bridge -> device  u8 id                             (id has no BIND yet)
+ *   VALUE   bridge -> device  u8 id, i32 value * 1000           (answer to GET)
+ *   UPDATE  bridge -> device  u8 count, count * { u8 id, i32 value * 1000 }
+ *                             (changed values of subscribed controllers,
+ *                             at most TSW_WIRE_UPDATE_MAX per message)
+ * @endcode
+ *
+ * Values are quantized to thousandths, the same resolution the HTTP path
+ * sends as text.
+ *
+ * Byte streams (UART) carry each message as a SLIP frame with a CRC-16/CCITT
+ * (little endian) appended:  END, escaped(message + crc), END.
+ * Plain text between frames (log output on the same UART) never contains
+ * the END byte 0xC0 and fails the CRC, so the bridge can tell both apart.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+#define TSW_WIRE_MAGIC 0x54
+#define TSW_WIRE_HEADER_LEN 10
+#define TSW_WIRE_ITEM_LEN 5
+#define TSW_WIRE_MAX_NAME 47
+#define TSW_WIRE_MAX_MESSAGE (TSW_WIRE_HEADER_LEN + 2 + TSW_WIRE_MAX_NAME)
+#define TSW_WIRE_UPDATE_MAX 8 // keeps bridge -> device messages within small receive buffers
+
+#define TSW_SLIP_END 0xC0
+#define TSW_SLIP_ESC 0xDB
+#define TSW_SLIP_ESC_END 0xDC
+#define TSW_SLIP_ESC_ESC 0xDD
+// worst case frame size for a message of n bytes
+#define TSW_SLIP_FRAME_LEN(n) (2 * ((n) + 2) + 2)
+
+enum TSWWireType : uint8_t {
+  TSW_WIRE_SET = 0x01,
+  TSW_WIRE_BIND = 0x02,
+  TSW_WIRE_GET = 0x03,
+  TSW_WIRE_SUBSCRIBE = 0x04,
+  TSW_WIRE_ACK = 0x81,
+  TSW_WIRE_UNKNOWN = 0x82,
+  TSW_WIRE_VALUE = 0x83,
+  TSW_WIRE_UPDATE = 0x84,
+};
+
+struct TSWWireHeader {
+  uint8_t type;
+  uint16_t session;
+  uint16_t seq;
+  uint32_t timeUs;
+};
+
+class TSWWire {
+public:
+  // --- Scalars ---
+  static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+  }
+  static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+  }
+  static uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+  static uint32_t get32(const uint8_t *p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+  static int32_t quantize(float value) {
+    float milli = value * 1000.0f;
+    if (milli > 2147483000.0f)
+      return 2147483000;
+    if (milli < -2147483000.0f)
+      return -2147483000;
+    return (int32_t)(milli < 0 ? milli - 0.5f : milli + 0.5f);
+  }
+  static float dequantize(int32_t milli) { return milli / 1000.0f; }
+
+  // true if sequence number a was sent after b (wrap-around safe)
+  static bool seqNewer(uint16_t a, uint16_t b) { return (int16_t)(a - b) > 0; }
+
+  // --- Encoding, all return the message length ---
+  static uint8_t header(uint8_t *buf, const TSWWireHeader &h) {
+    buf[0] = TSW_WIRE_MAGIC;
+    buf[1] = h.type;
+    put16(buf + 2, h.session);
+    put16(buf + 4, h.seq);
+    put32(buf + 6, h.timeUs);
+    return TSW_WIRE_HEADER_LEN;
+  }
+
+  // SET with count items; buf needs TSW_WIRE_HEADER_LEN + 1 + count * TSW_WIRE_ITEM_LEN
+  static uint16_t set(uint8_t *buf, const TSWWireHeader &h,
+                      const uint8_t *ids, const int32_t *values, uint8_t count) {
+    uint16_t n = header(buf, h);
+    buf[n++] = count;
+    for (uint8_t i = 0; i < count; i++) {
+      buf[n] = ids[i];
+      put32(buf + n + 1, (uint32_t)values[i]);
+      n += TSW_WIRE_ITEM_LEN;
+    }
+    return n;
+  }
+
+  static uint16_t bind(uint8_t *buf, const TSWWireHeader &h, uint8_t id, const char *name) {
+    size_t len = strlen(name);
+    if (len > TSW_WIRE_MAX_NAME)
+      len = TSW_WIRE_MAX_NAME;
+    uint16_t n = header(buf, h);
+    buf[n++] = id;
+    buf[n++] = len;
+    memcpy(buf + n, name, len);
+    return n + len;
+  }
+
+  static uint16_t get(uint8_t *buf, const TSWWireHeader &h, uint8_t id) {
+    uint16_t n = header(buf, h);
+    buf[n++] = id;
+    return n;
+  }
+
+  static uint16_t subscribe(uint8_t *buf, const TSWWireHeader &h, uint16_t intervalMs,
+                            const uint8_t *ids, uint8_t count) {
+    uint16_t n = header(buf, h);
+    put16(buf + n, intervalMs);
+    buf[n + 2] = count;
+    memcpy(buf + n + 3, ids, count);
+    return n + 3 + count;
+  }
+
+  // --- Decoding ---
+  // validates magic and length, returns the payload length or -1
+  static int parseHeader(const uint8_t *buf, uint16_t len, TSWWireHeader &h) {
+    if (len < TSW_WIRE_HEADER_LEN || buf[0] != TSW_WIRE_MAGIC)
+      return -1;
+    h.type = buf[1];
+    h.session = get16(buf + 2);
+    h.seq = get16(buf + 4);
+    h.timeUs = get32(buf + 6);
+    return len - TSW_WIRE_HEADER_LEN;
+  }
+
+  // --- Framing for byte streams ---
+  static uint16_t crc16(const uint8_t *p, uint16_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+      crc ^= (uint16_t)*p++ << 8;
+      for (uint8_t i = 0; i < 8; i++)
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+  }
+
+  // out needs TSW_SLIP_FRAME_LEN(len) bytes; returns the frame length
+  static uint16_t slipEncode(uint8_t *out, const uint8_t *msg, uint16_t len) {
+    uint8_t crc[2];
+    put16(crc, crc16(msg, len));
+    uint16_t n = 0;
+    out[n++] = TSW_SLIP_END; // flushes any line noise on the receiving side
+    for (uint16_t i = 0; i < len + 2; i++) {
+      uint8_t c = i < len ? msg[i] : crc[i - len];
+      if (c == TSW_SLIP_END) {
+        out[n++] = TSW_SLIP_ESC;
+        out[n++] = TSW_SLIP_ESC_END;
+      } else if (c == TSW_SLIP_ESC) {
+        out[n++] = TSW_SLIP_ESC;
+        out[n++] = TSW_SLIP_ESC_ESC;
+      } else {
+        out[n++] = c;
+      }
+    }
+    out[n++] = TSW_SLIP_END;
+    return n;
+  }
+};
+
+// Incremental SLIP decoder: feed() returns the message length once a frame
+// with a valid CRC is complete, 0 otherwise. The message is in buf.
+template <uint16_t N>
+class TSWSlipDecoder {
+public:
+  uint8_t buf[N + 2];
+  uint32_t frames = 0;    // valid frames
+  uint32_t badFrames = 0; // CRC errors, overlong frames
+
+  uint16_t feed(uint8_t c) {
+    if (c == TSW_SLIP_END) {
+      uint16_t n = len;
+      bool overflow = overflowed;
+      len = 0;
+      esc = false;
+      overflowed = false;
+      if (n == 0)
+        return 0; // back-to-back END
+      if (overflow || n < 3 || TSWWire::crc16(buf, n - 2) != TSWWire::get16(buf + n - 2)) {
+        badFrames++;
+        return 0;
+      }
+      frames++;
+      return n - 2;
+    }
+    if (c == TSW_SLIP_ESC) {
+      esc = true;
+      return 0;
+    }
+    if (esc) {
+      c = (c == TSW_SLIP_ESC_END) ? TSW_SLIP_END : (c == TSW_SLIP_ESC_ESC) ? TSW_SLIP_ESC : c;
+      esc = false;
+    }
+    if (len < sizeof(buf))
+      buf[len++] = c;
+    else
+      overflowed = true;
+    return 0;
+  }
+
+private:
+  uint16_t len = 0;
+  bool esc = false;
+  bool overflowed = false;
+};
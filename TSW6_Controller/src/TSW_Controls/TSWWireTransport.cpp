@@ -0,0 +1,348 @@
+/**
+ * @file TSWWireTransport.cpp
+ * @brief Medium independent part of the binary transports to the PC bridge.
+ *
+ * @details
+ * All messages are encoded into stack buffers; the controller table is a
+ * fixed array indexed by the wire id. Replies are read non-blocking in
+ * update() and at the start of every send.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.3
+ */
+
+#include "TSWWireTransport.h"
+
+void TSWWireTransport::start()
+{
+  session = (uint16_t)esp_random();
+  seq = 0;
+  started = true;
+
+  // controls bound before start() announce themselves now
+  for (uint8_t i = 0; i < entryCount; i++)
+    sendBind(i);
+  sendSubscriptions();
+}
+
+// --- Controller table ---
+int TSWWireTransport::findEntry(const char *name) const
+{
+  uint32_t h = tswHashName(name);
+  for (uint8_t i = 0; i < entryCount; i++)
+    if (entries[i].hash == h && strcmp(entries[i].name, name) == 0)
+      return i;
+  return -1;
+}
+
+int TSWWireTransport::bindController(const String &controller)
+{
+  int id = findEntry(controller.c_str());
+  if (id >= 0)
+    return id;
+  if (entryCount >= TSW_WIRE_IDS || controller.length() > TSW_WIRE_MAX_NAME)
+  {
+    Serial.printf("[Wire] Cannot bind %s\n", controller.c_str());
+    return -1;
+  }
+
+  Entry &e = entries[entryCount];
+  memset(&e, 0, sizeof(e));
+  strncpy(e.name, controller.c_str(), sizeof(e.name) - 1);
+  e.hash = tswHashName(e.name);
+  id = entryCount++;
+
+  if (started)
+    sendBind(id);
+  return id;
+}
+
+// --- Subscriptions ---
+bool TSWWireTransport::subscribe(const String &controller)
+{
+  int id = bindController(controller);
+  if (id < 0)
+    return false;
+  entries[id].subscribed = true;
+  sendSubscriptions();
+  return true;
+}
+
+bool TSWWireTransport::getSubscribedValue(const String &controller, float &value, uint32_t *ageMs) const
+{
+  int id = findEntry(controller.c_str());
+  if (id < 0 || !entries[id].remoteValid)
+    return false;
+  value = TSWWire::dequantize(entries[id].remote);
+  if (ageMs)
+    *ageMs = millis() - entries[id].remoteMs;
+  return true;
+}
+
+// all subscribed ids, repeated periodically since the bridge keeps no state across restarts
+void TSWWireTransport::sendSubscriptions()
+{
+  lastSubscribeMs = millis();
+  uint8_t buf[TSW_WIRE_HEADER_LEN + 3 + TSW_WIRE_IDS];
+  uint8_t ids[TSW_WIRE_IDS];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < entryCount; i++)
+    if (entries[i].subscribed)
+      ids[n++] = i;
+  if (n > 0)
+    send(buf, TSWWire::subscribe(buf, nextHeader(TSW_WIRE_SUBSCRIBE), TSW_WIRE_SUBSCRIBE_MS, ids, n));
+}
+
+uint8_t TSWWireTransport::getPendingCount() const
+{
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < entryCount; i++)
+    if (entries[i].pending)
+      n++;
+  return n;
+}
+
+// --- Sending ---
+TSWWireHeader TSWWireTransport::nextHeader(uint8_t type)
+{
+  TSWWireHeader h;
+  h.type = type;
+  h.session = session;
+  if (++seq == 0)
+    seq = 1; // 0 marks entries that were never sent
+  h.seq = seq;
+  h.timeUs = micros();
+  return h;
+}
+
+bool TSWWireTransport::send(const uint8_t *buf, uint16_t len)
+{
+  if (!started)
+    return false;
+  stats.messages++;
+  return writeMessage(buf, len);
+}
+
+void TSWWireTransport::sendBind(uint8_t id)
+{
+  uint8_t buf[TSW_WIRE_MAX_MESSAGE];
+  send(buf, TSWWire::bind(buf, nextHeader(TSW_WIRE_BIND), id, entries[id].name));
+}
+
+// one SET message with the latest value of each given controller
+bool TSWWireTransport::sendSet(const uint8_t *ids, uint8_t count)
+{
+  uint8_t buf[TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_BATCH * TSW_WIRE_ITEM_LEN];
+  int32_t values[TSW_WIRE_BATCH];
+  for (uint8_t i = 0; i < count; i++)
+    values[i] = entries[ids[i]].value;
+
+  TSWWireHeader h = nextHeader(TSW_WIRE_SET);
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < count; i++)
+  {
+    Entry &e = entries[ids[i]];
+    e.seq = h.seq;
+    e.sentMs = now;
+    e.pending = true;
+  }
+  return send(buf, TSWWire::set(buf, h, ids, values, count));
+}
+
+bool TSWWireTransport::setControllerValue(const String &controller, float value)
+{
+  TSWSetItem item = {controller.c_str(), value, -1};
+  return setControllerValues(&item, 1) == 1;
+}
+
+// status 200 means "handed to the bridge"; delivery is tracked via ACKs
+uint8_t TSWWireTransport::setControllerValues(TSWSetItem *items, uint8_t count)
+{
+  receive();
+
+  uint8_t ids[TSW_WIRE_BATCH];
+  uint8_t index[TSW_WIRE_BATCH]; // item of each id in the current message
+  uint8_t n = 0;
+  uint8_t ok = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    items[i].status = -1;
+    int id = findEntry(items[i].controller);
+    if (id < 0)
+      id = bindController(items[i].controller);
+    if (id >= 0)
+    {
+      Entry &e = entries[id];
+      e.value = TSWWire::quantize(items[i].value);
+      e.retries = 0;
+      ids[n] = id;
+      index[n++] = i;
+    }
+
+    if (n > 0 && (n == TSW_WIRE_BATCH || i + 1 == count))
+    {
+      bool sent = sendSet(ids, n);
+      for (uint8_t j = 0; j < n; j++)
+        items[index[j]].status = sent ? 200 : -1;
+      if (sent)
+        ok += n;
+      n = 0;
+    }
+  }
+  return ok;
+}
+
+float TSWWireTransport::getControllerValue(const String &controller)
+{
+  int id = findEntry(controller.c_str());
+  if (id >= 0 && entries[id].remoteValid)
+    return TSWWire::dequantize(entries[id].remote); // streamed, no round trip
+  if (id < 0)
+    id = bindController(controller);
+  if (id < 0 || !started)
+    return 0.0f;
+
+  uint8_t buf[TSW_WIRE_HEADER_LEN + 1];
+  TSWWireHeader h = nextHeader(TSW_WIRE_GET);
+  valueSeq = h.seq;
+  valueReady = false;
+  if (!send(buf, TSWWire::get(buf, h, id)))
+    return 0.0f;
+
+  unsigned long start = millis();
+  while (!valueReady && millis() - start < TSW_RESPONSE_TIMEOUT_MS)
+  {
+    receive();
+    if (!valueReady)
+      delay(1);
+  }
+  return valueReady ? TSWWire::dequantize(valueMilli) : 0.0f;
+}
+
+// --- Replies and retransmits ---
+void TSWWireTransport::update()
+{
+  if (!started)
+    return;
+  receive();
+
+  if (millis() - lastSubscribeMs >= TSW_WIRE_RESUBSCRIBE_MS)
+    sendSubscriptions();
+
+  uint8_t ids[TSW_WIRE_BATCH];
+  uint8_t n = 0;
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < entryCount; i++)
+  {
+    Entry &e = entries[i];
+    if (!e.pending || now - e.sentMs < TSW_WIRE_RETRY_MS)
+      continue;
+
+    if (e.retries >= TSW_WIRE_MAX_RETRIES)
+    {
+      e.pending = false;
+      stats.lost++;
+      TRACE_PRINT("[Wire] %s -> %.3f lost\n", e.name, TSWWire::dequantize(e.value));
+      continue;
+    }
+    e.retries++;
+    stats.retransmits++;
+    ids[n++] = i;
+    if (n == TSW_WIRE_BATCH)
+    {
+      sendSet(ids, n);
+      n = 0;
+    }
+  }
+  if (n > 0)
+    sendSet(ids, n);
+}
+
+void TSWWireTransport::receive()
+{
+  uint8_t buf[TSW_WIRE_HEADER_LEN + 1 + TSW_WIRE_BATCH * TSW_WIRE_ITEM_LEN];
+  uint16_t len;
+  while ((len = readMessage(buf, sizeof(buf))) > 0)
+    handle(buf, len);
+}
+
+void TSWWireTransport::handle(const uint8_t *buf, uint16_t len)
+{
+  TSWWireHeader h;
+  int payload = TSWWire::parseHeader(buf, len, h);
+  if (payload < 0 || h.session != session)
+    return; // not ours or from a previous boot
+  const uint8_t *p = buf + TSW_WIRE_HEADER_LEN;
+
+  switch (h.type)
+  {
+  case TSW_WIRE_ACK:
+    if (payload < 3)
+      return;
+    stats.acked++;
+    stats.stale += p[1];
+    stats.rejected += p[2];
+    recordRtt(h.timeUs);
+    for (uint8_t i = 0; i < entryCount; i++)
+      if (entries[i].pending && entries[i].seq == h.seq)
+      {
+        entries[i].pending = false;
+        if (deliveryHandler)
+          deliveryHandler(entries[i].hash, TSWWire::dequantize(entries[i].value));
+      }
+    break;
+
+  case TSW_WIRE_UNKNOWN:
+    if (payload < 1 || p[0] >= entryCount)
+      return;
+    stats.rebinds++;
+    sendBind(p[0]);
+    if (entries[p[0]].seq == 0)
+      break; // never set (subscription or GET only), nothing to resend
+    // keep the value pending past the ACK of this message, resend it with the next update()
+    entries[p[0]].seq = seq;
+    entries[p[0]].sentMs = millis() - TSW_WIRE_RETRY_MS;
+    entries[p[0]].pending = true;
+    break;
+
+  case TSW_WIRE_UPDATE:
+  {
+    if (payload < 1)
+      return;
+    uint8_t count = p[0];
+    if (count > (payload - 1) / TSW_WIRE_ITEM_LEN)
+      count = (payload - 1) / TSW_WIRE_ITEM_LEN;
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < count; i++)
+    {
+      const uint8_t *item = p + 1 + i * TSW_WIRE_ITEM_LEN;
+      if (item[0] >= entryCount)
+        continue;
+      Entry &e = entries[item[0]];
+      e.remote = (int32_t)TSWWire::get32(item + 1);
+      e.remoteMs = now;
+      e.remoteValid = true;
+      stats.updates++;
+    }
+    break;
+  }
+
+  case TSW_WIRE_VALUE:
+    if (payload < 5 || h.seq != valueSeq)
+      return;
+    valueMilli = (int32_t)TSWWire::get32(p + 1);
+    valueReady = true;
+    recordRtt(h.timeUs);
+    break;
+  }
+}
+
+void TSWWireTransport::recordRtt(uint32_t timeUs)
+{
+  uint32_t rtt = micros() - timeUs;
+  stats.lastRttUs = rtt;
+  stats.avgRttUs = stats.avgRttUs ? stats.avgRttUs + ((int32_t)(rtt - stats.avgRttUs) >> 3) : rtt;
+  if (rtt > stats.maxRttUs)
+    stats.maxRttUs = rtt;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file TSWWireTransport.h
+ * @brief Base class for the binary transports to the PC bridge (Bridge/tsw_bridge.py).
+ *
+ * @details
+ * Alternative to TSWSpider: instead of HTTP requests to the TSW API, every
+ * update is a small message in the TSWWire format (controller id, quantized
+ * value, sequence number). The bridge on the game PC turns it into local
+ * HTTP calls, so the controller needs neither TCP handshakes nor HTTP
+ * parsing. Sending never blocks.
+ *
+ * This class holds everything that does not depend on the medium; derived
+ * classes only move whole messages:
+ *   - TSWUdpTransport     one datagram per message (WiFi)
+ *   - TSWSerialTransport  SLIP frames with CRC over the UART (USB cable)
+ *
+ * Delivery:
+ *   - controllers get small ids via bindController(); the name is sent once
+ *     as BIND and again whenever the bridge answers UNKNOWN (e.g. restart)
+ *   - every SET message carries a new sequence number; the bridge ignores
+ *     values older than the last one applied for a controller (reordering)
+ *   - each controller keeps only its latest value; if no ACK arrives within
+ *     TSW_WIRE_RETRY_MS, the latest value is sent again, up to
+ *     TSW_WIRE_MAX_RETRIES times (loss)
+ *   - ACKs echo the send time, giving the round-trip time to the bridge;
+ *     the bridge acknowledges on receipt and calls TSW afterwards
+ *
+ * Game values can be streamed back: subscribe() asks the bridge to poll a
+ * controller every TSW_WIRE_SUBSCRIBE_MS and push changes (UPDATE). The
+ * latest pushed value is kept per controller and getControllerValue()
+ * returns it without a round trip. Subscriptions are repeated every
+ * TSW_WIRE_RESUBSCRIBE_MS, so they survive a restart of the bridge.
+ *
+ * update() processes replies and retransmits; call it from loop().
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.3
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TSWTransport.h"
+#include "TSWWire.h"
+#include "../config.h"
+
+#ifndef TSW_WIRE_IDS
+#define TSW_WIRE_IDS 48
+#endif
+#ifndef TSW_WIRE_RETRY_MS
+#define TSW_WIRE_RETRY_MS 40
+#endif
+#ifndef TSW_WIRE_MAX_RETRIES
+#define TSW_WIRE_MAX_RETRIES 5
+#endif
+#ifndef TSW_WIRE_SUBSCRIBE_MS
+#define TSW_WIRE_SUBSCRIBE_MS 100
+#endif
+#ifndef TSW_WIRE_RESUBSCRIBE_MS
+#define TSW_WIRE_RESUBSCRIBE_MS 5000
+#endif
+#ifndef TSW_RESPONSE_TIMEOUT_MS
+#define TSW_RESPONSE_TIMEOUT_MS 1000
+#endif
+
+#define TSW_WIRE_BATCH 32 // items per SET message
+
+class TSWWireTransport : public TSWTransport {
+public:
+  struct Stats {
+    uint32_t messages = 0;    // messages sent (all types)
+    uint32_t acked = 0;       // SET messages acknowledged by the bridge
+    uint32_t retransmits = 0; // values sent again after a missing ACK
+    uint32_t lost = 0;        // values given up after TSW_WIRE_MAX_RETRIES
+    uint32_t rebinds = 0;     // names sent again after UNKNOWN
+    uint32_t stale = 0;       // values the bridge dropped as out of order
+    uint32_t rejected = 0;    // TSW refused the previous value of the controller (HTTP != 200 on the PC)
+    uint32_t lastRttUs = 0;
+    uint32_t avgRttUs = 0;    // moving average (1/8)
+    uint32_t maxRttUs = 0;
+    uint32_t updates = 0;     // values pushed by the bridge for subscriptions
+  };
+
+private:
+  struct Entry {
+    char name[TSW_WIRE_MAX_NAME + 1];
+    uint32_t hash;
+    int32_t value;     // latest value, thousandths
+    uint16_t seq;      // message that carried it last
+    uint32_t sentMs;
+    uint8_t retries;
+    bool pending;      // waiting for the ACK of seq
+    bool subscribed;
+    bool remoteValid;  // remote holds a value pushed by the bridge
+    int32_t remote;    // latest game value, thousandths
+    uint32_t remoteMs;
+  };
+
+  bool started = false;
+  uint16_t session = 0;
+  uint16_t seq = 0;
+  uint32_t lastSubscribeMs = 0;
+
+  TSWDeliveryHandler deliveryHandler = nullptr;
+  Entry entries[TSW_WIRE_IDS];
+  uint8_t entryCount = 0;
+  Stats stats;
+
+  // answer of the last GET
+  uint16_t valueSeq = 0;
+  bool valueReady = false;
+  int32_t valueMilli = 0;
+
+  int findEntry(const char *name) const;
+  TSWWireHeader nextHeader(uint8_t type);
+  bool send(const uint8_t *buf, uint16_t len);
+  void sendBind(uint8_t id);
+  bool sendSet(const uint8_t *ids, uint8_t count);
+  void sendSubscriptions();
+  void receive();
+  void handle(const uint8_t *buf, uint16_t len);
+  void recordRtt(uint32_t timeUs);
+
+protected:
+  // --- Medium, implemented by the derived transports ---
+  virtual bool writeMessage(const uint8_t *buf, uint16_t len) = 0;
+  // next complete message or 0 if none is waiting; never blocks
+  virtual uint16_t readMessage(uint8_t *buf, uint16_t size) = 0;
+
+  // call once the medium is ready: new session, announces bound controllers
+  void start();
+
+public:
+  virtual void update();
+  bool isStarted() const { return started; }
+
+  // --- Values streamed back from the game ---
+  bool subscribe(const String &controller);
+  // latest pushed value; false if none arrived yet
+  bool getSubscribedValue(const String &controller, float &value, uint32_t *ageMs = nullptr) const;
+
+  // --- TSWTransport ---
+  bool setControllerValue(const String &controller, float value) override;
+  uint8_t setControllerValues(TSWSetItem *items, uint8_t count) override;
+  float getControllerValue(const String &controller) override;
+  int bindController(const String &controller) override;
+  void setDeliveryHandler(TSWDeliveryHandler handler) override { deliveryHandler = handler; }
+
+  const Stats &getStats() const { return stats; }
+  uint8_t getControllerCount() const { return entryCount; }
+  uint8_t getPendingCount() const;
+};
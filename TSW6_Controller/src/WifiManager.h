@@ -19,6 +19,9 @@ WebServer server(80);
 DNSServer dnsServer;
 bool apMode = false;
 
+// optional hook to append further rows (e.g. TSW connection stats) to /status
+void (*statusPageExtension)(String &body) = nullptr;
+
 // -------------------------------------------------------------
 // mDNS
 // -------------------------------------------------------------
@@ -245,6 +248,8 @@ void handleStatusPage()
     body += "<label>SSID</label><div>" + currSsid + "</div>";
     body += "<label>IP</label><div>" + String(apMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString()) + "</div>";
     body += "<label>Signal (RSSI)</label><div>" + String(WiFi.RSSI()) + " dBm</div>";
+    if (statusPageExtension)
+        statusPageExtension(body);
     body += "<div class='btnbar'><a class='btn btn-ghost' href='/reboot'>Neustart</a></div>";
     server.send(200, "text/html", buildPage("Status - " + String(DEVICE_NAME), body));
 }
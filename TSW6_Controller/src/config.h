@@ -5,23 +5,95 @@
 
 #define USE_WIFIMANAGER 1
 
+// Transport to the game PC
+#define TSW_TRANSPORT_HTTP 0   // TSW API directly (firewall rule / port proxy on the PC)
+#define TSW_TRANSPORT_UDP 1    // binary UDP to Bridge/tsw_bridge.py on the PC
+#define TSW_TRANSPORT_SERIAL 2 // binary frames over the USB cable to Bridge/tsw_bridge.py
+#define TSW_TRANSPORT_WEBSOCKET 3 // binary WebSocket to Bridge/tsw_bridge.py, game values streamed back
+#define TSW_TRANSPORT TSW_TRANSPORT_HTTP
+#define TSW_SERIAL_BAUD 921600 // UART rate with TSW_TRANSPORT_SERIAL (serial monitor too)
+
 #define USE_ANALOG_SLIDER 1
 #define PIN_ANALOG_SLIDER {GPIO_NUM_32, GPIO_NUM_35, GPIO_NUM_34}
 #define ANALOG_SLIDER_INVERTED {true, true, false}
+#define ANALOG_SLIDER_CONTROLLERS {"sld1", "sld2", "sld3"} // TSW controller per slider pin
 
 #define USE_Rotary 0
-#define PIN_Rotary {GPIO_NUM_32, GPIO_NUM_35}
+#define PIN_Rotary {GPIO_NUM_16, GPIO_NUM_17} // A, B per knob
 
 #define USE_GAMEPAD 0
 #define PIN_GAMEPAD {GPIO_NUM_32, GPIO_NUM_35, GPIO_NUM_12}
-#define USE_Button 0
+#define USE_BUTTON 0
 #define PIN_BUTTONS \
   {                 \
   }
+#define BUTTON_IDS {} // control id per button pin
 
 #define PIN_EXPANDERS {4, 5}
 #define PIN_EXPANDERSRESET GPIO_NUM_25
 #define NUM_OF_EXPANDERS 2
+#define CONTROL_REGISTRY_SPARE 8 // registry entries beyond the pins above (controls without a pin of their own)
+#define CONTROL_STATIC_LOOP 1 // loop() polls the typed control banks; 0: through the registry (needed with USE_GAMEPAD)
+
+// TSW API (Spider)
+#define TSW_HOST "192.168.4.2"      // fallback address of the TSW PC / port proxy
+#define TSW_API_PORT 31270
+#define TSW_SPIDER_CONNECTIONS 2    // persistent keep-alive sockets to the TSW host/proxy
+#define TSW_CONNECT_TIMEOUT_MS 500
+#define TSW_RESPONSE_TIMEOUT_MS 1000
+#define TSW_PIPELINE_DEPTH 8        // sets written back-to-back before reading responses
+#define TSW_SPIDER_ROUTES 48        // controllers with a precomputed request line
+#define TSW_READ_CACHE 16           // read paths cached by TSWSpider (0 = off)
+#define TSW_READ_TTL_MS 100         // cached reads are at most this old (per path: setReadTtl())
+#define TSW_HEADER_LEN 160          // Host/Connection/DTGCommKey header block
+#define TSW_TX_BUFFER_LEN 1024      // per-connection request buffer (one pipelined batch)
+#define TSW_SUBSCRIPTION_MAX 16     // paths per TSWSubscription
+#define TSW_SUBSCRIPTION_PATH_LEN 96
+#define TSW_STATE_READS "Function.HUD_GetSpeed" // controllers read in one /subscription poll, comma-separated
+#define TSW_SUBSCRIPTION_POLL_MS 200 // interval of that poll (0 = no subscription, every read on its own)
+#define TSW_SEND_SLOTS 48           // controllers with their own latest-value slot
+#define TSW_SEND_TASK_CORE 0        // network task runs next to the WiFi stack
+#define TSW_SEND_TASK_STACK 4096
+#define TSW_SEND_TASK_PRIO 2
+#define TSW_SEND_RESYNC_MS 100      // replay values that did not reach TSW (host down, WiFi lost)
+#define TSW_RATE_BUDGET 4           // requests in flight shared by all moving controllers
+#define TSW_RATE_MIN_INTERVAL_MS 20 // fastest send interval per controller (idle game PC)
+#define TSW_RATE_MAX_INTERVAL_MS 1000 // slowest send interval per controller (overloaded game PC)
+#define TSW_RATE_WINDOW_MS 1000     // a controller counts as active this long after its last send
+#define TSW_PRIORITY_CONTROLLERS "EmergencyBrake,Sifa,Horn" // high lane, comma-separated (MCP buttons: "Button_<n>")
+#define TSW_PRIORITY_BUDGET_MS 50   // high lane updates slower than this are counted
+#define TSW_BREAKER_FAILURES 3      // failed requests in a row until the circuit opens
+#define TSW_BREAKER_PROBE_MIN_MS 500
+#define TSW_BREAKER_PROBE_MAX_MS 10000
+#define TSW_SYNC_MAX 48             // controls in the boot sync batch / RTC table (warm restart)
+#define TSW_ENDPOINT_INDEX 1        // check bound controllers against /list of the loco at boot
+#define TSW_INDEX_LIST_PATH "/list"
+#define TSW_INDEX_LOCO_PATH "/get/CurrentDrivableActor.ObjectClass" // tells the locos apart
+#define TSW_INDEX_MAX 512           // endpoints per loco
+#define TSW_INDEX_MAX_BYTES 8192    // their names (index file on LittleFS, one per loco)
+
+// PC bridge (TSW_TRANSPORT_UDP / _SERIAL / _WEBSOCKET)
+#define TSW_BRIDGE_HOST "192.168.4.2"
+#define TSW_BRIDGE_PORT 31271
+#define TSW_BRIDGE_WS_PORT 31272
+#define TSW_WIRE_IDS 48             // controllers with a wire id
+#define TSW_WIRE_RETRY_MS 40        // resend the latest value if no ACK arrived
+#define TSW_WIRE_MAX_RETRIES 5
+#define TSW_WIRE_SUBSCRIBE_MS 100   // bridge polls subscribed game values at this interval
+#define TSW_WIRE_RESUBSCRIBE_MS 5000
+
+// TSW host discovery via mDNS, result cached in wifi.cfg (not with TSW_TRANSPORT_SERIAL)
+#define TSW_DISCOVERY 1
+#define TSW_MDNS_HOSTNAME ""        // optional name of the game PC (Windows answers <name>.local)
+#define TSW_DISCOVERY_TIMEOUT_MS 1500
+#define TSW_DISCOVERY_REVALIDATE_MS 30000 // probe the host, search again only if it is gone
+
+// Macros: sequences of sets from LittleFS, started by a button or knob
+#define USE_MACROS 1
+#define TSW_MACRO_FILE "/macros.json"
+#define TSW_MACRO_MAX 16            // macros
+#define TSW_MACRO_STEPS 128         // values in all macros together (max 255)
+#define TSW_MACRO_NAMES_LEN 1024    // bytes for the controller and macro names
 
 // WLAN
 #define SETUP_BUTTON 26 // if pressed LOLIN Starts in AP-Mode
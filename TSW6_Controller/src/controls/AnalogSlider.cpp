@@ -36,8 +36,9 @@ void AnalogSlider::begin()
   analogSetPinAttenuation(pin, ADC_11db);   
   #endif
   delay(5); // small pause after USB init
-  lastRaw = analogRead(pin) - zero;
-  lastValue = getPercent(lastRaw);
+  // same path as update(), so the first update() only reports real movement
+  lastRaw = readRaw();
+  lastValue = constrain(getPercent(lastRaw), 0, 100);
   lastChangeReason = "init";
 }
 
@@ -50,13 +51,7 @@ bool AnalogSlider::update()
     return false;
   lastRead = now;
 
-  int newRaw = analogRead(pin) - zero;
-  newRaw = constrain(newRaw, 0, MAX_ANALOG);
-
-  // --- Hardware inversion ---
-  if (inverted)
-    newRaw = MAX_ANALOG - newRaw;
-
+  int newRaw = readRaw();
   if (abs(newRaw - lastRaw) < rawThreshold)
     return false;
   lastRaw = newRaw;
@@ -92,6 +87,17 @@ void AnalogSlider::setInverted(bool inv) { inverted = inv; }
 void AnalogSlider::setRawThreshold(int t) { rawThreshold = t; }
 
 // --- Helper ---
+int AnalogSlider::readRaw() const
+{
+  int raw = analogRead(pin) - zero;
+  raw = constrain(raw, 0, MAX_ANALOG);
+
+  // --- Hardware inversion ---
+  if (inverted)
+    raw = MAX_ANALOG - raw;
+  return raw;
+}
+
 int AnalogSlider::getPercent(int raw) const
 {
   raw = constrain(raw, 0, MAX_ANALOG);
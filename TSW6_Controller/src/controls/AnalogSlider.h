@@ -53,6 +53,7 @@ private:
 #endif
 
   int getPercent(int raw) const;
+  int readRaw() const;     // ADC minus zero, clamped and inverted
 
 public:
   explicit AnalogSlider(const String& id, uint8_t gpio);
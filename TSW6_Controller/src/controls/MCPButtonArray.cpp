@@ -13,6 +13,7 @@
  * @brief Stable MCP23S17 button array handler with debouncing and trace throttling.
  */
 
+#include <new>
 #include "repo/controlsRepo.h"
 #include "MCPButtonArray.h"
 #include "MCPButtonProxy.h"
@@ -20,13 +21,21 @@
 #define MIN_DEBOUNCE_MS 30
 #define TRACE_THROTTLE_MS 150
 
+// proxies of all inputs, constructed in place by begin()
+alignas(MCPButtonProxy) static uint8_t proxyArena[TOTAL_BUTTONS][sizeof(MCPButtonProxy)];
+static uint8_t proxiesUsed = 0;
+
+size_t MCPButtonArray::getProxyFootprint()
+{
+    return sizeof(proxyArena);
+}
+
 MCPButtonArray::MCPButtonArray(const String &idPrefix, unsigned int debounce)
     : Control(idPrefix, 0),
       debounceDelay(debounce),
       lastEventIndex(-1),
       lastPollTime(0)
 {
-    expanders = new Adafruit_MCP23X17[expanderCount];
     memset(states, HIGH, sizeof(states));
     memset(readings, HIGH, sizeof(readings));
     memset(debounceTimes, 0, sizeof(debounceTimes));
@@ -74,8 +83,13 @@ void MCPButtonArray::begin()
 
     for (uint8_t i = 0; i < expanderCount * 16; i++)
     {
-        String id = getButtonId(i);
-        auto *proxy = new MCPButtonProxy(id, this, i);
+        if (proxiesUsed >= TOTAL_BUTTONS)
+        {
+            Serial.printf("[ERROR] MCPButtonProxy arena full, %s_%02u and the rest not registered\n",
+                          getId().c_str(), i + 1);
+            break;
+        }
+        auto *proxy = new (proxyArena[proxiesUsed++]) MCPButtonProxy(getButtonId(i), this, i);
         ControlRegistry::registerControl(proxy, "MCPButton");
     }
 }
@@ -146,13 +160,6 @@ float MCPButtonArray::getValue() const
     return (states[lastEventIndex] == LOW) ? 1.0f : 0.0f;
 }
 
-bool MCPButtonArray::getButtonState(uint8_t index) const
-{
-    if (index >= expanderCount * 16)
-        return false;
-    return (states[index] == LOW);
-}
-
 String MCPButtonArray::getButtonId(uint8_t index) const
 {
     char buf[12];
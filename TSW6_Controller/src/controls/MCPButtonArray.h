@@ -9,6 +9,10 @@
  * The MCPButtonArray itself is also registered as a Control to allow
  * central debugging and polling in the main loop.
  *
+ * Nothing is allocated on the heap: the expander drivers are members and
+ * the proxies are constructed in a static arena of TOTAL_BUTTONS entries
+ * (getProxyFootprint()).
+ *
  * Hardware requirements:
  *  - One or more MCP23S17 expanders connected via SPI
  *  - Each input pin configured as INPUT_PULLUP
@@ -24,7 +28,7 @@
  * @date
  *   2025-11-02
  * @version
- *   1.2
+ *   1.4
  */
 
 #pragma once
@@ -49,7 +53,7 @@ const uint8_t csPins[] = PIN_EXPANDERS;
 class MCPButtonArray : public Control
 {
 private: 
-  Adafruit_MCP23X17* expanders;  // <== HIER
+  Adafruit_MCP23X17 expanders[NUM_OF_EXPANDERS];
   uint8_t expanderCount = NUM_OF_EXPANDERS;
   bool states[TOTAL_BUTTONS];
   bool readings[TOTAL_BUTTONS];
@@ -68,7 +72,14 @@ public:
   float getValue() const override;
 
   void reset();
-  bool getButtonState(uint8_t index) const;
+  // inline: TSWMCPButton reads it for every button on every pass
+  bool getButtonState(uint8_t index) const
+  {
+    return index < expanderCount * 16 && states[index] == LOW;
+  }
   int getLastEventIndex() const { return lastEventIndex; }
   String getButtonId(uint8_t index) const;
+
+  // bytes of the proxy arena shared by all arrays
+  static size_t getProxyFootprint();
 };
@@ -13,7 +13,8 @@
  *
  * Example:
  * @code
- *   auto *proxy = new MCPButtonProxy("BTN_05", &mcpArray, 5);
+ *   // MCPButtonArray::begin(), in its static arena
+ *   auto *proxy = new (slot) MCPButtonProxy("BTN_05", &mcpArray, 5);
  *   ControlRegistry::registerControl(proxy, "MCPButton");
  * @endcode
  *
@@ -25,7 +26,7 @@
  * @date
  *   2025-11-02
  * @version
- *   1.1
+ *   1.2
  */
 
 #pragma once
@@ -33,7 +34,7 @@
 #include "MCPButtonArray.h"
 #include "../config.h"
 
-class MCPButtonProxy : public Control
+class MCPButtonProxy final : public Control
 {
 private:
     MCPButtonArray *parent;
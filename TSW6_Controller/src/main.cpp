@@ -6,7 +6,63 @@
 #endif
 
 #include "TSW_Controls/TSWSpider.h"
+#include "TSW_Controls/TSWSendQueue.h"
+#include "TSW_Controls/TSWStartupSync.h"
 TSWSpider tswSpider = TSWSpider();
+TSWSendQueue tswSendQueue(&tswSpider); // controls enqueue, network task sends
+
+#if TSW_TRANSPORT == TSW_TRANSPORT_UDP
+#include "TSW_Controls/TSWUdpTransport.h"
+TSWUdpTransport tswUdp; // non-blocking, no queue needed
+TSWWireTransport *tswWire = &tswUdp;
+TSWTransport *tswTransport = &tswUdp;
+#elif TSW_TRANSPORT == TSW_TRANSPORT_SERIAL
+#include "TSW_Controls/TSWSerialTransport.h"
+TSWSerialTransport tswSerial(Serial); // shares the UART with the log output
+TSWWireTransport *tswWire = &tswSerial;
+TSWTransport *tswTransport = &tswSerial;
+#elif TSW_TRANSPORT == TSW_TRANSPORT_WEBSOCKET
+#include "TSW_Controls/TSWWebSocketTransport.h"
+TSWWebSocketTransport tswWebSocket; // reconnects from update()
+TSWWireTransport *tswWire = &tswWebSocket;
+TSWTransport *tswTransport = &tswWebSocket;
+#else
+TSWTransport *tswTransport = &tswSendQueue;
+#endif
+
+// mDNS discovery needs WiFi and the config file for its cache
+#define TSW_USE_DISCOVERY (TSW_DISCOVERY && USE_WIFIMANAGER && TSW_TRANSPORT != TSW_TRANSPORT_SERIAL)
+#if TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+#define TSW_MDNS_SERVICE "tsw-api", "tcp"
+#define TSW_DEFAULT_HOST TSW_HOST
+#define TSW_PROBE_PORT TSW_API_PORT
+#else
+#define TSW_MDNS_SERVICE "tsw-bridge", "udp"
+#define TSW_DEFAULT_HOST TSW_BRIDGE_HOST
+#define TSW_PROBE_PORT TSW_BRIDGE_WS_PORT // UDP cannot be probed, the bridge's WebSocket port can
+#endif
+#if TSW_USE_DISCOVERY
+#include "TSW_Controls/TSWDiscovery.h"
+TSWDiscovery tswDiscovery;
+#endif
+#if USE_MACROS
+#include "TSW_Controls/TSWMacro.h"
+TSWMacroEngine tswMacros;
+#endif
+#if TSW_SUBSCRIPTION_POLL_MS > 0 && TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+#define TSW_USE_SUBSCRIPTION 1
+#include "TSW_Controls/TSWSubscription.h"
+TSWSubscription tswState(&tswSpider); // game state of TSW_STATE_READS, one request per poll
+#else
+#define TSW_USE_SUBSCRIPTION 0
+#endif
+#if TSW_ENDPOINT_INDEX && TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+#define TSW_USE_INDEX 1
+#include "TSW_Controls/TSWEndpointIndex.h"
+TSWEndpointIndex tswIndex;
+#else
+#define TSW_USE_INDEX 0
+#endif
 
 #include "TSW_Controls/TSWLever.setup.h"
 #include "TSW_Controls/TSWRotaryKnob.setup.h"
@@ -14,9 +70,180 @@ TSWSpider tswSpider = TSWSpider();
 #include "TSW_Controls/TSWMCPButton.setup.h"
 #include "TSW_Controls/TSWButton.setup.h"
 
+#if TSW_USE_SUBSCRIPTION
+// subscribes every controller of TSW_STATE_READS; the poll task registers
+// them as soon as the game answers, reads of the spider use the polls
+void setupStateReads()
+{
+  char path[TSW_SUBSCRIPTION_PATH_LEN];
+  const char *list = TSW_STATE_READS;
+  while (*list)
+  {
+    const char *comma = strchr(list, ',');
+    size_t len = comma ? comma - list : strlen(list);
+    if (len > 0)
+    {
+      snprintf(path, sizeof(path), TSW_SUBSCRIPTION_ACTOR "%.*s", (int)len, list);
+      tswState.add(path);
+    }
+    list += comma ? len + 1 : len;
+  }
+  if (tswState.size() == 0)
+    return;
+  tswSpider.setSubscription(&tswState);
+  tswState.startPolling(TSW_SUBSCRIPTION_POLL_MS);
+}
+#endif
+
+#if TSW_USE_DISCOVERY
+// called from setup() and later from the discovery task
+void onTswHostChanged(const char *host)
+{
+  strncpy(cfg.tswHost, host, sizeof(cfg.tswHost) - 1);
+  cfg.tswHost[sizeof(cfg.tswHost) - 1] = '\0';
+  saveConfig();
+#if TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+  if (tswSendQueue.isRunning()) // setup is done, switch the live connections
+    tswSpider.retarget(host, TSW_API_PORT);
+#else
+  Serial.printf("[Discovery] Bridge address %s is used after the next restart\n", host);
+#endif
+}
+#endif
+
+#if USE_WIFIMANAGER
+void appendSyncStatus(String &body)
+{
+  const TSWStartupSync::Stats &y = TSWStartupSync::getStats();
+  body += "<label>Startabgleich</label><div>" + String(y.warm ? "Warmstart" : "Kaltstart") + ": " +
+          String(y.sent) + " von " + String(y.sampled) + " Werten gesendet, " + String(y.unchanged) +
+          " unverändert, " + String(y.unanswered) + " ohne Antwort, " + String(y.durationMs) + " ms</div>";
+  size_t controlBytes = ControlRegistry::getFootprint();
+#if USE_MCPBUTTONARRAY
+  controlBytes += MCPButtonArray::getProxyFootprint();
+#endif
+  body += "<label>Controls</label><div>" + String(ControlRegistry::getCount()) + " von " +
+          String(ControlRegistry::getCapacity()) + " Einträgen, " + String(controlBytes) +
+          " Bytes statisch (Registry und MCP-Proxys)</div>";
+#if TSW_USE_DISCOVERY
+  TSWDiscovery::Stats d = tswDiscovery.getStats();
+  body += "<label>TSW Host</label><div>" + tswDiscovery.getHost() + " (" +
+          String(TSWDiscovery::sourceName(d.source)) + "), " + String(d.probes - d.probeFailures) + "/" +
+          String(d.probes) + " Prüfungen ok, " + String(d.discoveries) + " Suchen, " + String(d.changes) +
+          " Wechsel</div>";
+#endif
+#if USE_MACROS
+  TSWMacroEngine::Stats m = tswMacros.getStats();
+  body += "<label>Makros</label><div>" + String(m.macros) + " mit " + String(m.steps) + " Schritten (" +
+          String(m.ramBytes) + " Bytes), " + String(m.triggered) + "× gestartet, " + String(m.values) +
+          " Werte in " + String(m.batches) + " Paketen, " + String(m.failed) + " fehlgeschlagen, " +
+          String(m.unresolved) + " Auslöser unbekannt</div>";
+#endif
+}
+
+#if TSW_TRANSPORT != TSW_TRANSPORT_HTTP
+void appendSpiderStatus(String &body)
+{
+  const TSWWireTransport::Stats &s = tswWire->getStats();
+#if TSW_TRANSPORT == TSW_TRANSPORT_UDP
+  body += "<label>Bridge</label><div>" + String(TSW_BRIDGE_HOST) + ":" + String(TSW_BRIDGE_PORT) +
+          " (UDP, " + String(tswWire->getControllerCount()) + " Controller)</div>";
+#elif TSW_TRANSPORT == TSW_TRANSPORT_WEBSOCKET
+  body += "<label>Bridge</label><div>ws://" + String(TSW_BRIDGE_HOST) + ":" + String(TSW_BRIDGE_WS_PORT) +
+          (tswWebSocket.isConnected() ? " verbunden" : " getrennt") + " (" + String(tswWebSocket.getConnects()) +
+          " Verbindungen, " + String(tswWire->getControllerCount()) + " Controller)</div>";
+#else
+  body += "<label>Bridge</label><div>USB-Seriell " + String(TSW_SERIAL_BAUD) + " Baud (" +
+          String(tswWire->getControllerCount()) + " Controller, " + String(tswSerial.getBadFrames()) +
+          " fehlerhafte Frames)</div>";
+#endif
+  body += "<label>Nachrichten</label><div>" + String(s.messages) + " gesendet, " + String(s.acked) +
+          " bestätigt, " + String(tswWire->getPendingCount()) + " offen</div>";
+  body += "<label>Verluste</label><div>" + String(s.retransmits) + " wiederholt, " + String(s.lost) +
+          " verloren, " + String(s.stale) + " veraltet, " + String(s.rejected) + " abgelehnt</div>";
+  body += "<label>Round-Trip</label><div>" + String(s.avgRttUs / 1000.0f, 1) + " ms (max " +
+          String(s.maxRttUs / 1000.0f, 1) + " ms)</div>";
+  body += "<label>Spielwerte</label><div>" + String(s.updates) + " empfangen</div>";
+  appendSyncStatus(body);
+}
+#else
+void appendSpiderStatus(String &body)
+{
+  TSWSpider::Stats s = tswSpider.getStats();
+  body += "<label>TSW Verbindungen</label><div>" + String(tswSpider.getOpenConnections()) +
+          " offen / " + String(s.connects) + " aufgebaut</div>";
+  body += "<label>TSW Requests</label><div>" + String(s.requests) + " (" + String(s.reused) +
+          " wiederverwendet, " + String(s.retries) + " Retries, " + String(s.failures) + " Fehler)</div>";
+
+  TSWCircuitBreaker::Stats b = tswSpider.getBreakerStats();
+  const char *state = b.state == TSWCircuitBreaker::CLOSED ? "geschlossen (Host erreichbar)"
+                      : b.state == TSWCircuitBreaker::OPEN ? "offen (Host nicht erreichbar)"
+                                                           : "halb offen (Testanfrage läuft)";
+  body += "<label>TSW Circuit Breaker</label><div>" + String(state) + ", Testintervall " +
+          String(b.probeIntervalMs) + " ms</div>";
+  body += "<label>Breaker Übergänge</label><div>" + String(b.opened) + "× geöffnet, " + String(b.probes) +
+          "× getestet, " + String(b.reopened) + "× Test fehlgeschlagen, " + String(b.closed) + "× geschlossen, " +
+          String(b.rejected) + " Anfragen sofort abgewiesen</div>";
+#if TSW_USE_INDEX
+  const TSWEndpointIndex::Stats &x = tswIndex.getStats();
+  body += "<label>Endpunkte</label><div>" + String(x.endpoints) + " der Lok (" +
+          String(x.cached ? "LittleFS" : "/list") + ", " + String(x.bytes) + " Bytes), " + String(x.unknown) +
+          " von " + String(x.checked) + " Controllern unbekannt, " + String(s.rejected) +
+          " Anfragen lokal abgewiesen</div>";
+#endif
+#if TSW_USE_SUBSCRIPTION
+  TSWSubscription::Stats a = tswState.getStats();
+  String values;
+  for (uint8_t i = 0; i < tswState.size(); i++)
+    values += String(tswState.getPath(i) + strlen(TSW_SUBSCRIPTION_ACTOR)) + " = " +
+             (tswState.isValid(i) ? String(tswState.get(i), 2) : String("?")) + ", ";
+  body += "<label>Spielzustand</label><div>" + values + String(a.polls) + " Abfragen (" +
+          String(a.lastPollUs / 1000.0f, 1) + " ms), " + String(a.failures) + " fehlgeschlagen, " +
+          String(a.unmatched) + " ohne passenden Pfad, " + String(s.subscribed) + " Lesezugriffe ohne eigenen Request</div>";
+#endif
+  uint32_t cached = s.cacheHits + s.cacheShared;
+  uint32_t lookups = cached + s.cacheMisses;
+  body += "<label>Lese-Cache</label><div>" + String(lookups ? 100.0f * cached / lookups : 0.0f, 0) + " % ohne Request (" +
+          String(s.cacheHits) + " Treffer, " + String(s.cacheShared) + " geteilt, " + String(s.cacheMisses) +
+          " vom Host), Alter Ø " + String(s.cacheHits ? s.cacheAgeSumMs / s.cacheHits : 0) + " ms (max " +
+          String(s.cacheAgeMaxMs) + " ms)</div>";
+  body += "<label>Abgleich</label><div>" + String(tswSpider.getDirtyCount()) + " von " +
+          String(tswSpider.getRouteCount()) + " Werten nicht übertragen, " + String(s.resyncs) +
+          "× nachgesendet (" + String(s.replayed) + " Werte)</div>";
+
+  TSWSendQueue::Stats q = tswSendQueue.getStats();
+  body += "<label>Sende-Queue</label><div>" + String(q.depth) + " wartend (max " + String(q.maxDepth) +
+          "), " + String(q.dropped) + " verworfen, " + String(q.parked) + " zurückgehalten</div>";
+  body += "<label>Zusammengefasst</label><div>" + String(q.coalesced) + " von " + String(q.enqueued) +
+          " Werten nicht gesendet</div>";
+  body += "<label>Sende-Latenz</label><div>" + String(q.avgLatencyUs / 1000.0f, 1) + " ms (max " +
+          String(q.maxLatencyUs / 1000.0f, 1) + " ms)</div>";
+  body += "<label>Senderate</label><div>Antwortzeit " + String(q.rttUs / 1000.0f, 1) + " ms, " +
+          String(q.active) + " aktiv, Mindestabstand " + String(q.intervalMs) + " ms, " + String(q.deferred) +
+          "× zurückgestellt</div>";
+  body += "<label>Vorrang-Latenz</label><div>" + String(q.highAvgLatencyUs / 1000.0f, 1) + " ms (max " +
+          String(q.highMaxLatencyUs / 1000.0f, 1) + " ms), " + String(q.highOverBudget) + " von " +
+          String(q.highSent) + " über " + String(TSW_PRIORITY_BUDGET_MS) + " ms</div>";
+  body += "<label>Stapel</label><div>" + String(q.batches) + " Makro-Stapel vorab gesendet, " +
+          String(q.superseded) + " wartende Werte ersetzt</div>";
+
+  TSWSendQueue::ControllerStats c;
+  for (uint8_t i = 0; tswSendQueue.getControllerStats(i, c); i++)
+    body += "<label>" + String(c.controller) + "</label><div>" + String(c.sent) + " gesendet, " +
+            String(c.coalesced) + " zusammengefasst, " + String(c.rateHz, 1) + " Hz (alle " +
+            String(c.intervalMs) + " ms)" + (c.priority == TSW_PRIORITY_HIGH ? ", Vorrang" : "") + "</div>";
+  appendSyncStatus(body);
+}
+#endif
+#endif
+
 void setup()
 {
+#if TSW_TRANSPORT == TSW_TRANSPORT_SERIAL
+  Serial.begin(TSW_SERIAL_BAUD);
+#else
   Serial.begin(115200);
+#endif
   delay(1000);
   Serial.setDebugOutput(false); // unterbindet Core-Debug auf UART0
 
@@ -42,29 +269,75 @@ void setup()
 
 #if USE_WIFIMANAGER
   beginWiFiManager();
+  statusPageExtension = appendSpiderStatus;
+#endif
+
+  // resolved once here; sends only ever see the plain IP address
+  String tswHost = TSW_DEFAULT_HOST;
+#if TSW_USE_DISCOVERY
+  tswHost = tswDiscovery.begin(TSW_MDNS_SERVICE, cfg.tswHost, TSW_DEFAULT_HOST, TSW_PROBE_PORT, onTswHostChanged);
+#endif
+
+#if TSW_TRANSPORT == TSW_TRANSPORT_UDP
+  tswUdp.begin(tswHost, TSW_BRIDGE_PORT);
+#elif TSW_TRANSPORT == TSW_TRANSPORT_SERIAL
+  tswSerial.begin();
+#elif TSW_TRANSPORT == TSW_TRANSPORT_WEBSOCKET
+  tswWebSocket.begin(tswHost, TSW_BRIDGE_WS_PORT);
+#else
+  tswSpider.begin(tswHost, TSW_API_PORT);
+#if USE_WIFIMANAGER
+  if (cfg.apiKey[0])
+    tswSpider.setCommKey(cfg.apiKey);
+#endif
+#if TSW_USE_SUBSCRIPTION
+  setupStateReads();
+#endif
 #endif
 
-  SETUP_ANALOG_SLIDER(&tswSpider);
-  SETUP_ROTARYBUTTON(&tswSpider);
-  SETUP_GAMEPAD(&tswSpider);
-  SETUP_MCPButtonArray(&tswSpider);
-  SETUP_BUTTONS(&tswSpider);
+  SETUP_ANALOG_SLIDER(tswTransport);
+  SETUP_ROTARYBUTTON(tswTransport);
+  SETUP_GAMEPAD(tswTransport);
+  SETUP_MCPButtonArray(tswTransport);
+  SETUP_BUTTONS(tswTransport);
 
   ControlRegistry::listAll();
 
+  // after the controls: triggers are looked up in the registry
+#if USE_MACROS && TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+  // through the queue, so no pending lever value lands after a step; the
+  // task waits for the answers instead of loop()
+  if (tswMacros.begin(&tswSendQueue))
+    tswMacros.startTask();
+#elif USE_MACROS
+  tswMacros.begin(tswTransport); // non-blocking, steps run from loop()
+#endif
+
+  // every controller is bound now, typos are caught before the first set
+#if TSW_USE_INDEX
+  tswIndex.begin(&tswSpider);
+#endif
+
+  // all initial values in one burst, afterwards the controls send deltas only
+#if TSW_TRANSPORT == TSW_TRANSPORT_HTTP
+  TSWStartupSync::run(&tswSpider); // pipelined directly, the queue task is not running yet
+  tswSendQueue.begin();
+#else
+  TSWStartupSync::run(tswTransport);
+#endif
+#if TSW_USE_DISCOVERY
+  tswDiscovery.startRevalidation();
+#endif
+
   delay(100);
 }
 
 void loopAnalogControls(unsigned long now)
 {
-  for (auto &entry : ControlRegistry::getAll())
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_ANALOG))
   {
-    if (entry.type != "AnalogSlider" && entry.id != "pad1")
-      continue;
-
+    const ControlRegistry::Entry &entry = ControlRegistry::getEntry(handle);
     Control *control = entry.instance;
-    if (!control)
-      continue;
 
     bool changed = control->update();
     if (!changed)
@@ -73,11 +346,11 @@ void loopAnalogControls(unsigned long now)
     float value = control->getValue();
 
 #if TRACE
-    if (entry.id == "pad1")
+    if (strcmp(entry.id, "pad1") == 0)
     {
 #if USE_GAMEPAD
       TRACE_PRINT("[%lu ms] %-12s %-14s => x: %d  y: %d",
-                  now, entry.type, entry.id.c_str(),
+                  now, entry.type, entry.id,
                   pad1Ptr->getXCentered(), pad1Ptr->getYCentered());
       TRACE_PRINT("   [CHANGED: %s]\n", control->getChangeReason());
       TRACE_PRINT("\n");
@@ -86,45 +359,27 @@ void loopAnalogControls(unsigned long now)
     else
     {
       TRACE_PRINT("[%lu ms] %-12s %-14s => %.2f   [CHANGED: %s]\n",
-                  now, entry.type, entry.id.c_str(), value,
+                  now, entry.type, entry.id, value,
                   control->getChangeReason());
     }
 #endif
   }
 }
 
+// the MCPButtonArray comes first in its run (registered before its buttons),
+// so the TSWMCPButtons see this pass's expander scan
 void loopButtonControls(unsigned long now)
 {
-  for (auto &entry : ControlRegistry::getAll())
-  {
-    if (entry.type != "Button" &&
-        entry.type != "MCPButton" &&
-        // entry.type != "MCPButtonArray" &&
-        entry.type != "GamepadJoystick")
-      continue;
-
-    Control *control = entry.instance;
-    if (!control)
-      continue;
-
-    bool changed = control->update();
-    if (!changed)
-      continue;
-
-    float value = control->getValue();
-  }
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_BUTTON))
+    ControlRegistry::get(handle)->update();
 }
 
 void loopRotaryControls(unsigned long now)
 {
-  for (auto &entry : ControlRegistry::getAll())
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_ROTARY))
   {
-    if (entry.type != "RotaryKnob")
-      continue;
-
+    const ControlRegistry::Entry &entry = ControlRegistry::getEntry(handle);
     Control *control = entry.instance;
-    if (!control)
-      continue;
 
     bool changed = control->update();
     if (!changed)
@@ -133,12 +388,35 @@ void loopRotaryControls(unsigned long now)
 #if TRACE
 
     TRACE_PRINT("[%lu ms] %-12s %-14s => %.2f   [CHANGED: %s]\n",
-                now, entry.type, entry.id.c_str(),
+                now, entry.type, entry.id,
                 control->getValue(), control->getChangeReason());
 #endif
   }
 }
 
+#if CONTROL_STATIC_LOOP
+#if USE_GAMEPAD
+#error "The gamepad has no control bank, set CONTROL_STATIC_LOOP 0"
+#endif
+// the stages above as one typed loop per control bank: no handle lookup and
+// no virtual call per control, only a change goes through Control
+void loopStaticControls(unsigned long now)
+{
+  auto trace = [now](Control &control, const char *type)
+  {
+    TRACE_PRINT("[%lu ms] %-12s %-14s => %.2f   [CHANGED: %s]\n",
+                now, type, control.getId().c_str(),
+                control.getValue(), control.getChangeReason());
+  };
+  (void)trace; // unused without sliders and knobs
+
+  POLL_ANALOG_SLIDER(trace);
+  POLL_MCPButtonArray();
+  POLL_BUTTONS();
+  POLL_ROTARYBUTTON(trace);
+}
+#endif
+
 void loopTraceHeartbeat(unsigned long now)
 {
 #if TRACE
@@ -147,6 +425,25 @@ void loopTraceHeartbeat(unsigned long now)
   {
     lastTrace = now;
     TRACE_PRINT("---- Trace heartbeat at %lu ms ----\n", now);
+#if TSW_TRANSPORT != TSW_TRANSPORT_HTTP
+    const TSWWireTransport::Stats &u = tswWire->getStats();
+    TRACE_PRINT("[Wire] messages: %u  acked: %u  retransmits: %u  lost: %u  stale: %u  updates: %u  rtt: %u us (max %u)\n",
+                u.messages, u.acked, u.retransmits, u.lost, u.stale, u.updates, u.avgRttUs, u.maxRttUs);
+#else
+    TSWSpider::Stats s = tswSpider.getStats();
+    TRACE_PRINT("[Spider] requests: %u  connects: %u  reused: %u  retries: %u  failures: %u  dirty: %u  resyncs: %u (%u values)\n",
+                s.requests, s.connects, s.reused, s.retries, s.failures, tswSpider.getDirtyCount(), s.resyncs, s.replayed);
+    TSWCircuitBreaker::Stats b = tswSpider.getBreakerStats();
+    TRACE_PRINT("[Breaker] %s  opened: %u  probes: %u  reopened: %u  closed: %u  rejected: %u\n",
+                TSWCircuitBreaker::stateName(b.state), b.opened, b.probes, b.reopened, b.closed, b.rejected);
+    TSWSendQueue::Stats q = tswSendQueue.getStats();
+    TRACE_PRINT("[SendQueue] depth: %u (max %u)  sent: %u  coalesced: %u  failed: %u  dropped: %u  latency: %u us (max %u)\n",
+                q.depth, q.maxDepth, q.sent, q.coalesced, q.failed, q.dropped, q.avgLatencyUs, q.maxLatencyUs);
+    TRACE_PRINT("[Rate] rtt: %u us  active: %u  interval: %u ms  deferred: %u\n",
+                q.rttUs, q.active, q.intervalMs, q.deferred);
+    TRACE_PRINT("[Priority] sent: %u  latency: %u us (max %u)  over %u ms: %u\n",
+                q.highSent, q.highAvgLatencyUs, q.highMaxLatencyUs, TSW_PRIORITY_BUDGET_MS, q.highOverBudget);
+#endif
   }
 #endif
 }
@@ -157,6 +454,9 @@ void loop()
 #if USE_WIFIMANAGER
   loopWiFiManager();
 #endif
+#if TSW_TRANSPORT != TSW_TRANSPORT_HTTP
+  tswWire->update(); // ACKs and retransmits, every pass
+#endif
 
   static unsigned long lastUpdate = 0;
   unsigned long now = millis();
@@ -164,9 +464,16 @@ void loop()
   if (now - lastUpdate < 50)
     return; // 20 Hz polling rate
 
+#if CONTROL_STATIC_LOOP
+  loopStaticControls(now);
+#else
   loopAnalogControls(now);
   loopButtonControls(now);
   loopRotaryControls(now);
+#endif
+#if USE_MACROS
+  tswMacros.update();
+#endif
   loopTraceHeartbeat(now);
   lastUpdate = now;
   delay(1);
@@ -0,0 +1,100 @@
+/**
+ * @file controlBank.h
+ * @brief Fixed-size, statically allocated array of one control type.
+ *
+ * @details
+ * Controls have no default constructor (pin, id and transport are
+ * constructor arguments), so a plain array cannot hold them. A ControlBank
+ * reserves room for N objects of exactly one type in static memory and
+ * constructs them in place with emplace(), in declaration order. Element
+ * access is typed, so calls on the elements are resolved at compile time.
+ *
+ * The setup headers declare one bank per control type, sized from the pin
+ * lists in config.h, and register every element once:
+ * @code
+ *   static ControlBank<TSWLever, 3> levers;
+ *   TSWLever *lever = levers.emplace(pin, "Throttle", transport);
+ *   ControlRegistry::registerControl(lever); // tag and kind from ControlTraits
+ * @endcode
+ *
+ * Elements are never destroyed; the bank lives as long as the firmware.
+ *
+ * poll() is the hot path of loop() (CONTROL_STATIC_LOOP): it runs update()
+ * of every element as a qualified, non-virtual call of T::update(), so each
+ * bank is one tight loop over one type that the compiler can inline. The
+ * callback sees only the elements that changed, through the Control
+ * interface; the registry keeps serving the web UI and all other cold
+ * paths.
+ * @code
+ *   levers.poll([](Control &c, const char *type) { ... }); // changed levers
+ *   buttons.poll();                                        // no callback
+ * @endcode
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <new>
+#include <utility>
+#include "controlsRepo.h"
+
+#ifndef CONTROL_STATIC_LOOP
+#define CONTROL_STATIC_LOOP 1 // loop() polls the banks, 0: the registry's kind runs
+#endif
+
+template <typename T, size_t N>
+class ControlBank
+{
+private:
+    alignas(T) uint8_t storage[N > 0 ? N : 1][sizeof(T)];
+    size_t count = 0;
+
+public:
+    typedef T value_type;
+
+    // constructs the next element; nullptr if all N are in use
+    template <typename... Args>
+    T *emplace(Args &&...args)
+    {
+        if (count >= N)
+            return nullptr;
+        return new (storage[count++]) T(std::forward<Args>(args)...);
+    }
+
+    T &operator[](size_t i) { return *reinterpret_cast<T *>(storage[i]); }
+    const T &operator[](size_t i) const { return *reinterpret_cast<const T *>(storage[i]); }
+
+    T *begin() { return reinterpret_cast<T *>(storage[0]); }
+    T *end() { return begin() + count; }
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return N; }
+    static constexpr size_t footprint() { return sizeof(ControlBank); }
+
+    // update() of every element in order, bound at compile time; returns
+    // the number of elements that reported a change
+    uint16_t poll()
+    {
+        uint16_t changed = 0;
+        for (T &c : *this)
+            changed += c.T::update();
+        return changed;
+    }
+
+    // as above, onChange(Control &, const char *type) for each change
+    template <typename OnChange>
+    uint16_t poll(OnChange &&onChange)
+    {
+        uint16_t changed = 0;
+        for (T &c : *this)
+        {
+            if (!c.T::update())
+                continue;
+            changed++;
+            onChange(static_cast<Control &>(c), ControlTraits<T>::type());
+        }
+        return changed;
+    }
+};
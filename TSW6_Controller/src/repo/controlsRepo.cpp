@@ -1,44 +1,132 @@
 #include "controlsRepo.h"
+#include "../TSW_Controls/TSWTransport.h" // tswHashName
 
-std::vector<ControlRegistry::Entry> ControlRegistry::controls;
+ControlRegistry::Entry ControlRegistry::controls[CONTROL_REGISTRY_MAX];
+uint16_t ControlRegistry::count = 0;
+uint16_t ControlRegistry::index[ControlRegistry::SLOTS];
+ControlHandle ControlRegistry::byKind[CONTROL_REGISTRY_MAX];
+uint16_t ControlRegistry::kindStart[CONTROL_KIND_COUNT + 1];
+
+// type tags as passed to registerControl() by the setup code
+static const struct
+{
+    const char *type;
+    ControlKind kind;
+} KIND_TAGS[] = {
+    {"AnalogSlider", CONTROL_KIND_ANALOG},
+    {"TSWLever", CONTROL_KIND_ANALOG},
+    {"TSWGamePadControl", CONTROL_KIND_ANALOG},
+    {"MCPButtonArray", CONTROL_KIND_BUTTON},
+    {"Button", CONTROL_KIND_BUTTON},
+    {"TSWButton", CONTROL_KIND_BUTTON},
+    {"TSWMCPButton", CONTROL_KIND_BUTTON},
+    {"GamepadJoystick", CONTROL_KIND_BUTTON},
+    {"RotaryKnob", CONTROL_KIND_ROTARY},
+    {"TSWRotaryKnob", CONTROL_KIND_ROTARY},
+    {"MCPButton", CONTROL_KIND_PASSIVE},
+};
+
+ControlKind ControlRegistry::kindOf(const char *type)
+{
+    for (auto &tag : KIND_TAGS)
+        if (strcmp(tag.type, type) == 0)
+            return tag.kind;
+    return CONTROL_KIND_PASSIVE;
+}
+
+// append at the end of its kind's run, the later runs move up by one
+void ControlRegistry::linkKind(ControlHandle handle, ControlKind kind)
+{
+    uint16_t at = kindStart[kind + 1];
+    memmove(byKind + at + 1, byKind + at, (kindStart[CONTROL_KIND_COUNT] - at) * sizeof(ControlHandle));
+    byKind[at] = handle;
+    for (uint8_t k = kind + 1; k <= CONTROL_KIND_COUNT; k++)
+        kindStart[k]++;
+}
+
+void ControlRegistry::unlinkKind(ControlHandle handle, ControlKind kind)
+{
+    uint16_t at = kindStart[kind];
+    while (byKind[at] != handle)
+        at++;
+    memmove(byKind + at, byKind + at + 1, (kindStart[CONTROL_KIND_COUNT] - at - 1) * sizeof(ControlHandle));
+    for (uint8_t k = kind + 1; k <= CONTROL_KIND_COUNT; k++)
+        kindStart[k]--;
+}
+
+// slot holding the id, or the free slot where it belongs
+uint16_t ControlRegistry::slotOf(uint32_t hash, const char *id)
+{
+    uint16_t slot = hash & (SLOTS - 1);
+    while (index[slot])
+    {
+        const Entry &e = controls[index[slot] - 1];
+        if (e.hash == hash && strcmp(e.id, id) == 0)
+            break;
+        slot = (slot + 1) & (SLOTS - 1);
+    }
+    return slot;
+}
 
 bool ControlRegistry::registerControl(Control *c, const char *type)
+{
+    return registerControl(c, type, kindOf(type));
+}
+
+bool ControlRegistry::registerControl(Control *c, const char *type, ControlKind kind)
 {
     if (!c)
         return false;
 
-    for (auto &e : controls)
+    const char *id = c->getId().c_str();
+    uint32_t hash = tswHashName(id);
+    uint16_t slot = slotOf(hash, id);
+    if (index[slot])
     {
-        if (e.id == c->getId())
+        Entry &e = controls[index[slot] - 1];
+        e.id = id; // the id string of the old instance may go with it
+        e.instance = c;
+        e.type = type;
+        if (kind != e.kind)
         {
-            e.instance = c;
-            e.type = type;
-            Serial.printf("[INFO] Updated Control: %s [%s]\n",
-                          c->getId().c_str(), type);
-            return true;
+            unlinkKind(index[slot] - 1, e.kind);
+            linkKind(index[slot] - 1, kind);
+            e.kind = kind;
         }
+        Serial.printf("[INFO] Updated Control: %s [%s]\n",
+                      id, type);
+        return true;
     }
 
-    controls.push_back({c->getId(), type, c});
+    if (count >= CONTROL_REGISTRY_MAX)
+    {
+        Serial.printf("[ERROR] Control registry full (CONTROL_REGISTRY_MAX), %s not registered\n", id);
+        return false;
+    }
+    if (kind == CONTROL_KIND_PASSIVE && strcmp(type, "MCPButton") != 0)
+        Serial.printf("[WARN] Control %s: unknown type %s, not polled\n", id, type);
+    controls[count] = {id, type, c, hash, kind};
+    index[slot] = ++count; // handle + 1
+    linkKind(count - 1, kind);
     return true;
 }
 
-Control *ControlRegistry::find(const String &id)
+ControlHandle ControlRegistry::handleOf(const String &id)
 {
-    for (auto &e : controls)
-        if (e.id == id)
-            return e.instance;
-    return nullptr;
+    uint16_t slot = slotOf(tswHashName(id.c_str()), id.c_str());
+    return index[slot] ? index[slot] - 1 : CONTROL_HANDLE_NONE;
 }
 
-const std::vector<ControlRegistry::Entry> &ControlRegistry::getAll()
+Control *ControlRegistry::find(const String &id)
 {
-    return controls;
+    return get(handleOf(id));
 }
 
 void ControlRegistry::listAll()
 {
     Serial.println("--- Registered Controls ---");
-    for (auto &e : controls)
-        Serial.printf("%s [%s]\n", e.id.c_str(), e.type.c_str());
+    for (uint16_t i = 0; i < count; i++)
+        Serial.printf("#%u %s [%s]\n", i, controls[i].id, controls[i].type);
+    Serial.printf("%u of %u entries, %u bytes static\n", count, (unsigned)CONTROL_REGISTRY_MAX,
+                  (unsigned)getFootprint());
 }
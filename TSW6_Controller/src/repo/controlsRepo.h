@@ -1,27 +1,159 @@
 #pragma once
 #include <Arduino.h>
-#include <vector>
+#include <initializer_list>
 #include <type_traits>
 #include "../controls/Control.h"
 #include "../config.h"
 
+#ifndef NUM_OF_EXPANDERS
+#define NUM_OF_EXPANDERS 0
+#endif
+#ifndef PIN_ANALOG_SLIDER
+#define PIN_ANALOG_SLIDER {}
+#endif
+#ifndef PIN_BUTTONS
+#define PIN_BUTTONS {}
+#endif
+#ifndef PIN_Rotary
+#define PIN_Rotary {}
+#endif
+#ifndef PIN_GAMEPAD
+#define PIN_GAMEPAD {}
+#endif
+#ifndef CONTROL_REGISTRY_SPARE
+#define CONTROL_REGISTRY_SPARE 8
+#endif
+
+constexpr uint16_t controlPinCount(std::initializer_list<int> pins) { return pins.size(); }
+
+// every MCP input twice (proxy + TSW button) plus the array, one entry per
+// configured pin (an upper bound for sliders, buttons, knobs and the pad)
+// and some spare; the hash index gets twice the slots
+#ifndef CONTROL_REGISTRY_MAX
+#define CONTROL_REGISTRY_MAX                                                                    \
+    (2 * NUM_OF_EXPANDERS * 16 + (NUM_OF_EXPANDERS > 0) + controlPinCount(PIN_ANALOG_SLIDER) + \
+     controlPinCount(PIN_BUTTONS) + controlPinCount(PIN_Rotary) + controlPinCount(PIN_GAMEPAD) + \
+     CONTROL_REGISTRY_SPARE)
+#endif
+
+// small integer standing for a registered id, valid until clear()
+typedef uint16_t ControlHandle;
+#define CONTROL_HANDLE_NONE 0xFFFF
+
+// loop stage a control is polled in, derived from its type tag at registration
+enum ControlKind : uint8_t
+{
+    CONTROL_KIND_ANALOG,  // AnalogSlider, TSWLever, TSWGamePadControl
+    CONTROL_KIND_BUTTON,  // MCPButtonArray (scans the expanders), Button, TSWButton, TSWMCPButton, GamepadJoystick
+    CONTROL_KIND_ROTARY,  // RotaryKnob, TSWRotaryKnob
+    CONTROL_KIND_PASSIVE, // MCPButton proxies (their array polls) and unknown types, never polled
+    CONTROL_KIND_COUNT
+};
+
+// compile-time type tag and loop stage of a control class; specialised
+// with CONTROL_TRAITS() where the class is wired up (*.setup.h)
+template <typename T>
+struct ControlTraits;
+
+#define CONTROL_TRAITS(T, KIND)                           \
+    template <>                                           \
+    struct ControlTraits<T>                               \
+    {                                                     \
+        static const char *type() { return #T; }          \
+        static constexpr ControlKind kind = KIND;         \
+    }
+
+// power of two with room for max ids at a load factor of at most 1/2
+constexpr uint16_t controlRegistrySlots(uint16_t max)
+{
+    uint16_t n = 8;
+    while (n < 2 * max)
+        n <<= 1;
+    return n;
+}
+
+/**
+ * Every id is interned on registration: its entry gets a handle (the
+ * position in the table) and a slot in an open-addressing hash index
+ * (tswHashName(), linear probing). find() and handleOf() hash the id once and
+ * compare strings only on a hash match; get() is a plain array access for
+ * callers that keep the handle.
+ *
+ * All storage is static and sized by CONTROL_REGISTRY_MAX: an entry holds
+ * pointers to the control's own id and to the type literal, nothing is
+ * copied to the heap. getFootprint() reports the bytes.
+ *
+ * The handles are also kept grouped by kind in one array, registration
+ * order within a kind: ofKind() is the contiguous run of one loop stage,
+ * so the stages never look at the type strings.
+ */
 class ControlRegistry
 {
 public:
     struct Entry
     {
-        String id;
-        String type;
+        const char *id;   // the control's own id string
+        const char *type; // tag literal passed to registerControl()
         Control *instance;
+        uint32_t hash;
+        ControlKind kind;
     };
 
+    // contiguous run of a static array, usable in a range-for
+    template <typename T>
+    struct View
+    {
+        const T *first;
+        const T *last;
+        const T *begin() const { return first; }
+        const T *end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+    typedef View<ControlHandle> KindView;
+
 private:
-    static std::vector<Entry> controls;
+    static constexpr uint16_t SLOTS = controlRegistrySlots(CONTROL_REGISTRY_MAX);
+
+    static Entry controls[CONTROL_REGISTRY_MAX];
+    static uint16_t count;
+    static uint16_t index[SLOTS]; // handle + 1, 0 = free
+    static ControlHandle byKind[CONTROL_REGISTRY_MAX];
+    static uint16_t kindStart[CONTROL_KIND_COUNT + 1]; // run of kind k: [kindStart[k], kindStart[k + 1])
+
+    static uint16_t slotOf(uint32_t hash, const char *id);
+    static void linkKind(ControlHandle handle, ControlKind kind);
+    static void unlinkKind(ControlHandle handle, ControlKind kind);
 
 public:
     static bool registerControl(Control *c, const char *type);
+    static bool registerControl(Control *c, const char *type, ControlKind kind);
+    // tag and kind of a statically typed control, no string lookup
+    template <typename T>
+    static bool registerControl(T *c)
+    {
+        return registerControl(c, ControlTraits<T>::type(), ControlTraits<T>::kind);
+    }
     static Control *find(const String &id);
-    static const std::vector<Entry> &getAll();
+    static ControlHandle handleOf(const String &id);
+    static Control *get(ControlHandle handle)
+    {
+        return handle < count ? controls[handle].instance : nullptr;
+    }
+    static const Entry &getEntry(ControlHandle handle) { return controls[handle]; }
+    static KindView ofKind(ControlKind kind)
+    {
+        return {byKind + kindStart[kind], byKind + kindStart[kind + 1]};
+    }
+    static ControlKind kindOf(const char *type);
+    static View<Entry> getAll() { return {controls, controls + count}; }
+    static uint16_t getCount() { return count; }
+    static constexpr uint16_t getCapacity() { return CONTROL_REGISTRY_MAX; }
+    // bytes of the static tables (entries, hash index, kind runs)
+    static constexpr size_t getFootprint()
+    {
+        return sizeof(Entry) * CONTROL_REGISTRY_MAX + sizeof(uint16_t) * SLOTS +
+               sizeof(ControlHandle) * CONTROL_REGISTRY_MAX + sizeof(uint16_t) * (CONTROL_KIND_COUNT + 1);
+    }
     static void listAll();
 
     // --- template convenience ---
@@ -34,5 +166,10 @@ public:
         return dynamic_cast<T *>(base);
     }
 
-    static void clear() { controls.clear(); }
+    static void clear()
+    {
+        count = 0;
+        memset(index, 0, sizeof(index));
+        memset(kindStart, 0, sizeof(kindStart));
+    }
 };
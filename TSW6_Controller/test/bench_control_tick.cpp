@@ -0,0 +1,138 @@
+/**
+ * @file bench_control_tick.cpp
+ * @brief Host bench: cost of one control tick, registry loop against the
+ *        typed control banks.
+ *
+ * @details
+ * Builds the control set of config.h as setup() does (levers and MCP
+ * buttons, against a transport that only counts) and times one tick of
+ * loop() both ways:
+ *   - registry: the CONTROL_STATIC_LOOP 0 stages of main.cpp, one virtual
+ *     update() per registered control, found through its kind run
+ *   - banks:    the CONTROL_STATIC_LOOP 1 path, POLL_* over each bank, the
+ *     update() calls bound at compile time
+ * plus the 32 TSW buttons alone, where the difference per control shows.
+ * Best of RUNS runs of TICKS ticks; the pins read idle on the host, so
+ * after the first tick (not timed) next to nothing changes and is sent,
+ * as in most ticks on the device.
+ *
+ * Sits next to bench_registry.cpp, which times the registry lookups.
+ * Build with OPT=-Os for the optimization level of the firmware.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWLever.setup.h"
+#include "TSW_Controls/TSWMCPButton.setup.h"
+#include "TSW_Controls/TSWTransport.h"
+#include <stdio.h>
+
+#define TICKS 500000
+#define RUNS 9
+
+// counts the sets, so a run that sends is visible in the output
+class CountingTransport : public TSWTransport
+{
+public:
+  uint32_t sets = 0;
+  bool setControllerValue(const String &, float) override
+  {
+    sets++;
+    return true;
+  }
+  float getControllerValue(const String &) override { return 0; }
+};
+static CountingTransport transport;
+
+// main.cpp with CONTROL_STATIC_LOOP 0: loopAnalogControls, loopButtonControls, loopRotaryControls
+__attribute__((noinline)) static uint32_t tickRegistry()
+{
+  uint32_t changed = 0;
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_ANALOG))
+  {
+    Control *control = ControlRegistry::getEntry(handle).instance;
+    if (control->update())
+    {
+      changed++;
+      (void)control->getValue();
+    }
+  }
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_BUTTON))
+    ControlRegistry::get(handle)->update();
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_ROTARY))
+    if (ControlRegistry::getEntry(handle).instance->update())
+      changed++;
+  return changed;
+}
+
+// main.cpp with CONTROL_STATIC_LOOP 1: loopStaticControls
+__attribute__((noinline)) static uint32_t tickBanks()
+{
+  uint32_t changed = 0;
+  auto onChange = [&changed](Control &control, const char *)
+  {
+    changed++;
+    (void)control.getValue();
+  };
+  POLL_ANALOG_SLIDER(onChange);
+  POLL_MCPButtonArray();
+  (void)onChange;
+  return changed;
+}
+
+#if USE_MCPBUTTONARRAY
+// the TSW buttons only: the button run minus the expander array in front
+__attribute__((noinline)) static uint32_t buttonsRegistry()
+{
+  uint32_t changed = 0;
+  for (ControlHandle handle : ControlRegistry::ofKind(CONTROL_KIND_BUTTON))
+    if (ControlRegistry::get(handle) != &mcpButtons)
+      changed += ControlRegistry::get(handle)->update();
+  return changed;
+}
+
+__attribute__((noinline)) static uint32_t buttonsBank() { return mcpTswButtons.poll(); }
+#endif
+
+template <typename F>
+static double bestNsPerTick(F tick)
+{
+  double best = 1e30;
+  for (int run = 0; run < RUNS; run++)
+  {
+    uint32_t sum = 0;
+    unsigned long start = micros();
+    for (int i = 0; i < TICKS; i++)
+      sum += tick();
+    double ns = (micros() - start) * 1000.0 / TICKS;
+    asm volatile("" ::"r"(sum));
+    if (ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+int main()
+{
+  SETUP_ANALOG_SLIDER(&transport);
+  SETUP_MCPButtonArray(&transport);
+  tickBanks(); // the first update of each control reports its start value
+  transport.sets = 0;
+
+  double registry = bestNsPerTick(tickRegistry);
+  double banks = bestNsPerTick(tickBanks);
+  printf("control tick, %u controls registered (best of %d x %d ticks):\n", (unsigned)ControlRegistry::getCount(),
+         RUNS, TICKS);
+  printf("  %-15s registry %7.1f ns   banks %7.1f ns   %.2fx\n", "whole tick", registry, banks, registry / banks);
+#if USE_MCPBUTTONARRAY
+  double buttonsR = bestNsPerTick(buttonsRegistry);
+  double buttonsB = bestNsPerTick(buttonsBank);
+  char label[24];
+  snprintf(label, sizeof(label), "%u TSW buttons", (unsigned)mcpTswButtons.size());
+  printf("  %-15s registry %7.1f ns   banks %7.1f ns   (%.2f / %.2f ns per button)\n", label, buttonsR, buttonsB, buttonsR / mcpTswButtons.size(), buttonsB / mcpTswButtons.size());
+#endif
+  printf("  values sent while timing: %u\n", transport.sets);
+  return 0;
+}
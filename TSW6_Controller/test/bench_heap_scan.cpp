@@ -0,0 +1,176 @@
+/**
+ * @file bench_heap_scan.cpp
+ * @brief Host bench: peak heap of the read scan and of the endpoint index
+ *        on large /list answers, against mock_tsw.py.
+ *
+ * @details
+ * Every malloc() and free() of the process is tracked (glibc, through
+ * __libc_malloc), so the peak covers a read, the connection and the
+ * buffers of TSWEndpointIndex alike.
+ *   - reads: 300 getControllerValue() calls answered with the JSON of the
+ *     game, uncached; peak heap per read and time per read
+ *   - /list: TSWEndpointIndex::begin() against mock_tsw.py --list-extra N
+ *     for growing N, with an empty LittleFS each time, so the list is
+ *     fetched and scanned; peak heap, time and whether the scan was cut
+ *     at TSW_INDEX_MAX(_BYTES)
+ * The run fails if a read allocates more than READ_HEAP_MAX bytes or
+ * an index build holds more than its two scan buffers plus the finished
+ * table and INDEX_HEAP_SLACK for the request, however large /list is.
+ *
+ *   ./build/bench_heap_scan [N ...]  (default 0 400 5000)
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.1
+ */
+
+#include "TSW_Controls/TSWEndpointIndex.h"
+#include "mock_tsw.h"
+#include <LittleFS.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define READ_HEAP_MAX 0     // the read path is formatted on the stack
+#define INDEX_HEAP_SLACK 2048 // request path, header lines
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+static bool tracking = false;
+static size_t live = 0, peak = 0;
+
+static void track(void *p, long sign)
+{
+  if (!tracking || !p)
+    return;
+  live += sign * (long)malloc_usable_size(p);
+  if (live > peak)
+    peak = live;
+}
+
+extern "C" void *malloc(size_t size)
+{
+  void *p = __libc_malloc(size);
+  track(p, 1);
+  return p;
+}
+
+extern "C" void free(void *p)
+{
+  track(p, -1);
+  __libc_free(p);
+}
+
+extern "C" void *realloc(void *p, size_t size)
+{
+  track(p, -1);
+  void *q = __libc_realloc(p, size);
+  track(q ? q : p, 1);
+  return q;
+}
+
+void *operator new(size_t size) { return malloc(size ? size : 1); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static void startTracking()
+{
+  live = peak = 0;
+  tracking = true;
+}
+
+static int failures = 0;
+
+static size_t listBytes(TSWSpider &spider)
+{
+  int code;
+  TSWHttpConnection *conn = spider.beginRequest("GET", TSW_INDEX_LIST_PATH, code);
+  size_t bytes = 0;
+  if (conn)
+  {
+    while (conn->read() >= 0)
+      bytes++;
+    spider.endRequest(conn);
+  }
+  return bytes;
+}
+
+static void reads()
+{
+  MockTsw mock(31394, "--delay-ms 1");
+  if (!mock.isRunning())
+    exit(1);
+  TSWSpider spider;
+  spider.begin("127.0.0.1", 31394);
+  spider.setControllerValue("Throttle", 0.75f);
+  spider.setReadTtl("Throttle", 0);
+  String throttle = "Throttle";
+  spider.getControllerValue(throttle); // connection open before tracking
+
+  const int n = 300;
+  float value = 0;
+  size_t worst = 0;
+  uint32_t start = micros();
+  for (int i = 0; i < n; i++)
+  {
+    startTracking();
+    value = spider.getControllerValue(throttle);
+    tracking = false;
+    if (peak > worst)
+      worst = peak;
+  }
+  uint32_t us = micros() - start;
+  TSWSpider::Stats s = spider.getStats();
+  printf("reads: %d x Throttle = %.3f, %lu us/read, heap peak %zu bytes per read, %u unparsed\n", n, value,
+         (unsigned long)(us / n), worst, s.unparsed);
+  if (worst > READ_HEAP_MAX || s.unparsed || value != 0.75f)
+  {
+    printf("FAIL reads: peak %zu bytes (max %u), %u unparsed\n", worst, READ_HEAP_MAX, s.unparsed);
+    failures++;
+  }
+}
+
+static void index(int extra, uint16_t port)
+{
+  char args[48];
+  snprintf(args, sizeof(args), "--delay-ms 1 --list-extra %d", extra);
+  MockTsw mock(port, args);
+  if (!mock.isRunning())
+    exit(1);
+  TSWSpider spider;
+  spider.begin("127.0.0.1", port);
+  spider.bindController("Throttle");
+  spider.setControllerValue("Throttle", 0.5f);
+  size_t body = listBytes(spider);
+  LittleFS.format(); // fetch and scan, not the cached table
+
+  TSWEndpointIndex index;
+  startTracking();
+  index.begin(&spider);
+  tracking = false;
+  TSWEndpointIndex::Stats x = index.getStats();
+  size_t bound = TSW_INDEX_MAX_BYTES + TSW_INDEX_MAX * sizeof(uint16_t) + x.bytes + INDEX_HEAP_SLACK;
+  printf("/list %7zu bytes (%5d extra): %3u endpoints%s, %4lu ms, heap peak %5zu bytes,"
+         " %5zu live after (table, file)\n",
+         body, extra, x.endpoints, x.truncated ? " (cut)" : "", (unsigned long)x.buildMs, peak, live);
+  if (peak > bound)
+  {
+    printf("FAIL /list with %d extra: peak %zu bytes, bound %zu\n", extra, peak, bound);
+    failures++;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  reads();
+  uint16_t port = 31395;
+  if (argc > 1)
+    for (int i = 1; i < argc; i++)
+      index(atoi(argv[i]), port++);
+  else
+    for (int extra : {0, 400, 5000})
+      index(extra, port++);
+  return failures ? 1 : 0;
+}
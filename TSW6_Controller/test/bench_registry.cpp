@@ -0,0 +1,167 @@
+/**
+ * @file bench_registry.cpp
+ * @brief Host bench: ControlRegistry with 1000 synthetic controls against
+ *        the linear list it replaced.
+ *
+ * @details
+ * Registers CONTROLS dummy controls ("BTN_0000" ...) in both registries and
+ * times, as the minimum of 5 runs:
+ *   - registering all of them (the old list scanned itself for duplicates)
+ *   - find() of every id, String compare per entry vs. one hash probe
+ *   - get() of an interned handle
+ * Before timing, both must return the same control for every id and
+ * nothing for an unknown one; a mismatch fails the run.
+ *
+ * The bench is built with CONTROL_REGISTRY_MAX 1024 (see the Makefile),
+ * the firmware keeps the default of config.h.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "repo/controlsRepo.h"
+#include <stdio.h>
+#include <vector>
+
+#define CONTROLS 1000
+#define RUNS 5
+
+static_assert(CONTROL_REGISTRY_MAX >= CONTROLS, "build with -DCONTROL_REGISTRY_MAX=1024");
+
+class Dummy : public Control
+{
+public:
+  explicit Dummy(const String &id) : Control(id, 0) {}
+  void begin() override {}
+  bool update() override { return false; }
+  float getValue() const override { return 0; }
+};
+
+// the registry before the hash index: a vector scanned with String compares
+class LinearRegistry
+{
+private:
+  struct Entry
+  {
+    String id;
+    String type;
+    Control *instance;
+  };
+  static std::vector<Entry> controls;
+
+public:
+  static bool registerControl(Control *c, const char *type)
+  {
+    for (auto &e : controls)
+    {
+      if (e.id == c->getId())
+      {
+        e.instance = c;
+        e.type = type;
+        return true;
+      }
+    }
+    controls.push_back({c->getId(), type, c});
+    return true;
+  }
+  static Control *find(const String &id)
+  {
+    for (auto &e : controls)
+      if (e.id == id)
+        return e.instance;
+    return nullptr;
+  }
+  static void clear() { controls.clear(); }
+};
+std::vector<LinearRegistry::Entry> LinearRegistry::controls;
+
+static std::vector<Dummy *> dummies;
+static std::vector<String> ids;
+static Control *volatile sink; // keeps the lookups from being optimized away
+
+template <typename F>
+static double minUs(F body)
+{
+  double best = 1e30;
+  for (int run = 0; run < RUNS; run++)
+  {
+    unsigned long start = micros();
+    body();
+    double us = micros() - start;
+    if (us < best)
+      best = us;
+  }
+  return best;
+}
+
+int main()
+{
+  for (int i = 0; i < CONTROLS; i++)
+  {
+    char id[16];
+    snprintf(id, sizeof(id), "BTN_%04d", i);
+    ids.push_back(String(id));
+    dummies.push_back(new Dummy(ids.back()));
+  }
+
+  double linearRegister = minUs([]
+                                {
+                                  LinearRegistry::clear();
+                                  for (Dummy *d : dummies)
+                                    LinearRegistry::registerControl(d, "MCPButton");
+                                });
+  double hashRegister = minUs([]
+                              {
+                                ControlRegistry::clear();
+                                for (Dummy *d : dummies)
+                                  ControlRegistry::registerControl(d, "MCPButton");
+                              });
+
+  int mismatches = 0;
+  for (int i = 0; i < CONTROLS; i++)
+    if (ControlRegistry::find(ids[i]) != dummies[i] || LinearRegistry::find(ids[i]) != dummies[i])
+      mismatches++;
+  if (ControlRegistry::find("BTN_unknown") || LinearRegistry::find("BTN_unknown"))
+    mismatches++;
+  if (mismatches)
+  {
+    printf("FAIL %d lookups differ\n", mismatches);
+    return 1;
+  }
+
+  const int rounds = 20;
+  double linearFind = minUs([]
+                            {
+                              for (int r = 0; r < rounds; r++)
+                                for (const String &id : ids)
+                                  sink = LinearRegistry::find(id);
+                            }) /
+                      (rounds * CONTROLS);
+  double hashFind = minUs([]
+                          {
+                            for (int r = 0; r < rounds; r++)
+                              for (const String &id : ids)
+                                sink = ControlRegistry::find(id);
+                          }) /
+                    (rounds * CONTROLS);
+
+  std::vector<ControlHandle> handles;
+  for (const String &id : ids)
+    handles.push_back(ControlRegistry::handleOf(id));
+  const int getRounds = 2000;
+  double get = minUs([&handles]
+                     {
+                       for (int r = 0; r < getRounds; r++)
+                         for (ControlHandle h : handles)
+                           sink = ControlRegistry::get(h);
+                     }) /
+               (getRounds * CONTROLS);
+
+  printf("registry, %d controls (min of %d runs):\n", CONTROLS, RUNS);
+  printf("  register all  linear %8.1f us   hash %8.1f us   %.1fx\n", linearRegister, hashRegister,
+         linearRegister / hashRegister);
+  printf("  find()        linear %8.3f us   hash %8.3f us   %.1fx\n", linearFind, hashFind, linearFind / hashFind);
+  printf("  get(handle)%24shash %8.1f ns\n", "", get * 1000);
+  return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file bench_request_builder.cpp
+ * @brief Host bench: allocation-free set builder against the String path it replaced.
+ *
+ * @details
+ * Builds one pipelined batch of TSW_PIPELINE_DEPTH sets per iteration, both
+ * ways, into a TSWHttpConnection and commits it:
+ *   - builder: TSWSpider::appendSet() with the bound route lines,
+ *     formatValue() and TSWHttpConnection::append()/commit()
+ *   - String:  "GET /set/ControllerValue/" + controller + "/" +
+ *     String(value, 3) + header block, concatenated per batch and handed
+ *     to send(), as TSWSpider did up to the request builder
+ * The connection is not open, so commit() ends at the socket and only the
+ * request assembly is timed. Heap allocations are counted through the
+ * global operator new.
+ *
+ * Before timing, both paths are written to a loopback socket once and
+ * must produce the same bytes; formatValue() is checked against
+ * String(value, 3) over a range of values. A mismatch fails the run.
+ *
+ * The host String is std::string, its allocation pattern is close to but
+ * not the same as the Arduino String; the numbers show the trend, the
+ * firmware on the ESP32 has to be timed there.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWSpider.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <new>
+#include <string>
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+  allocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static const char *const controllers[] = {
+    "Throttle", "TrainBrake", "IndependentBrake", "Reverser",
+    "DynamicBrake", "Sifa", "Horn", "EmergencyBrake"};
+static const uint8_t BATCH = TSW_PIPELINE_DEPTH < 8 ? TSW_PIPELINE_DEPTH : 8;
+
+class BenchSpider : public TSWSpider
+{
+public:
+  using TSWSpider::formatValue;
+
+  void buildBatch(TSWHttpConnection &conn, const TSWSetItem *items, uint8_t n)
+  {
+    for (uint8_t i = 0; i < n; i++)
+      appendSet(&conn, items[i]);
+    conn.commit();
+  }
+};
+
+static String headerBlock; // as TSWSpider kept it before the builder
+
+static void buildBatchString(TSWHttpConnection &conn, const TSWSetItem *items, uint8_t n)
+{
+  String batch;
+  for (uint8_t i = 0; i < n; i++)
+    batch += "GET /set/ControllerValue/" + String(items[i].controller) + "/" +
+             String(items[i].value, 3) + headerBlock;
+  conn.send(batch.c_str(), batch.length());
+}
+
+static void fillBatch(TSWSetItem *items, uint32_t round)
+{
+  for (uint8_t i = 0; i < BATCH; i++)
+    items[i] = {controllers[i], ((round * 7 + i * 13) % 2001) / 1000.0f - 1.0f, -1};
+}
+
+// --- Equivalence ---
+static bool checkFormat()
+{
+  BenchSpider spider;
+  for (int32_t milli = -100000; milli <= 100000; milli += 7)
+  {
+    float value = milli / 1000.0f;
+    char buf[16];
+    buf[BenchSpider::formatValue(buf, value)] = '\0';
+    if (String(value, 3) != buf)
+    {
+      printf("FAIL formatValue(%.6f) = %s, String() = %s\n", value, buf, String(value, 3).c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+// what the connection writes for one batch, read back from a loopback peer
+static std::string capture(int server, void (*build)(TSWHttpConnection &, const TSWSetItem *, uint8_t),
+                           const TSWSetItem *items, uint16_t port)
+{
+  TSWHttpConnection conn;
+  if (!conn.open("127.0.0.1", port, 500))
+    return "";
+  int peer = accept(server, nullptr, nullptr);
+  build(conn, items, BATCH);
+  conn.close();
+
+  std::string bytes;
+  char buf[512];
+  ssize_t n;
+  while ((n = recv(peer, buf, sizeof(buf), 0)) > 0)
+    bytes.append(buf, n);
+  close(peer);
+  return bytes;
+}
+
+static BenchSpider spider;
+
+static bool checkBytes()
+{
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (bind(server, (sockaddr *)&addr, len) < 0 || listen(server, 1) < 0 ||
+      getsockname(server, (sockaddr *)&addr, &len) < 0)
+  {
+    printf("SKIP byte check, no loopback socket\n");
+    close(server);
+    return true;
+  }
+
+  TSWSetItem items[BATCH];
+  fillBatch(items, 42);
+  std::string built = capture(server, [](TSWHttpConnection &c, const TSWSetItem *it, uint8_t n)
+                              { spider.buildBatch(c, it, n); }, items, ntohs(addr.sin_port));
+  std::string concat = capture(server, buildBatchString, items, ntohs(addr.sin_port));
+  close(server);
+
+  if (built.empty() || built != concat)
+  {
+    printf("FAIL builder and String path differ\n--- builder\n%s\n--- String\n%s\n", built.c_str(), concat.c_str());
+    return false;
+  }
+  return true;
+}
+
+// --- Timing ---
+struct Result
+{
+  double nsPerBatch;
+  double allocsPerBatch;
+};
+
+template <typename Build>
+static Result run(Build build, uint32_t rounds)
+{
+  TSWHttpConnection conn; // never opened, commit() stops at the socket
+  TSWSetItem items[BATCH];
+  double best = 1e30;
+  size_t allocs = 0;
+  for (int pass = 0; pass < 5; pass++)
+  {
+    size_t before = allocations;
+    unsigned long start = micros();
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+      fillBatch(items, r);
+      build(conn, items, BATCH);
+    }
+    double ns = (micros() - start) * 1000.0 / rounds;
+    if (ns < best)
+      best = ns;
+    allocs = allocations - before;
+  }
+  return {best, (double)allocs / rounds};
+}
+
+int main()
+{
+  spider.begin("192.168.4.2");
+  spider.setCommKey("0123456789abcdef0123456789abcdef");
+  for (const char *name : controllers)
+    spider.bindController(name);
+  headerBlock = " HTTP/1.1\r\nHost: 192.168.4.2:31270\r\nConnection: keep-alive\r\nDTGCommKey: "
+                "0123456789abcdef0123456789abcdef\r\n\r\n";
+
+  if (!checkFormat() || !checkBytes())
+    return 1;
+
+  const uint32_t rounds = 200000;
+  Result builder = run([](TSWHttpConnection &c, const TSWSetItem *it, uint8_t n)
+                       { spider.buildBatch(c, it, n); }, rounds);
+  Result concat = run(buildBatchString, rounds);
+
+  printf("request builder, batch of %u sets (min of 5 x %u):\n", BATCH, rounds);
+  printf("  builder %8.1f ns/batch %6.2f allocs/batch\n", builder.nsPerBatch, builder.allocsPerBatch);
+  printf("  String  %8.1f ns/batch %6.2f allocs/batch\n", concat.nsPerBatch, concat.allocsPerBatch);
+  printf("  speedup %.2fx\n", concat.nsPerBatch / builder.nsPerBatch);
+  return builder.allocsPerBatch == 0 ? 0 : 1;
+}
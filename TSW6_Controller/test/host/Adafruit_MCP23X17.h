@@ -0,0 +1,11 @@
+// Host stand-in for the MCP23S17 driver: every input reads high (button released).
+#pragma once
+#include <Arduino.h>
+
+class Adafruit_MCP23X17
+{
+public:
+  bool begin_SPI(uint8_t) { return true; }
+  void pinMode(uint8_t, uint8_t) {}
+  uint16_t readGPIOAB() { return 0xFFFF; }
+};
@@ -0,0 +1,334 @@
+/**
+ * @file Arduino.h
+ * @brief Host (Linux) stand-in for the part of the Arduino core the firmware uses.
+ *
+ * @details
+ * Lets the firmware sources under src/ compile with g++ on a PC for the
+ * benches and tests in test/. String is backed by std::string, so it
+ * allocates on the heap like the Arduino String does; Serial prints to
+ * stdout; time comes from std::chrono (host.cpp). Pins read as idle.
+ *
+ * Not part of the firmware build, PlatformIO never sees this directory.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+
+typedef int gpio_num_t;
+#define GPIO_NUM_NC (-1)
+#define GPIO_NUM_4 4
+#define GPIO_NUM_5 5
+#define GPIO_NUM_12 12
+#define GPIO_NUM_16 16
+#define GPIO_NUM_17 17
+#define GPIO_NUM_25 25
+#define GPIO_NUM_32 32
+#define GPIO_NUM_34 34
+#define GPIO_NUM_35 35
+
+#define F(x) x
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 3
+#define ADC_11db 3
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p) (p)
+#define bitRead(v, b) (((v) >> (b)) & 1)
+
+template <class T, class L, class H>
+T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetWidth(uint8_t) {}
+inline void analogSetPinAttenuation(uint8_t, int) {}
+inline void attachInterruptArg(uint8_t, void (*)(void *), void *, int) {}
+
+class String
+{
+private:
+  std::string s;
+
+public:
+  String(const char *c = "") : s(c ? c : "") {}
+  String(const std::string &x) : s(x) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned int v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(double v, unsigned int decimals = 2)
+  {
+    char b[64];
+    snprintf(b, sizeof(b), "%.*f", (int)decimals, v);
+    s = b;
+  }
+  String(float v, unsigned int decimals = 2) : String((double)v, decimals) {}
+
+  String &operator+=(const String &o) { s += o.s; return *this; }
+  String &operator+=(const char *o) { s += o; return *this; }
+  String &operator+=(char c) { s += c; return *this; }
+  String &operator+=(int v) { s += std::to_string(v); return *this; }
+  String &operator+=(unsigned int v) { s += std::to_string(v); return *this; }
+  String &operator+=(long v) { s += std::to_string(v); return *this; }
+  String &operator+=(unsigned long v) { s += std::to_string(v); return *this; }
+  friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+  friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+  friend String operator+(const String &a, char b) { return String(a.s + b); }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator!=(const char *o) const { return s != o; }
+  bool operator<(const String &o) const { return s < o.s; }
+  char operator[](unsigned int i) const { return s[i]; }
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  bool reserve(unsigned int n) { s.reserve(n); return true; }
+  char charAt(unsigned int i) const { return s[i]; }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  bool equals(const String &o) const { return s == o.s; }
+  bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+  bool startsWith(const String &p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+  bool endsWith(const String &p) const
+  {
+    return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+  }
+  int indexOf(char c) const
+  {
+    size_t i = s.find(c);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  int indexOf(const String &p) const
+  {
+    size_t i = s.find(p.s);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  String substring(unsigned int from) const { return String(s.substr(from)); }
+  String substring(unsigned int from, unsigned int to) const { return String(s.substr(from, to - from)); }
+  void toCharArray(char *buf, unsigned int len) const
+  {
+    if (!len)
+      return;
+    strncpy(buf, s.c_str(), len - 1);
+    buf[len - 1] = '\0';
+  }
+  void trim()
+  {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = a == std::string::npos ? "" : s.substr(a, b - a + 1);
+  }
+  void toLowerCase()
+  {
+    for (auto &c : s)
+      c = tolower(c);
+  }
+  void replace(const String &from, const String &to)
+  {
+    size_t p = 0;
+    while ((p = s.find(from.s, p)) != std::string::npos)
+    {
+      s.replace(p, from.s.size(), to.s);
+      p += to.s.size();
+    }
+  }
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t len)
+  {
+    size_t n = 0;
+    while (n < len && write(buf[n]))
+      n++;
+    return n;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *buf, size_t len) { return write((const uint8_t *)buf, len); }
+  virtual void flush() {}
+
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t print(float v, int decimals = 2) { return print(String(v, decimals)); }
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T &v) { return print(v) + println(); }
+  size_t printf(const char *fmt, ...)
+  {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return n < 0 ? 0 : write((const uint8_t *)buf, std::min<size_t>(n, sizeof(buf) - 1));
+  }
+};
+
+class Stream : public Print
+{
+private:
+  unsigned long timeoutMs = 1000;
+
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long ms) { timeoutMs = ms; }
+  int timedRead()
+  {
+    unsigned long start = millis();
+    do
+    {
+      int c = read();
+      if (c >= 0)
+        return c;
+    } while (millis() - start < timeoutMs);
+    return -1;
+  }
+  size_t readBytes(char *buf, size_t len)
+  {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = timedRead()) >= 0)
+      buf[n++] = (char)c;
+    return n;
+  }
+  size_t readBytes(uint8_t *buf, size_t len) { return readBytes((char *)buf, len); }
+  size_t readBytesUntil(char terminator, char *buf, size_t len)
+  {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = timedRead()) >= 0 && c != terminator)
+      buf[n++] = (char)c;
+    return n;
+  }
+  String readStringUntil(char terminator)
+  {
+    std::string r;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator)
+      r += (char)c;
+    return String(r);
+  }
+  bool find(const char *target) { return findUntil(target, nullptr); }
+  bool findUntil(const char *target, const char *terminator)
+  {
+    size_t n = strlen(target), m = terminator ? strlen(terminator) : 0;
+    size_t k = 0, j = 0;
+    int c;
+    while ((c = timedRead()) >= 0)
+    {
+      k = c == target[k] ? k + 1 : (c == target[0] ? 1 : 0);
+      if (k == n)
+        return true;
+      if (m == 0)
+        continue;
+      j = c == terminator[j] ? j + 1 : (c == terminator[0] ? 1 : 0);
+      if (j == m)
+        return false;
+    }
+    return false;
+  }
+};
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long, uint32_t = 0, int8_t = -1, int8_t = -1) {}
+  void end() {}
+  int available() override;
+  int read() override;
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t len) override;
+  using Print::write;
+  int availableForWrite() { return 4096; }
+  void setDebugOutput(bool) {}
+  operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class IPAddress
+{
+private:
+  uint32_t addr = 0;
+
+public:
+  IPAddress() {}
+  IPAddress(uint32_t a) : addr(a) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : addr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+  bool fromString(const char *s)
+  {
+    unsigned a, b, c, d;
+    if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+      return false;
+    *this = IPAddress(a, b, c, d);
+    return true;
+  }
+  bool fromString(const String &s) { return fromString(s.c_str()); }
+  String toString() const
+  {
+    char b[16];
+    snprintf(b, sizeof(b), "%u.%u.%u.%u", addr & 255, (addr >> 8) & 255, (addr >> 16) & 255, addr >> 24);
+    return String(b);
+  }
+  operator uint32_t() const { return addr; }
+  uint8_t operator[](int i) const { return (addr >> (8 * i)) & 255; }
+  bool operator==(const IPAddress &o) const { return addr == o.addr; }
+};
+
+class EspClass
+{
+public:
+  const char *getSdkVersion() { return "host"; }
+  void restart() { exit(0); }
+  uint32_t getFreeHeap() { return 200000; }
+  uint32_t getMinFreeHeap() { return 150000; }
+  uint32_t getMaxAllocHeap() { return 100000; }
+  uint32_t getHeapSize() { return 300000; }
+};
+extern EspClass ESP;
+inline uint32_t esp_random() { return ((uint32_t)rand() << 16) ^ (uint32_t)rand(); }
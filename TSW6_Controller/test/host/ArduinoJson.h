@@ -0,0 +1,3 @@
+// Host stand-in: NotchTable.h includes ArduinoJson, but none of the JSON
+// parsers (NotchTable, TSWSubscription, TSWMacro) is built on the host.
+#pragma once
@@ -0,0 +1,56 @@
+// Host stand-in for the Arduino FS: files live in memory for the life of
+// the process (host.cpp), enough for the index cache of TSWEndpointIndex.
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+class File : public Stream
+{
+private:
+  std::shared_ptr<std::string> data;
+  size_t pos = 0;
+
+public:
+  File() {}
+  explicit File(std::shared_ptr<std::string> contents) : data(contents) {}
+
+  operator bool() const { return data != nullptr; }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override
+  {
+    if (!data)
+      return 0;
+    data->append((const char *)buf, len);
+    return len;
+  }
+  using Print::write;
+  int available() override { return data ? (int)(data->size() - pos) : 0; }
+  int read() override { return available() > 0 ? (uint8_t)(*data)[pos++] : -1; }
+  int peek() override { return available() > 0 ? (uint8_t)(*data)[pos] : -1; }
+  size_t read(uint8_t *buf, size_t len)
+  {
+    size_t n = std::min(len, (size_t)available());
+    if (n)
+      memcpy(buf, data->data() + pos, n);
+    pos += n;
+    return n;
+  }
+  size_t size() const { return data ? data->size() : 0; }
+  void close() { data.reset(); }
+};
+
+namespace fs
+{
+  class FS
+  {
+  public:
+    bool begin(bool formatOnFail = false) { return true; }
+    bool format();
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    File open(const char *path, const char *mode = "r");
+    File open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+    bool remove(const char *path);
+  };
+}
@@ -0,0 +1,5 @@
+// Host stand-in: LittleFS is the in-memory FS of FS.h.
+#pragma once
+#include <FS.h>
+
+extern fs::FS LittleFS;
@@ -0,0 +1,3 @@
+// Host stand-in: NotchTable.h includes SD.h, no card on the host.
+#pragma once
+#include <FS.h>
@@ -0,0 +1,10 @@
+// Host stand-in: no SPI bus on a PC.
+#pragma once
+#include <Arduino.h>
+
+class SPIClass
+{
+public:
+  void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+};
+extern SPIClass SPI;
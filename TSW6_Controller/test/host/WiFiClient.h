@@ -0,0 +1,35 @@
+// Host stand-in for WiFiClient on a POSIX TCP socket (host.cpp), IPv4 literals only.
+#pragma once
+#include "Client.h"
+
+class WiFiClient : public Client
+{
+private:
+  int fd = -1;
+  int peeked = -1; // byte taken from the socket by peek()
+
+public:
+  int connect(const char *host, uint16_t port, int32_t timeoutMs);
+  int connect(const char *host, uint16_t port) override { return connect(host, port, 3000); }
+  int connect(IPAddress ip, uint16_t port) override { return connect(ip.toString().c_str(), port, 3000); }
+  int connect(IPAddress ip, uint16_t port, int32_t timeoutMs) { return connect(ip.toString().c_str(), port, timeoutMs); }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t len) override;
+  using Print::write;
+  int available() override;
+  int read() override
+  {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+  int read(uint8_t *buf, size_t len) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return fd >= 0; }
+  int setNoDelay(bool on);
+  int setTimeout(uint32_t) { return 0; }
+  IPAddress remoteIP() { return IPAddress(); }
+};
@@ -0,0 +1,4 @@
+// Host stand-in: no RTC memory on a PC, the attributes are plain statics.
+#pragma once
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,390 @@
+/**
+ * @file host.cpp
+ * @brief Host implementation of time, locking, tasks, queues, Serial,
+ *        WiFiClient, an in-memory LittleFS and the mock TSW host.
+ *
+ * @details
+ * Linked into every bench and test in test/. portENTER_CRITICAL takes one
+ * process-wide recursive mutex, which is stricter than the per-mux
+ * spinlocks of the ESP32 but keeps the same guarantees for the code under
+ * test. WiFiClient is a blocking POSIX socket with a connect timeout.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <LittleFS.h>
+#include <SPI.h>
+#include <esp_system.h>
+#include <freertos/queue.h>
+#include "mock_tsw.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+
+esp_reset_reason_t esp_reset_reason(void) { return ESP_RST_POWERON; }
+
+// --- Time ---
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void yield() { std::this_thread::yield(); }
+
+// --- Pins: buttons released, sliders at 0 ---
+int digitalRead(uint8_t) { return HIGH; }
+int analogRead(uint8_t) { return 0; }
+
+// --- FreeRTOS ---
+static std::recursive_mutex criticalSection;
+
+void portENTER_CRITICAL(portMUX_TYPE *) { criticalSection.lock(); }
+void portEXIT_CRITICAL(portMUX_TYPE *) { criticalSection.unlock(); }
+
+// a task is a detached thread plus its notification counter
+struct HostTask
+{
+  std::mutex lock;
+  std::condition_variable wake;
+  uint32_t notified = 0;
+};
+static thread_local HostTask *currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *, uint32_t, void *arg,
+                                   UBaseType_t, TaskHandle_t *handle, BaseType_t)
+{
+  HostTask *task = new HostTask();
+  std::thread([task, fn, arg]
+              {
+                currentTask = task;
+                fn(arg);
+              })
+      .detach();
+  if (handle)
+    *handle = task;
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+  HostTask *task = currentTask;
+  if (!task)
+    return 0;
+  std::unique_lock<std::mutex> guard(task->lock);
+  auto ready = [task]
+  { return task->notified > 0; };
+  if (ticks == portMAX_DELAY)
+    task->wake.wait(guard, ready);
+  else if (!task->wake.wait_for(guard, std::chrono::milliseconds(ticks), ready))
+    return 0;
+  uint32_t value = task->notified;
+  task->notified = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+  HostTask *task = static_cast<HostTask *>(handle);
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->notified++;
+  task->wake.notify_one();
+  return pdPASS;
+}
+
+// threads not started by xTaskCreatePinnedToCore() (main) have no handle
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+TickType_t xTaskGetTickCount() { return millis(); }
+
+// a queue is a bounded deque of byte strings of the item size
+struct HostQueue
+{
+  std::mutex lock;
+  std::condition_variable filled;
+  std::deque<std::string> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  HostQueue *queue = new HostQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+static BaseType_t queuePut(QueueHandle_t handle, const void *item, bool front)
+{
+  HostQueue *queue = static_cast<HostQueue *>(handle);
+  std::lock_guard<std::mutex> guard(queue->lock);
+  if (queue->items.size() >= queue->length)
+    return pdFALSE;
+  std::string bytes((const char *)item, queue->itemSize);
+  if (front)
+    queue->items.push_front(bytes);
+  else
+    queue->items.push_back(bytes);
+  queue->filled.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+  return queuePut(queue, item, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t)
+{
+  return queuePut(queue, item, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void *item, TickType_t ticks)
+{
+  HostQueue *queue = static_cast<HostQueue *>(handle);
+  std::unique_lock<std::mutex> guard(queue->lock);
+  auto ready = [queue]
+  { return !queue->items.empty(); };
+  if (ticks == portMAX_DELAY)
+    queue->filled.wait(guard, ready);
+  else if (!queue->filled.wait_for(guard, std::chrono::milliseconds(ticks), ready))
+    return pdFALSE;
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle)
+{
+  HostQueue *queue = static_cast<HostQueue *>(handle);
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->items.size();
+}
+
+// --- Serial: stdout, no input ---
+int HardwareSerial::available() { return 0; }
+int HardwareSerial::read() { return -1; }
+size_t HardwareSerial::write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) { return fwrite(buf, 1, len, stdout); }
+
+// --- WiFiClient ---
+int WiFiClient::connect(const char *host, uint16_t port, int32_t timeoutMs)
+{
+  stop();
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+    return 0;
+
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  int flags = fcntl(fd, F_GETFL);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  int r = ::connect(fd, (sockaddr *)&addr, sizeof(addr));
+  if (r < 0 && errno == EINPROGRESS)
+  {
+    pollfd p = {fd, POLLOUT, 0};
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (poll(&p, 1, timeoutMs) <= 0 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err)
+      r = -1;
+    else
+      r = 0;
+  }
+  if (r < 0)
+  {
+    stop();
+    return 0;
+  }
+  fcntl(fd, F_SETFL, flags);
+  return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t len)
+{
+  if (fd < 0)
+    return 0;
+  ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+  return n < 0 ? 0 : n;
+}
+
+int WiFiClient::available()
+{
+  if (fd < 0)
+    return 0;
+  int n = 0;
+  ioctl(fd, FIONREAD, &n);
+  return n + (peeked >= 0);
+}
+
+int WiFiClient::read(uint8_t *buf, size_t len)
+{
+  if (fd < 0 || len == 0)
+    return -1;
+  size_t n = 0;
+  if (peeked >= 0)
+  {
+    buf[n++] = peeked;
+    peeked = -1;
+  }
+  if (n < len)
+  {
+    ssize_t r = recv(fd, buf + n, len - n, MSG_DONTWAIT);
+    if (r > 0)
+      n += r;
+  }
+  return n ? (int)n : -1;
+}
+
+int WiFiClient::peek()
+{
+  uint8_t c;
+  if (peeked < 0 && fd >= 0 && recv(fd, &c, 1, MSG_DONTWAIT) == 1)
+    peeked = c;
+  return peeked;
+}
+
+void WiFiClient::stop()
+{
+  if (fd >= 0)
+    close(fd);
+  fd = -1;
+  peeked = -1;
+}
+
+uint8_t WiFiClient::connected()
+{
+  if (fd < 0)
+    return 0;
+  if (peeked >= 0)
+    return 1;
+  char c;
+  ssize_t r = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (r == 0)
+    return 0; // orderly shutdown by the peer
+  return r > 0 || errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+int WiFiClient::setNoDelay(bool on)
+{
+  int v = on;
+  return setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &v, sizeof(v));
+}
+
+// --- LittleFS: one string per path ---
+fs::FS LittleFS;
+static std::map<std::string, std::shared_ptr<std::string>> files;
+
+bool fs::FS::format()
+{
+  files.clear();
+  return true;
+}
+
+bool fs::FS::exists(const char *path) { return files.count(path) > 0; }
+
+File fs::FS::open(const char *path, const char *mode)
+{
+  if (mode[0] == 'w')
+    return File(files[path] = std::make_shared<std::string>());
+  auto it = files.find(path);
+  if (it == files.end())
+    return File();
+  if (mode[0] == 'a')
+    return File(it->second);
+  return File(std::make_shared<std::string>(*it->second)); // read: a snapshot, like an open handle
+}
+
+bool fs::FS::remove(const char *path) { return files.erase(path) > 0; }
+
+// --- Mock TSW host ---
+MockTsw::MockTsw(uint16_t port, const char *args) : port(port)
+{
+  const char *script = getenv("MOCK_TSW");
+  char command[512];
+  snprintf(command, sizeof(command), "exec python3 %s --port %u %s >/dev/null 2>&1",
+           script ? script : "../Bridge/mock_tsw.py", (unsigned)port, args);
+  pid = fork();
+  if (pid == 0)
+  {
+    execl("/bin/sh", "sh", "-c", command, (char *)nullptr);
+    _exit(127);
+  }
+
+  // wait until it listens
+  for (int i = 0; i < 100 && pid > 0; i++)
+  {
+    WiFiClient probe;
+    if (probe.connect("127.0.0.1", port, 100))
+      return;
+    if (waitpid(pid, nullptr, WNOHANG) == pid)
+      break; // exited, e.g. port in use
+    delay(50);
+  }
+  fprintf(stderr, "mock_tsw.py did not start on port %u\n", (unsigned)port);
+  pid = -1;
+}
+
+MockTsw::~MockTsw()
+{
+  if (pid <= 0)
+    return;
+  kill(pid, SIGTERM);
+  waitpid(pid, nullptr, 0);
+}
+
+long MockTsw::counter(const char *name) const
+{
+  WiFiClient client;
+  if (!client.connect("127.0.0.1", port, 1000))
+    return -1;
+  client.print("GET /stats HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n");
+  std::string body;
+  unsigned long start = millis();
+  while (millis() - start < 2000)
+  {
+    uint8_t buf[512];
+    int n = client.read(buf, sizeof(buf));
+    if (n > 0)
+      body.append((const char *)buf, n);
+    else if (!client.connected())
+      break;
+    else
+      delay(1);
+  }
+  std::string key = std::string("\"") + name + "\": ";
+  size_t at = body.find(key);
+  return at == std::string::npos ? -1 : atol(body.c_str() + at + key.size());
+}
@@ -0,0 +1,36 @@
+/**
+ * @file mock_tsw.h
+ * @brief Runs Bridge/mock_tsw.py as the TSW host of a host test.
+ *
+ * @details
+ * The constructor starts the mock on 127.0.0.1:port with the given extra
+ * arguments (e.g. "--delay-ms 4 --list-extra 2000") and waits until it
+ * accepts connections; the destructor stops it. counter() reads one of the
+ * request counters of its /stats page, so a test can tell how many
+ * requests really reached the host.
+ *
+ * The script is looked up relative to test/ (where make runs the tests),
+ * MOCK_TSW in the environment overrides the path.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#pragma once
+#include <stdint.h>
+
+class MockTsw
+{
+private:
+  int pid = -1;
+  uint16_t port;
+
+public:
+  explicit MockTsw(uint16_t port, const char *args = "");
+  ~MockTsw();
+
+  bool isRunning() const { return pid > 0; }
+  uint16_t getPort() const { return port; }
+  long counter(const char *name) const; // -1 if /stats did not answer
+};
@@ -0,0 +1,22 @@
+// NotchTable without loadFromFile(): the JSON files need ArduinoJson and a
+// card, neither exists on the host. The rest is the same as NotchTable.cpp.
+#include "TSW_Controls/NotchTable.h"
+
+bool NotchTable::loadFromFile(const String &) { return false; }
+
+bool NotchTable::loadFromArray(const std::vector<Notch> &list)
+{
+  positions = list;
+  controller = "Custom";
+  return true;
+}
+
+float NotchTable::mapToTSW(int percent) const
+{
+  for (const auto &n : positions)
+  {
+    if (percent >= n.rangeMin && percent <= n.rangeMax)
+      return n.tswValue;
+  }
+  return 0.0f;
+}
@@ -0,0 +1,6 @@
+// Spider builds without ArduinoJson: no TSWSubscription is ever attached on
+// the host, so TSWSpider never reaches read() and this stands in for the
+// real TSWSubscription.cpp.
+#include "TSW_Controls/TSWSubscription.h"
+
+bool TSWSubscription::read(const char *, float &) const { return false; }
@@ -0,0 +1,91 @@
+/**
+ * @file load_send_queue.cpp
+ * @brief Load generator for the priority lanes of TSWSendQueue.
+ *
+ * @details
+ * 24 levers stream a new value every millisecond while a Sifa button
+ * toggles every 150 ms, against mock_tsw.py answering each request after
+ * 4 ms. The run is done twice on the same load: once with every controller
+ * in the normal lane, once with the Sifa in the high lane. Reported per
+ * run are the latency of the bulk values and of the Sifa presses (from
+ * setControllerValue() to the answer of the host) and how many presses
+ * missed TSW_PRIORITY_BUDGET_MS.
+ *
+ *   ./build/load_send_queue [duration ms, default 6000]
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWSpider.h"
+#include "TSW_Controls/TSWSendQueue.h"
+#include "mock_tsw.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LEVERS 24
+#define PRESS_INTERVAL_MS 150
+#define HOST_DELAY "--delay-ms 4"
+
+static char names[LEVERS][8];
+static char report[2][256]; // printed at the end, after the trace output of both runs
+
+static void run(bool lanes, uint16_t port, uint32_t durationMs)
+{
+  MockTsw mock(port, HOST_DELAY);
+  if (!mock.isRunning())
+    exit(1);
+
+  // the queue task runs until the process ends, so neither is ever freed
+  TSWSpider *spider = new TSWSpider();
+  TSWSendQueue *queue = new TSWSendQueue(spider);
+  spider->begin("127.0.0.1", port);
+  for (int i = 0; i < LEVERS; i++)
+    queue->bindController(names[i]);
+  int sifa = queue->bindController("Sifa");
+  if (lanes)
+    queue->setPriority("Sifa", TSW_PRIORITY_HIGH);
+  queue->begin();
+
+  uint32_t start = millis();
+  uint32_t lastPress = 0;
+  int k = 0, press = 0;
+  while (millis() - start < durationMs)
+  {
+    for (int i = 0; i < LEVERS; i++)
+      queue->setControllerValue(names[i], (k++ % 1000) / 1000.0f);
+    if (millis() - lastPress >= PRESS_INTERVAL_MS)
+    {
+      queue->setControllerValue("Sifa", (press++) & 1);
+      lastPress = millis();
+    }
+    delay(1);
+  }
+  delay(500); // let the last batch come back
+
+  TSWSendQueue::Stats s = queue->getStats();
+  TSWSendQueue::ControllerStats c;
+  queue->getControllerStats(sifa, c);
+  // without lanes the Sifa is a bulk value, its latency is in the bulk figures
+  snprintf(report[lanes], sizeof(report[lanes]),
+           "%-6s bulk avg %6.1f ms max %6.1f ms | Sifa %3u/%3u sent, high lane avg %5.1f ms max %5.1f ms,"
+         " %u over %u ms | rtt %.1f ms, interval %u ms",
+         lanes ? "lanes" : "single", s.avgLatencyUs / 1000.0, s.maxLatencyUs / 1000.0, c.sent, c.updates,
+         s.highAvgLatencyUs / 1000.0, s.highMaxLatencyUs / 1000.0, s.highOverBudget,
+         TSW_PRIORITY_BUDGET_MS, s.rttUs / 1000.0, s.intervalMs);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t durationMs = argc > 1 ? atol(argv[1]) : 6000;
+  for (int i = 0; i < LEVERS; i++)
+    snprintf(names[i], sizeof(names[i]), "L%02d", i);
+
+  run(false, 31390, durationMs);
+  run(true, 31391, durationMs);
+  printf("\n%d levers every 1 ms + Sifa every %d ms, host answers after 4 ms, %lu ms per run\n",
+         LEVERS, PRESS_INTERVAL_MS, (unsigned long)durationMs);
+  printf("%s\n%s\n", report[0], report[1]);
+  return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_control_table.cpp
+ * @brief Host test of the control set built from config.h.
+ *
+ * @details
+ * Runs the setup of the levers and the MCP buttons as setup() does and
+ * checks that every configured control got its own instance in its bank
+ * and is registered under its kind: one TSWLever per PIN_ANALOG_SLIDER
+ * pin, one MCPButtonProxy and one TSWMCPButton per expander input.
+ * The setup headers once built a single lever and a single button for
+ * the whole loop, which this test catches.
+ *
+ * A control registered again under the same id replaces the entry; the
+ * entry must then point to the id of the new control, the old one may be
+ * gone.
+ *
+ * Every "trigger" in data/macros.json (MACRO_JSON) must name a control of
+ * this set, otherwise TSWMacroEngine can never start that macro.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.2
+ */
+
+#include "TSW_Controls/TSWLever.setup.h"
+#include "TSW_Controls/TSWMCPButton.setup.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef MACRO_JSON
+#define MACRO_JSON "../data/macros.json"
+#endif
+
+static int failures = 0;
+
+#define CHECK(cond, ...)          \
+  do                              \
+  {                               \
+    if (!(cond))                  \
+    {                             \
+      printf("FAIL " __VA_ARGS__); \
+      printf("\n");               \
+      failures++;                 \
+    }                             \
+  } while (0)
+
+class Dummy : public Control
+{
+public:
+  explicit Dummy(const String &id) : Control(id, 0) {}
+  void begin() override {}
+  bool update() override { return false; }
+  float getValue() const override { return 0; }
+};
+
+// "trigger": "<id>" pairs of the macro file, without a JSON parser
+static unsigned checkMacroTriggers(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  CHECK(f, "%s not readable", path);
+  if (!f)
+    return 0;
+  static char text[16384];
+  size_t len = fread(text, 1, sizeof(text) - 1, f);
+  fclose(f);
+  text[len] = 0;
+
+  unsigned n = 0;
+  for (const char *p = strstr(text, "\"trigger\""); p; p = strstr(p + 1, "\"trigger\""))
+  {
+    const char *open = strchr(p + 9, '"');
+    const char *close = open ? strchr(open + 1, '"') : nullptr;
+    if (!close)
+      break;
+    String id(open + 1);
+    id = id.substring(0, close - open - 1);
+    CHECK(ControlRegistry::find(id) != nullptr, "macro trigger %s is not a registered control", id.c_str());
+    n++;
+  }
+  CHECK(n > 0, "no triggers in %s", path);
+  return n;
+}
+
+static size_t countKind(ControlKind kind)
+{
+  size_t n = 0;
+  for (auto handle : ControlRegistry::ofKind(kind))
+  {
+    (void)handle;
+    n++;
+  }
+  return n;
+}
+
+int main()
+{
+  SETUP_ANALOG_SLIDER(nullptr);
+  SETUP_MCPButtonArray(nullptr);
+  unsigned configured = ControlRegistry::getCount();
+  size_t expected = 0;
+
+#if USE_ANALOG_SLIDER
+  CHECK(levers.size() == ANALOG_COUNT, "%zu levers for %zu pins", levers.size(), ANALOG_COUNT);
+  for (size_t i = 0; i < levers.size(); i++)
+    CHECK(ControlRegistry::find(String(ANALOG_CONTROLLERS[i]) + "_HW") == &levers[i], "lever %s not registered",
+          ANALOG_CONTROLLERS[i]);
+  CHECK(countKind(CONTROL_KIND_ANALOG) == ANALOG_COUNT, "%zu analog controls", countKind(CONTROL_KIND_ANALOG));
+  expected += ANALOG_COUNT;
+#endif
+
+#if USE_MCPBUTTONARRAY
+  CHECK(mcpTswButtons.size() == TOTAL_BUTTONS, "%zu TSW buttons for %d inputs", mcpTswButtons.size(),
+        TOTAL_BUTTONS);
+  for (size_t i = 0; i < mcpTswButtons.size(); i++)
+  {
+    char id[24];
+    snprintf(id, sizeof(id), "Button_%u", (unsigned)(i + 1));
+    CHECK(ControlRegistry::find(id) == &mcpTswButtons[i], "%s not registered", id);
+    CHECK(ControlRegistry::find(mcpButtons.getButtonId(i)) != nullptr, "proxy %s not registered",
+          mcpButtons.getButtonId(i).c_str());
+  }
+  expected += 1 + 2 * TOTAL_BUTTONS; // the array, its proxies and the TSW buttons
+#endif
+
+#if USE_MCPBUTTONARRAY
+  unsigned triggers = checkMacroTriggers(MACRO_JSON);
+  printf("test_control_table: %u macro triggers checked\n", triggers);
+#endif
+
+  Dummy *first = new Dummy("Replaced");
+  ControlRegistry::registerControl(first, "MCPButton");
+  Dummy *second = new Dummy("Replaced");
+  ControlRegistry::registerControl(second, "MCPButton");
+  delete first;
+  ControlHandle handle = ControlRegistry::handleOf("Replaced");
+  CHECK(ControlRegistry::get(handle) == second, "re-registered id not replaced");
+  CHECK(ControlRegistry::getEntry(handle).id == second->getId().c_str(), "entry keeps the id of the old control");
+  expected += 1;
+
+  CHECK(ControlRegistry::getCount() == expected, "%u registered, expected %zu",
+        (unsigned)ControlRegistry::getCount(), expected);
+  printf("test_control_table: %u controls registered from config.h, %d failures\n", configured, failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_delivery.cpp
+ * @brief Host test of the delivery handler through TSWSendQueue and TSWSpider.
+ *
+ * @details
+ * TSWStartupSync writes its RTC table from the delivery handler, so the
+ * handler must only see values the host answered. A value queued while
+ * nothing listens on the port is accepted by the queue but must never be
+ * reported; once mock_tsw.py is up, the next value is reported with the
+ * route hash of its controller.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWSpider.h"
+#include "TSW_Controls/TSWSendQueue.h"
+#include "mock_tsw.h"
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...)          \
+  do                              \
+  {                               \
+    if (!(cond))                  \
+    {                             \
+      printf("FAIL " __VA_ARGS__); \
+      printf("\n");               \
+      failures++;                 \
+    }                             \
+  } while (0)
+
+static TSWSpider spider;
+static TSWSendQueue queue(&spider);
+static std::atomic<int> reported(0);
+static std::atomic<uint32_t> lastHash(0);
+static std::atomic<float> lastValue(0.0f);
+
+static void onDelivered(uint32_t hash, float value)
+{
+  lastHash = hash;
+  lastValue = value;
+  reported++;
+}
+
+int main()
+{
+  spider.begin("127.0.0.1", 31394); // nothing listens yet
+  queue.bindController("Throttle");
+  queue.setDeliveryHandler(onDelivered);
+  queue.begin();
+
+  bool accepted = queue.setControllerValue("Throttle", 0.3f);
+  delay(TSW_CONNECT_TIMEOUT_MS + 200);
+  printf("host down: accepted %d, %d reported\n", accepted, (int)reported);
+  CHECK(accepted, "queue refused the value");
+  CHECK(reported == 0, "%d values reported without an answer", (int)reported);
+
+  MockTsw mock(31394);
+  if (!mock.isRunning())
+    return 1;
+  queue.setControllerValue("Throttle", 0.6f);
+  for (int i = 0; i < 400 && fabsf(lastValue - 0.6f) > 0.001f; i++)
+    delay(50); // the breaker lets a probe through after TSW_BREAKER_PROBE_MIN_MS and more
+  printf("host up: %d reported, last %.3f\n", (int)reported, (float)lastValue);
+  CHECK(fabsf(lastValue - 0.6f) < 0.001f, "0.6 not reported, last %.3f", (float)lastValue);
+  CHECK(lastHash == tswHashName("Throttle"), "reported hash %08x", (unsigned)lastHash);
+
+  printf("test_delivery: %d failures\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file test_read_cache.cpp
+ * @brief Host test of the read cache of TSWSpider against mock_tsw.py.
+ *
+ * @details
+ * Two threads read three controllers 300 times each, 2 ms apart:
+ *   - Throttle with the default TTL (TSW_READ_TTL_MS)
+ *   - Speed with a TTL of 20 ms set by setReadTtl()
+ *   - Sifa with a TTL of 0, i.e. never cached
+ * The test checks that the cache answers most reads, that far fewer GET
+ * requests reach the host than reads were made, that no value handed out
+ * is older than its TTL, and that the values are the ones written.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWSpider.h"
+#include "mock_tsw.h"
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#define THREADS 2
+#define ITERATIONS 300
+
+static int failures = 0;
+
+#define CHECK(cond, ...)          \
+  do                              \
+  {                               \
+    if (!(cond))                  \
+    {                             \
+      printf("FAIL " __VA_ARGS__); \
+      printf("\n");               \
+      failures++;                 \
+    }                             \
+  } while (0)
+
+static TSWSpider spider;
+
+int main()
+{
+  MockTsw mock(31392, "--delay-ms 5");
+  if (!mock.isRunning())
+    return 1;
+  spider.begin("127.0.0.1", 31392);
+  spider.setControllerValue("Throttle", 0.5f);
+  spider.setControllerValue("Speed", 12);
+  spider.setReadTtl("Speed", 20);
+  spider.setReadTtl("Sifa", 0);
+
+  long getsBefore = mock.counter("get");
+  uint32_t start = millis();
+  std::vector<std::thread> readers;
+  for (int t = 0; t < THREADS; t++)
+    readers.emplace_back([]
+                         {
+                           for (int i = 0; i < ITERATIONS; i++)
+                           {
+                             spider.getControllerValue("Throttle");
+                             spider.getControllerValue("Speed");
+                             spider.getControllerValue("Sifa");
+                             delay(2);
+                           }
+                         });
+  for (auto &reader : readers)
+    reader.join();
+  uint32_t ms = millis() - start;
+  long gets = mock.counter("get") - getsBefore;
+
+  TSWSpider::Stats s = spider.getStats();
+  uint32_t reads = THREADS * ITERATIONS * 3;
+  uint32_t cached = s.cacheHits + s.cacheShared;
+  printf("%u reads in %u ms -> %ld GETs at the host | hits %u shared %u misses %u (%.0f%% from the cache),"
+         " age avg %.1f ms max %u ms\n",
+         reads, ms, gets, s.cacheHits, s.cacheShared, s.cacheMisses,
+         100.0 * cached / (cached + s.cacheMisses), s.cacheHits ? (double)s.cacheAgeSumMs / s.cacheHits : 0.0,
+         s.cacheAgeMaxMs);
+
+  // Sifa is uncached: one GET per read; Throttle and Speed mostly from the cache
+  CHECK(gets > 0 && gets < (long)reads / 2, "%ld GETs for %u reads", gets, reads);
+  CHECK(gets >= THREADS * ITERATIONS, "Sifa (TTL 0) was cached: %ld GETs", gets);
+  CHECK(cached > 0 && cached > s.cacheMisses, "cache answered %u of %u reads", cached, cached + s.cacheMisses);
+  CHECK(s.cacheAgeMaxMs <= TSW_READ_TTL_MS, "value of %u ms handed out, TTL %u ms", s.cacheAgeMaxMs,
+        (unsigned)TSW_READ_TTL_MS);
+  CHECK(fabsf(spider.getControllerValue("Throttle") - 0.5f) < 0.001f, "Throttle read back wrong");
+  CHECK(fabsf(spider.getControllerValue("Speed") - 12.0f) < 0.001f, "Speed read back wrong");
+
+  printf("test_read_cache: %d failures\n", failures);
+  return failures ? 1 : 0;
+}
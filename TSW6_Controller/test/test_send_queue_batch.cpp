@@ -0,0 +1,80 @@
+/**
+ * @file test_send_queue_batch.cpp
+ * @brief Host test of TSWSendQueue::setControllerValues() against mock_tsw.py.
+ *
+ * @details
+ * A macro step must not be overwritten by a lever value that was queued
+ * before it. The lever sends one value, which makes its slot wait for the
+ * rate limit, then queues a second one; right after that a task runs a
+ * two-step batch on the same controller, as the macro engine does. The
+ * game must end up with the last batch value, and the batch must report
+ * both values as delivered.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWSpider.h"
+#include "TSW_Controls/TSWSendQueue.h"
+#include "mock_tsw.h"
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...)          \
+  do                              \
+  {                               \
+    if (!(cond))                  \
+    {                             \
+      printf("FAIL " __VA_ARGS__); \
+      printf("\n");               \
+      failures++;                 \
+    }                             \
+  } while (0)
+
+static TSWSpider spider;
+static TSWSendQueue queue(&spider);
+static std::atomic<int> delivered(-1);
+
+static void macroTask(void *)
+{
+  TSWSetItem steps[] = {{"Throttle", 0.75f, -1}, {"Throttle", 1.0f, -1}};
+  delivered = queue.setControllerValues(steps, 2);
+  while (true)
+    vTaskDelay(1000);
+}
+
+int main()
+{
+  MockTsw mock(31393, "--delay-ms 2");
+  if (!mock.isRunning())
+    return 1;
+  spider.begin("127.0.0.1", 31393);
+  spider.setReadTtl("Throttle", 0);
+  queue.bindController("Throttle");
+  queue.begin();
+
+  queue.setControllerValue("Throttle", 0.1f);
+  delay(10);                                  // answered, the slot now waits for its interval
+  queue.setControllerValue("Throttle", 0.2f); // pending, stale once the macro runs
+  xTaskCreatePinnedToCore(macroTask, "macro", 4096, nullptr, 1, nullptr, 0);
+
+  for (int i = 0; i < 200 && delivered < 0; i++)
+    delay(5);
+  delay(TSW_RATE_MAX_INTERVAL_MS); // the pending slot has gone out by now
+
+  TSWSendQueue::Stats s = queue.getStats();
+  float value = spider.getControllerValue("Throttle");
+  printf("batch delivered %d of 2, %u batches, %u superseded, Throttle = %.3f\n", (int)delivered, s.batches,
+         s.superseded, value);
+  CHECK(delivered == 2, "batch delivered %d of 2", (int)delivered);
+  CHECK(s.batches == 1, "%u batches", s.batches);
+  CHECK(s.superseded >= 1, "pending lever value not replaced");
+  CHECK(fabsf(value - 1.0f) < 0.001f, "Throttle = %.3f after the macro, expected 1.000", value);
+
+  printf("test_send_queue_batch: %d failures\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file test_wire.cpp
+ * @brief Host test of the wire codec in TSWWire.h against the golden vectors.
+ *
+ * @details
+ * Every vector in wire_vectors.txt is checked the way the device handles
+ * that message type:
+ *   - SET, BIND, GET, SUBSCRIBE (device -> bridge) are encoded with TSWWire
+ *     from the listed fields and must give the listed bytes
+ *   - ACK, UNKNOWN, VALUE, UPDATE (bridge -> device) are decoded from the
+ *     listed bytes and must give the listed fields
+ * For all of them slipEncode() must give the listed frame, and
+ * TSWSlipDecoder must return the message from it. Finally all frames go
+ * through one decoder back to back, followed by a corrupted frame that
+ * must be counted and dropped.
+ *
+ * test_wire.py runs the same vectors through Bridge/tsw_wire.py, so both
+ * sides agree byte for byte.
+ *
+ * @author Felix Lindemann
+ * @date 2026-10-17
+ * @version 1.0
+ */
+
+#include "TSW_Controls/TSWWire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static int failures = 0;
+
+#define CHECK(cond, ...)          \
+  do                              \
+  {                               \
+    if (!(cond))                  \
+    {                             \
+      printf("FAIL " __VA_ARGS__); \
+      printf("\n");               \
+      failures++;                 \
+    }                             \
+  } while (0)
+
+struct Vector
+{
+  std::string name, kind, args;
+  TSWWireHeader header;
+  Bytes message, frame;
+};
+
+static Bytes fromHex(const std::string &hex)
+{
+  Bytes out;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    out.push_back(strtoul(hex.substr(i, 2).c_str(), nullptr, 16));
+  return out;
+}
+
+static std::string toHex(const uint8_t *p, size_t len)
+{
+  std::string out;
+  char b[3];
+  for (size_t i = 0; i < len; i++)
+  {
+    snprintf(b, sizeof(b), "%02x", p[i]);
+    out += b;
+  }
+  return out;
+}
+
+// "a:b,c:d" -> [(a, b), (c, d)]; "-" -> []
+static std::vector<std::pair<std::string, std::string>> pairs(const std::string &args)
+{
+  std::vector<std::pair<std::string, std::string>> out;
+  if (args == "-")
+    return out;
+  std::istringstream in(args);
+  std::string item;
+  while (std::getline(in, item, ','))
+  {
+    size_t colon = item.find(':');
+    out.push_back({item.substr(0, colon), colon == std::string::npos ? "" : item.substr(colon + 1)});
+  }
+  return out;
+}
+
+static std::vector<Vector> load(const char *path)
+{
+  std::vector<Vector> vectors;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream in(line);
+    Vector v;
+    std::string session, message, frame;
+    unsigned long seq, timeUs;
+    in >> v.name >> v.kind >> session >> seq >> timeUs >> v.args >> message >> frame;
+    v.header.session = strtoul(session.c_str(), nullptr, 0);
+    v.header.seq = seq;
+    v.header.timeUs = timeUs;
+    v.message = fromHex(message);
+    v.frame = fromHex(frame);
+    vectors.push_back(v);
+  }
+  return vectors;
+}
+
+// --- device -> bridge: encode the fields ---
+static Bytes encode(Vector &v)
+{
+  uint8_t buf[TSW_WIRE_MAX_MESSAGE + 64];
+  uint16_t len = 0;
+  auto items = pairs(v.args);
+
+  if (v.kind == "set")
+  {
+    v.header.type = TSW_WIRE_SET;
+    uint8_t ids[16];
+    int32_t values[16];
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      ids[i] = atoi(items[i].first.c_str());
+      values[i] = TSWWire::quantize(atof(items[i].second.c_str()));
+    }
+    len = TSWWire::set(buf, v.header, ids, values, items.size());
+  }
+  else if (v.kind == "bind")
+  {
+    v.header.type = TSW_WIRE_BIND;
+    len = TSWWire::bind(buf, v.header, atoi(items[0].first.c_str()), items[0].second.c_str());
+  }
+  else if (v.kind == "get")
+  {
+    v.header.type = TSW_WIRE_GET;
+    len = TSWWire::get(buf, v.header, atoi(v.args.c_str()));
+  }
+  else if (v.kind == "subscribe")
+  {
+    v.header.type = TSW_WIRE_SUBSCRIBE;
+    size_t colon = v.args.find(':');
+    uint8_t ids[16];
+    uint8_t count = 0;
+    for (auto &id : pairs(v.args.substr(colon + 1)))
+      ids[count++] = atoi(id.first.c_str());
+    len = TSWWire::subscribe(buf, v.header, atoi(v.args.c_str()), ids, count);
+  }
+  return Bytes(buf, buf + len);
+}
+
+// --- bridge -> device: decode the bytes as TSWWireTransport::handle() does ---
+static void checkReply(const Vector &v)
+{
+  TSWWireHeader h;
+  int payload = TSWWire::parseHeader(v.message.data(), v.message.size(), h);
+  CHECK(payload >= 0, "%s: header rejected", v.name.c_str());
+  if (payload < 0)
+    return;
+  CHECK(h.session == v.header.session && h.seq == v.header.seq && h.timeUs == v.header.timeUs,
+        "%s: header fields", v.name.c_str());
+  const uint8_t *p = v.message.data() + TSW_WIRE_HEADER_LEN;
+  auto items = pairs(v.args);
+
+  if (v.kind == "ack")
+  {
+    unsigned accepted, stale, failed;
+    sscanf(v.args.c_str(), "%u,%u,%u", &accepted, &stale, &failed);
+    CHECK(h.type == TSW_WIRE_ACK && payload == 3, "%s: type/length", v.name.c_str());
+    CHECK(p[0] == accepted && p[1] == stale && p[2] == failed, "%s: counters", v.name.c_str());
+  }
+  else if (v.kind == "unknown")
+  {
+    CHECK(h.type == TSW_WIRE_UNKNOWN && payload == 1, "%s: type/length", v.name.c_str());
+    CHECK(p[0] == atoi(v.args.c_str()), "%s: id", v.name.c_str());
+  }
+  else if (v.kind == "value")
+  {
+    CHECK(h.type == TSW_WIRE_VALUE && payload == 5, "%s: type/length", v.name.c_str());
+    CHECK(p[0] == atoi(items[0].first.c_str()), "%s: id", v.name.c_str());
+    CHECK((int32_t)TSWWire::get32(p + 1) == TSWWire::quantize(atof(items[0].second.c_str())),
+          "%s: value", v.name.c_str());
+  }
+  else if (v.kind == "update")
+  {
+    CHECK(h.type == TSW_WIRE_UPDATE && payload == 1 + (int)items.size() * TSW_WIRE_ITEM_LEN,
+          "%s: type/length", v.name.c_str());
+    CHECK(p[0] == items.size(), "%s: count", v.name.c_str());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      const uint8_t *item = p + 1 + i * TSW_WIRE_ITEM_LEN;
+      CHECK(item[0] == atoi(items[i].first.c_str()), "%s: id %zu", v.name.c_str(), i);
+      CHECK((int32_t)TSWWire::get32(item + 1) == TSWWire::quantize(atof(items[i].second.c_str())),
+            "%s: value %zu", v.name.c_str(), i);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<Vector> vectors = load(argc > 1 ? argv[1] : "wire_vectors.txt");
+  if (vectors.empty())
+  {
+    printf("FAIL no vectors loaded\n");
+    return 1;
+  }
+
+  std::string stream;
+  TSWSlipDecoder<TSW_WIRE_MAX_MESSAGE + 16> decoder;
+  for (Vector &v : vectors)
+  {
+    bool outgoing = v.kind == "set" || v.kind == "bind" || v.kind == "get" || v.kind == "subscribe";
+    if (outgoing)
+    {
+      Bytes built = encode(v);
+      CHECK(built == v.message, "%s: encoded %s", v.name.c_str(), toHex(built.data(), built.size()).c_str());
+    }
+    else
+    {
+      checkReply(v);
+    }
+
+    uint8_t frame[TSW_SLIP_FRAME_LEN(TSW_WIRE_MAX_MESSAGE + 16)];
+    uint16_t len = TSWWire::slipEncode(frame, v.message.data(), v.message.size());
+    CHECK(Bytes(frame, frame + len) == v.frame, "%s: frame %s", v.name.c_str(), toHex(frame, len).c_str());
+
+    uint16_t got = 0;
+    for (uint8_t c : v.frame)
+      if (uint16_t n = decoder.feed(c))
+        got = n;
+    CHECK(got == v.message.size() && Bytes(decoder.buf, decoder.buf + got) == v.message,
+          "%s: decoded frame", v.name.c_str());
+
+    stream.append(v.frame.begin(), v.frame.end());
+  }
+
+  // one stream as the device reads it from the bridge, plus a frame with a flipped bit
+  Bytes bad = vectors[0].frame;
+  bad[3] ^= 0x01;
+  stream.append(bad.begin(), bad.end());
+
+  TSWSlipDecoder<TSW_WIRE_MAX_MESSAGE + 16> uart;
+  size_t next = 0;
+  for (char c : stream)
+  {
+    uint16_t n = uart.feed((uint8_t)c);
+    if (!n)
+      continue;
+    CHECK(next < vectors.size() && Bytes(uart.buf, uart.buf + n) == vectors[next].message,
+          "stream: message %zu", next);
+    next++;
+  }
+  CHECK(next == vectors.size(), "stream: %zu of %zu messages", next, vectors.size());
+  CHECK(uart.badFrames == 1, "stream: %u bad frames, expected 1", (unsigned)uart.badFrames);
+
+  printf("test_wire: %zu vectors, %d failures\n", vectors.size(), failures);
+  return failures ? 1 : 0;
+}
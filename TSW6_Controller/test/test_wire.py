@@ -0,0 +1,139 @@
+# test_wire.py
+# -------------------------------------------------------------
+#   Host test of Bridge/tsw_wire.py against the golden vectors
+#   in wire_vectors.txt, the bridge half of test_wire.cpp.
+#
+#   Every message is encoded from its fields with the encoder
+#   the bridge has for it, decoded back, SLIP framed and
+#   unframed; all frames then go through one SlipDecoder with
+#   log text and a corrupted frame in between, as the bridge
+#   reads them from the UART of the controller.
+#
+#   python3 test/test_wire.py [wire_vectors.txt]
+# -------------------------------------------------------------
+
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "Bridge"))
+
+import tsw_wire as wire  # noqa: E402
+
+failures = 0
+
+
+def check(cond, what):
+    global failures
+    if not cond:
+        print("FAIL", what)
+        failures += 1
+
+
+def pairs(args):
+    """'a:b,c:d' -> [('a', 'b'), ('c', 'd')]; '-' -> []"""
+    if args == "-":
+        return []
+    return [tuple(item.split(":", 1)) for item in args.split(",")]
+
+
+def load(path):
+    vectors = []
+    with open(path) as f:
+        for line in f:
+            if not line.strip() or line.startswith("#"):
+                continue
+            name, kind, session, seq, time_us, args, message, frame = line.split()
+            vectors.append(dict(name=name, kind=kind, session=int(session, 0), seq=int(seq),
+                                time_us=int(time_us), args=args,
+                                message=bytes.fromhex(message), frame=bytes.fromhex(frame)))
+    return vectors
+
+
+def encode(v):
+    s, q, t, args = v["session"], v["seq"], v["time_us"], v["args"]
+    request = wire.Message(0, s, q, t)
+    kind = v["kind"]
+    if kind in ("set", "update"):
+        items = [(int(i), float(x)) for i, x in pairs(args)]
+        return (wire.encode_set if kind == "set" else wire.encode_update)(s, q, t, items)
+    if kind == "bind":
+        id, name = pairs(args)[0]
+        return wire.encode_bind(s, q, t, int(id), name)
+    if kind == "get":
+        return wire.encode_get(s, q, t, int(args))
+    if kind == "subscribe":
+        interval, ids = args.split(":", 1)
+        return wire.encode_subscribe(s, q, t, int(interval), [int(i) for i in ids.split(",")])
+    if kind == "ack":
+        return wire.encode_ack(request, *[int(n) for n in args.split(",")])
+    if kind == "unknown":
+        return wire.encode_unknown(request, int(args))
+    if kind == "value":
+        id, value = pairs(args)[0]
+        return wire.encode_value(request, int(id), float(value))
+    raise ValueError(kind)
+
+
+def check_decode(v):
+    name, args = v["name"], v["args"]
+    msg = wire.decode(v["message"])
+    check(msg is not None, f"{name}: decode")
+    if msg is None:
+        return
+    check((msg.session, msg.seq, msg.time_us) == (v["session"], v["seq"], v["time_us"]),
+          f"{name}: header fields")
+    kind = v["kind"]
+    if kind in ("set", "update"):
+        decoded = (wire.decode_set if kind == "set" else wire.decode_update)(msg.payload)
+        expected = [(int(i), wire.dequantize(wire.quantize(float(x)))) for i, x in pairs(args)]
+        check(decoded == expected, f"{name}: items {decoded}")
+    elif kind == "bind":
+        id, bound = pairs(args)[0]
+        check(wire.decode_bind(msg.payload) == (int(id), bound[:47]), f"{name}: bind")
+    elif kind == "subscribe":
+        interval, ids = args.split(":", 1)
+        check(wire.decode_subscribe(msg.payload) == (int(interval), [int(i) for i in ids.split(",")]),
+              f"{name}: subscribe")
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else os.path.join(HERE, "wire_vectors.txt")
+    vectors = load(path)
+    if not vectors:
+        print("FAIL no vectors loaded")
+        return 1
+
+    stream = b""
+    for v in vectors:
+        name = v["name"]
+        built = encode(v)
+        check(built == v["message"], f"{name}: encoded {built.hex()}")
+        check_decode(v)
+
+        frame = wire.slip_encode(v["message"])
+        check(frame == v["frame"], f"{name}: frame {frame.hex()}")
+        got = [m for ok, m in wire.SlipDecoder().feed(v["frame"]) if ok]
+        check(got == [v["message"]], f"{name}: decoded frame")
+
+        stream += b"[Wire] log line between frames\r\n" + v["frame"]
+
+    # one stream as the bridge reads it from the UART, plus a frame with a flipped bit
+    bad = bytearray(vectors[0]["frame"])
+    bad[3] ^= 0x01
+    stream += bytes(bad)
+
+    decoder = wire.SlipDecoder()
+    out = decoder.feed(stream)
+    messages = [m for ok, m in out if ok]
+    text = b"".join(m for ok, m in out if not ok and m.isascii())
+    check(messages == [v["message"] for v in vectors], f"stream: {len(messages)} of {len(vectors)} messages")
+    check(text.count(b"[Wire] log line") == len(vectors), "stream: log text")
+    check(decoder.bad_frames == 1, f"stream: {decoder.bad_frames} bad frames, expected 1")
+
+    print(f"test_wire.py: {len(vectors)} vectors, {failures} failures")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())